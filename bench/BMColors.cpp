@@ -0,0 +1,68 @@
+#include <mln/colors/convert.hpp>
+#include <mln/core/algorithm/transform.hpp>
+#include <mln/core/colors.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/io/imread.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+class BMColors : public benchmark::Fixture
+{
+public:
+  BMColors()
+  {
+    if (!g_loaded)
+    {
+      mln::io::imread("Space1_20MB.jpg", g_input);
+      g_loaded = true;
+    }
+  }
+
+  void run(benchmark::State& st, std::function<void()> callback)
+  {
+    for (auto _ : st)
+      callback();
+    st.SetItemsProcessed(int64_t(st.iterations()) * int64_t(g_input.width()) * int64_t(g_input.height()));
+  }
+
+protected:
+  static bool                    g_loaded;
+  static mln::image2d<mln::rgb8> g_input;
+};
+
+bool                    BMColors::g_loaded = false;
+mln::image2d<mln::rgb8> BMColors::g_input;
+
+
+BENCHMARK_F(BMColors, rgb2lab_pixelwise)(benchmark::State& st)
+{
+  this->run(st, []() { mln::transform(g_input, [](mln::rgb8 v) { return mln::rgb2lab(v); }); });
+}
+
+BENCHMARK_F(BMColors, rgb2lab)(benchmark::State& st)
+{
+  this->run(st, []() { mln::colors::convert(g_input, mln::lab_tag{}); });
+}
+
+BENCHMARK_F(BMColors, rgb2lab_parallel)(benchmark::State& st)
+{
+  this->run(st, []() { mln::colors::parallel::convert(g_input, mln::lab_tag{}); });
+}
+
+BENCHMARK_F(BMColors, rgb2ycbcr_pixelwise)(benchmark::State& st)
+{
+  this->run(st, []() { mln::transform(g_input, [](mln::rgb8 v) { return mln::rgb2ycbcr(v); }); });
+}
+
+BENCHMARK_F(BMColors, rgb2ycbcr)(benchmark::State& st)
+{
+  this->run(st, []() { mln::colors::convert(g_input, mln::ycbcr_tag{}); });
+}
+
+BENCHMARK_F(BMColors, rgb2ycbcr_parallel)(benchmark::State& st)
+{
+  this->run(st, []() { mln::colors::parallel::convert(g_input, mln::ycbcr_tag{}); });
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+#include <mln/core/algorithm/transform.hpp>
+#include <mln/core/colors.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/filters/nms.hpp>
+#include <mln/io/imread.hpp>
+#include <mln/transforms/hough_lines.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <numbers>
+#include <vector>
+
+
+class BMHoughLines : public benchmark::Fixture
+{
+public:
+  BMHoughLines()
+  {
+    if (!g_loaded)
+    {
+      mln::image2d<mln::rgb8> input;
+      mln::io::imread("Aerial_view_of_Olbia.jpg", input);
+
+      // A sparse edge-like binary image
+      g_input  = mln::transform(input, [](mln::rgb8 x) -> bool { return x[0] > 200; });
+      g_winput = mln::transform(input, [](mln::rgb8 x) -> float { return x[0] > 200 ? x[0] / 255.f : 0.f; });
+      g_loaded = true;
+    }
+
+    m_angles.resize(180);
+    for (int i = 0; i < 180; ++i)
+      m_angles[i] = (i - 90) * std::numbers::pi_v<float> / 180;
+  }
+
+  void run(benchmark::State& st, std::function<void()> callback)
+  {
+    for (auto _ : st)
+      callback();
+    st.SetItemsProcessed(int64_t(st.iterations()) * int64_t(g_input.width()) * int64_t(g_input.height()));
+  }
+
+protected:
+  static bool                g_loaded;
+  static mln::image2d<bool>  g_input;
+  static mln::image2d<float> g_winput;
+  std::vector<float>         m_angles;
+};
+
+bool                BMHoughLines::g_loaded = false;
+mln::image2d<bool>  BMHoughLines::g_input;
+mln::image2d<float> BMHoughLines::g_winput;
+
+
+BENCHMARK_F(BMHoughLines, hough_lines)(benchmark::State& st)
+{
+  this->run(st, [this]() { mln::transforms::hough_lines(g_input, m_angles); });
+}
+
+BENCHMARK_F(BMHoughLines, hough_lines_parallel)(benchmark::State& st)
+{
+  this->run(st, [this]() { mln::transforms::parallel::hough_lines(g_input, m_angles); });
+}
+
+BENCHMARK_F(BMHoughLines, hough_lines_parallel_16bit)(benchmark::State& st)
+{
+  this->run(st, [this]() { mln::transforms::parallel::hough_lines(g_input, m_angles, nullptr, true); });
+}
+
+BENCHMARK_F(BMHoughLines, hough_lines_weighted)(benchmark::State& st)
+{
+  this->run(st, [this]() { mln::transforms::hough_lines(g_winput, m_angles); });
+}
+
+BENCHMARK_F(BMHoughLines, hough_lines_weighted_parallel)(benchmark::State& st)
+{
+  this->run(st, [this]() { mln::transforms::parallel::hough_lines(g_winput, m_angles); });
+}
+
+BENCHMARK_F(BMHoughLines, hough_lines_detect_peaks)(benchmark::State& st)
+{
+  auto acc = mln::transforms::parallel::hough_lines(g_input, m_angles);
+  this->run(st, [this, &acc]() { mln::transforms::hough_lines_detect_peaks(acc, m_angles); });
+}
+
+BENCHMARK_F(BMHoughLines, nms)(benchmark::State& st)
+{
+  auto acc = mln::transforms::parallel::hough_lines(g_input, m_angles);
+  this->run(st, [&acc]() { mln::filters::nms(acc, 5, 5, std::nullopt, 10); });
+}
+
+BENCHMARK_F(BMHoughLines, nms_parallel)(benchmark::State& st)
+{
+  auto acc = mln::transforms::parallel::hough_lines(g_input, m_angles);
+  this->run(st, [&acc]() { mln::filters::parallel::nms(acc, 5, 5, std::nullopt, 10); });
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+#include <mln/contrib/meanshift/meanshift.hpp>
+#include <mln/core/colors.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/range/foreach.hpp>
+#include <mln/io/imread.hpp>
+
+#include <benchmark/benchmark.h>
+
+
+class BMMeanshift : public benchmark::Fixture
+{
+public:
+  BMMeanshift()
+  {
+    if (!g_loaded)
+    {
+      mln::image2d<mln::rgb8> input;
+      mln::io::imread("Aerial_view_of_Olbia.jpg", input);
+
+      // A 10 Mpx image made of copies of the input
+      const int w = input.width(), h = input.height();
+      g_input.resize(3872, 2592);
+      mln_foreach (auto px, g_input.pixels())
+        px.val() = input({px.point().x() % w, px.point().y() % h});
+      g_loaded = true;
+    }
+  }
+
+  void run(benchmark::State& st, std::function<void()> callback)
+  {
+    for (auto _ : st)
+      callback();
+    st.SetItemsProcessed(int64_t(st.iterations()) * int64_t(g_input.width()) * int64_t(g_input.height()));
+  }
+
+protected:
+  static constexpr float          kHs = 5;
+  static constexpr float          kHr = 15;
+  static bool                     g_loaded;
+  static mln::image2d<mln::rgb8>  g_input;
+};
+
+bool                    BMMeanshift::g_loaded = false;
+mln::image2d<mln::rgb8> BMMeanshift::g_input;
+
+
+BENCHMARK_DEFINE_F(BMMeanshift, meanshift)(benchmark::State& st)
+{
+  mln::contrib::meanshift_params params = {.radius = static_cast<int>(st.range(0)), .max_iterations = 10};
+  this->run(st, [&]() { mln::contrib::meanshift(g_input, kHs, kHr, params); });
+}
+
+BENCHMARK_DEFINE_F(BMMeanshift, meanshift_parallel)(benchmark::State& st)
+{
+  mln::contrib::meanshift_params params = {.radius = static_cast<int>(st.range(0)), .max_iterations = 10};
+  this->run(st, [&]() { mln::contrib::parallel::meanshift(g_input, kHs, kHr, params); });
+}
+
+BENCHMARK_REGISTER_F(BMMeanshift, meanshift)->Arg(3)->Arg(5)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK_REGISTER_F(BMMeanshift, meanshift_parallel)->Arg(3)->Arg(5)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+BENCHMARK_MAIN();
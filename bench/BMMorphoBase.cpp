@@ -18,8 +18,10 @@
 #include <mln/morpho/reconstruction.hpp>
 #include <mln/morpho/watershed.hpp>
 
+#include <mln/labeling/blobs.hpp>
 #include <mln/labeling/local_extrema.hpp>
 #include <mln/labeling/chamfer_distance_transform.hpp>
+#include <mln/labeling/euclidean_distance_transform.hpp>
 
 #include <benchmark/benchmark.h>
 
@@ -260,6 +262,119 @@ BENCHMARK_F(BMMorpho, cdt_2_3)(benchmark::State& st)
   this->run(st, f);
 }
 
+BENCHMARK_F(BMMorpho, cdt_2_3_parallel)(benchmark::State& st)
+{
+  auto f = [](const image_t& input, image_t&) {
+    auto tmp = mln::transform(input, [](uint8_t x) { return x < 128; });
+    auto out = mln::labeling::parallel::chamfer_distance_transform<int16_t>(tmp, mln::c8);
+    return out;
+  };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, cdt_5_7_11)(benchmark::State& st)
+{
+  mln::se::wmask2d weights = {{+0, 11, +0, 11, +0}, //
+                              {11, +7, +5, +7, 11},
+                              {+0, +5, +0, +5, +0},
+                              {11, +7, +5, +7, 11},
+                              {+0, 11, +0, 11, +0}};
+
+  auto f = [weights](const image_t& input, image_t&) {
+    auto tmp = mln::transform(input, [](uint8_t x) { return x < 128; });
+    auto out = mln::labeling::chamfer_distance_transform<int16_t>(tmp, weights);
+    return out;
+  };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, cdt_5_7_11_parallel)(benchmark::State& st)
+{
+  mln::se::wmask2d weights = {{+0, 11, +0, 11, +0}, //
+                              {11, +7, +5, +7, 11},
+                              {+0, +5, +0, +5, +0},
+                              {11, +7, +5, +7, 11},
+                              {+0, 11, +0, 11, +0}};
+
+  auto f = [weights](const image_t& input, image_t&) {
+    auto tmp = mln::transform(input, [](uint8_t x) { return x < 128; });
+    auto out = mln::labeling::parallel::chamfer_distance_transform<int16_t>(tmp, weights);
+    return out;
+  };
+  this->run(st, f);
+}
+
+
+BENCHMARK_F(BMMorpho, edt)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) { return mln::labeling::squared_euclidean_distance_transform(bin); };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, edt_parallel)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) {
+    return mln::labeling::parallel::squared_euclidean_distance_transform(bin);
+  };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, eft_parallel)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) { return mln::labeling::parallel::euclidean_feature_transform(bin); };
+  this->run(st, f);
+}
+
+
+// Reference implementation (queue-based propagation)
+BENCHMARK_F(BMMorpho, blobs_queue)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) {
+    mln::image2d<bool>    tmp = bin;
+    mln::image2d<int32_t> out = mln::imchvalue<int32_t>(tmp).adjust(mln::c8).set_init_value(0);
+    return mln::labeling::impl::blobs_no_boundcheck(tmp, mln::c8, out);
+  };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, blobs_runs)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) {
+    int nlabel;
+    mln::labeling::blobs<int32_t>(bin, mln::c8, nlabel);
+    return nlabel;
+  };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, blobs_runs_attributes)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) {
+    int                                          nlabel;
+    std::vector<mln::labeling::blob_attributes> attributes;
+    mln::labeling::blobs<int32_t>(bin, mln::c8, nlabel, attributes);
+    return nlabel;
+  };
+  this->run(st, f);
+}
+
+BENCHMARK_F(BMMorpho, blobs_runs_parallel)(benchmark::State& st)
+{
+  auto bin = mln::transform(m_input, [](uint8_t x) -> bool { return x < 128; });
+  auto f   = [bin](const image_t&, image_t&) {
+    int nlabel;
+    mln::labeling::parallel::blobs<int32_t>(bin, mln::c8, nlabel);
+    return nlabel;
+  };
+  this->run(st, f);
+}
+
 
 BENCHMARK_F(BMMorpho, watershed)(benchmark::State& st)
 {
@@ -1,8 +1,10 @@
 #include <mln/core/algorithm/transform.hpp>
 #include <mln/core/colors.hpp>
+#include <mln/core/image/image_allocator.hpp>
 #include <mln/core/image/ndimage.hpp>
 
 #include <mln/core/neighborhood/c4.hpp>
+#include <mln/core/range/foreach.hpp>
 #include <mln/io/imread.hpp>
 #include <mln/morpho/tos.hpp>
 
@@ -10,6 +12,10 @@
 
 #include <fixtures/ImagePath/image_path.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
 class BMMorpho : public benchmark::Fixture
 {
 public:
@@ -54,10 +60,102 @@ mln::image2d<uint8_t> BMMorpho::g_input;
 
 
 
+namespace
+{
+  // Image allocator that records the peak of the bytes held by the image buffers
+  class peak_image_allocator final : public mln::image_allocator
+  {
+  public:
+    void* allocate(std::size_t n) final
+    {
+      std::scoped_lock lock(m_mutex);
+      void*            p = m_default.allocate(n);
+      m_current += n;
+      m_peak = std::max(m_peak, m_current);
+      return p;
+    }
+
+    void deallocate(void* p, std::size_t n) noexcept final
+    {
+      std::scoped_lock lock(m_mutex);
+      m_default.deallocate(p, n);
+      m_current -= n;
+    }
+
+    std::size_t peak() const
+    {
+      std::scoped_lock lock(m_mutex);
+      return m_peak;
+    }
+
+  private:
+    mutable std::mutex            m_mutex;
+    mln::default_image_allocator m_default;
+    std::size_t                   m_current = 0;
+    std::size_t                   m_peak    = 0;
+  };
+
+  // Peak of the image memory (in MB) allocated by a single call (the input image is allocated beforehand)
+  template <class F>
+  double peak_image_mb(F f)
+  {
+    auto alloc = std::make_shared<peak_image_allocator>();
+    {
+      mln::scoped_image_allocator guard(alloc);
+      f();
+    }
+    return alloc->peak() / (1024. * 1024.);
+  }
+} // namespace
+
+BENCHMARK_F(BMMorpho, ToSNodeMapOriginalSize)(benchmark::State& st)
+{
+  auto f = [](const image_t& input) {
+    mln::morpho::tos(input, input.domain().tl(), mln::morpho::ToS_NodeMapOriginalSize);
+  };
+  this->run(st, f);
+  st.counters["PeakImage_MB"] = peak_image_mb([&] { f(m_input); });
+}
+
 BENCHMARK_F(BMMorpho, ToSNew)(benchmark::State& st)
 {
   auto f = [](const image_t& input) { mln::morpho::tos(input, input.domain().tl()); };
   this->run(st, f);
+  st.counters["PeakImage_MB"] = peak_image_mb([&] { f(m_input); });
+}
+
+namespace
+{
+  // A floating point version of the input with many distinct values (a smooth ramp is added)
+  mln::image2d<float> make_float_input(const mln::image2d<uint8_t>& input)
+  {
+    mln::image2d<float> out = mln::transform(input, [](uint8_t x) -> float { return x; });
+    mln_foreach (auto px, out.pixels())
+      px.val() += 1e-3f * ((px.point().x() * 7 + px.point().y() * 13) % 997);
+    return out;
+  }
+
+  // The same image quantized on 16 bits
+  mln::image2d<uint16_t> quantize(const mln::image2d<float>& input)
+  {
+    return mln::transform(input, [](float x) -> uint16_t { return static_cast<uint16_t>(x * 256.f); });
+  }
+} // namespace
+
+BENCHMARK_F(BMMorpho, ToSFloat)(benchmark::State& st)
+{
+  auto g = make_float_input(m_input);
+  for (auto _ : st)
+    mln::morpho::tos(g, g.domain().tl());
+  st.SetBytesProcessed(int64_t(st.iterations()) * int64_t(m_size));
+}
+
+BENCHMARK_F(BMMorpho, ToSQuantized16)(benchmark::State& st)
+{
+  auto g = quantize(make_float_input(m_input));
+  for (auto _ : st)
+    mln::morpho::tos(g, g.domain().tl());
+  st.SetBytesProcessed(int64_t(st.iterations()) * int64_t(m_size));
 }
 
 BENCHMARK_MAIN();
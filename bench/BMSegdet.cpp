@@ -0,0 +1,91 @@
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/range/foreach.hpp>
+#include <scribo/segdet.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+
+class BMSegdet : public benchmark::Fixture
+{
+public:
+  BMSegdet()
+  {
+    if (g_pages.empty())
+    {
+      for (unsigned seed = 0; seed < kPageCount; ++seed)
+        g_pages.push_back(make_page(seed));
+    }
+  }
+
+  void run(benchmark::State& st, std::function<void(const mln::image2d<std::uint8_t>&)> callback)
+  {
+    for (auto _ : st)
+      for (const auto& page : g_pages)
+        callback(page);
+    st.SetItemsProcessed(int64_t(st.iterations()) * kPageCount * kWidth * kHeight);
+  }
+
+protected:
+  static constexpr int      kWidth     = 1240; // A4 at 150 dpi
+  static constexpr int      kHeight    = 1754;
+  static constexpr unsigned kPageCount = 4;
+
+  // A synthetic table page: a grid of dark lines of various thicknesses on a noisy background with text-like blobs
+  static mln::image2d<std::uint8_t> make_page(unsigned seed)
+  {
+    std::mt19937                   gen(seed);
+    std::uniform_int_distribution<> background(230, 255), ink(0, 80), thickness(1, 4);
+
+    mln::image2d<std::uint8_t> page(kWidth, kHeight);
+    mln_foreach (auto& v, page.values())
+      v = background(gen);
+
+    for (int y0 = 120; y0 < kHeight - 120; y0 += 60)
+    {
+      int th = thickness(gen);
+      for (int y = y0; y < y0 + th; ++y)
+        for (int x = 80; x < kWidth - 80; ++x)
+          page({x, y}) = ink(gen);
+    }
+
+    for (int x0 = 80; x0 < kWidth - 80; x0 += 180)
+    {
+      int th = thickness(gen);
+      for (int x = x0; x < x0 + th; ++x)
+        for (int y = 120; y < kHeight - 120; ++y)
+          page({x, y}) = ink(gen);
+    }
+
+    std::uniform_int_distribution<> px(0, kWidth - 8), py(0, kHeight - 8), dy(0, 6);
+    for (int k = 0; k < 20000; ++k)
+    {
+      int x = px(gen), y = py(gen);
+      for (int i = 0; i < 6; ++i)
+        page({x + i, y + dy(gen)}) = ink(gen);
+    }
+    return page;
+  }
+
+  static std::vector<mln::image2d<std::uint8_t>> g_pages;
+};
+
+std::vector<mln::image2d<std::uint8_t>> BMSegdet::g_pages;
+
+
+BENCHMARK_DEFINE_F(BMSegdet, detect_line)(benchmark::State& st)
+{
+  scribo::SegDetParams params;
+  params.tracker = static_cast<scribo::e_segdet_process_tracking>(st.range(0));
+  this->run(st, [&](const auto& page) { scribo::detect_line_vector(page, 10, params); });
+}
+
+BENCHMARK_REGISTER_F(BMSegdet, detect_line)
+    ->Arg(static_cast<int>(scribo::e_segdet_process_tracking::KALMAN))
+    ->Arg(static_cast<int>(scribo::e_segdet_process_tracking::LAST_INTEGRATION))
+    ->Arg(static_cast<int>(scribo::e_segdet_process_tracking::SIMPLE_MOVING_AVERAGE))
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
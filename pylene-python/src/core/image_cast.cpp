@@ -7,14 +7,69 @@
 #include <fmt/format.h>
 
 #include <cassert>
+#include <cstring>
 #include <vector>
 
 namespace pln
 {
+  namespace
+  {
+    /// \brief Say if an ndbuffer_image can view a buffer with the given byte strides: the samples of a row must be
+    /// adjacent and the other axes must have positive strides multiple of the sample size
+    bool is_viewable(int pdim, const std::ptrdiff_t strides[], std::ptrdiff_t sample_size)
+    {
+      if (strides[0] != sample_size)
+        return false;
+      for (int d = 1; d < pdim; d++)
+        if (strides[d] <= 0 || strides[d] % sample_size != 0)
+          return false;
+      return true;
+    }
+
+    /// \brief Copy the samples of a strided buffer into the compact image \p out
+    /// \param[in] src The buffer
+    /// \param[in] strides The byte strides of the axes of the image
+    /// \param[in] item_size The size of a channel of a sample
+    /// \param[in] channels The number of channels of a sample
+    /// \param[in] channel_stride The byte stride between the channels of a sample
+    /// \param[out] out The output image (already allocated)
+    void copy_strided(const std::byte* src, const std::ptrdiff_t strides[], std::size_t item_size, int channels,
+                      std::ptrdiff_t channel_stride, mln::ndbuffer_image& out)
+    {
+      const int pdim  = out.pdim();
+      const int width = out.size(0);
+      int       coords[mln::PYLENE_NDBUFFER_DEFAULT_DIM] = {0};
+
+      for (int k = 0; k < pdim; k++)
+        if (out.size(k) == 0)
+          return;
+
+      while (true)
+      {
+        const std::byte* s = src;
+        std::byte*       d = out.buffer();
+        for (int k = 1; k < pdim; k++)
+        {
+          s += coords[k] * strides[k];
+          d += coords[k] * out.byte_stride(k);
+        }
+
+        for (int x = 0; x < width; x++, s += strides[0])
+          for (int c = 0; c < channels; c++, d += item_size)
+            std::memcpy(d, s + c * channel_stride, item_size);
+
+        // Next row
+        int k = 1;
+        for (; k < pdim && ++coords[k] == out.size(k); k++)
+          coords[k] = 0;
+        if (k >= pdim)
+          break;
+      }
+    }
+  } // namespace
+
   mln::ndbuffer_image from_numpy(pybind11::array arr)
   {
-    if (!pybind11::detail::check_flags(arr.ptr(), pybind11::detail::npy_api::NPY_ARRAY_C_CONTIGUOUS_))
-      throw std::invalid_argument("Array should be C contiguous");
     auto                base = arr.base();
     const auto          info = arr.request();
     mln::sample_type_id type = get_sample_type(info.format);
@@ -36,7 +91,27 @@ namespace pln
       strides[d] = info.strides[pdim - d - 1];
     }
     const auto sample_type = is_rgb8 ? mln::sample_type_id::RGB8 : type;
-    auto       res =
+    const auto sample_size = info.itemsize * (is_rgb8 ? 3 : 1);
+
+    // The strides of the axes of size 1 are meaningless (NumPy may set them to any value)
+    for (auto d = 0; d < pdim; d++)
+      if (size[d] == 1)
+        strides[d] = (d == 0) ? sample_size : strides[d - 1] * size[d - 1];
+
+    // The samples of a row are not adjacent (Fortran order, step along the columns...) or the rows are reversed: the
+    // array is copied into a compact image since the images assume this layout
+    if (pdim > 0 && ((is_rgb8 && info.strides[2] != info.itemsize) || !is_viewable(pdim, strides, sample_size)))
+    {
+      mln::image_build_params params;
+      params.border = 0;
+      mln::ndbuffer_image res;
+      res.resize(sample_type, pdim, size, params);
+      copy_strided(reinterpret_cast<const std::byte*>(info.ptr), strides, info.itemsize, is_rgb8 ? 3 : 1,
+                   is_rgb8 ? info.strides[2] : 0, res);
+      return res;
+    }
+
+    auto res =
         mln::ndbuffer_image::from_buffer(reinterpret_cast<std::byte*>(info.ptr), sample_type, pdim, size, strides);
     if (base && pybind11::isinstance<mln::internal::ndbuffer_image_data>(base))
       res.__data() = pybind11::cast<std::shared_ptr<mln::internal::ndbuffer_image_data>>(base);
@@ -57,8 +132,8 @@ namespace pln
     /* For the moment, restrict RGB8 image to 2D image */
     const bool               is_rgb8 = img.pdim() == 2 && img.sample_type() == mln::sample_type_id::RGB8;
     const auto               ndim    = img.pdim() + (is_rgb8 ? 1 : 0);
-    std::vector<std::size_t> strides(ndim, 1);
-    std::vector<std::size_t> shapes(ndim, 3);
+    std::vector<Py_intptr_t> strides(ndim, 1);
+    std::vector<Py_intptr_t> shapes(ndim, 3);
     auto                     descr = get_sample_type(img.sample_type());
 
     for (auto d = 0; d < img.pdim(); d++)
@@ -68,8 +143,8 @@ namespace pln
     }
 
     auto res = pybind11::reinterpret_steal<pybind11::object>(api.PyArray_NewFromDescr_(
-        api.PyArray_Type_, descr.release().ptr(), ndim, reinterpret_cast<Py_intptr_t*>(shapes.data()),
-        reinterpret_cast<Py_intptr_t*>(strides.data()), reinterpret_cast<void*>(img.buffer()), flags, nullptr));
+        api.PyArray_Type_, descr.release().ptr(), ndim, shapes.data(), strides.data(),
+        reinterpret_cast<void*>(img.buffer()), flags, nullptr));
 
     if (!res)
       throw std::runtime_error("Unable to create the numpy array in ndimage -> array");
@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "morpho/morpho.hpp"
 #include "scribo/scribo.hpp"
 
 namespace pln
@@ -13,6 +14,8 @@ namespace pln
   PYBIND11_MODULE(pylena, m)
   {
     init_pylena_numpy(m);
+    pln::morpho::define_se(m);
+    pln::morpho::define_morpho(m);
 
 #ifdef ENABLE_SCRIBO
     pln::scribo::define_scribo(m);
@@ -0,0 +1,189 @@
+#include <mln/core/colors.hpp>
+
+#include <pln/core/image_cast.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "component_tree.hpp"
+
+namespace pln::morpho
+{
+  namespace py = pybind11;
+
+  namespace
+  {
+    using mean_types = details::type_list<std::uint8_t, std::uint16_t, std::int32_t, float, double, mln::rgb8>;
+
+    /// \brief Sum the values of the pixels of each node in \p sums (\p C values per node)
+    template <class T, int C>
+    void accumulate_values(const mln::image2d<T>& input, const mln::image2d<int>& node_map, std::vector<double>& sums)
+    {
+      for (int y = 0; y < node_map.height(); y++)
+      {
+        const int* nm = node_map.buffer() + y * node_map.stride();
+        const T*   v  = input.buffer() + y * input.stride();
+        for (int x = 0; x < node_map.width(); x++)
+        {
+          if constexpr (C == 1)
+            sums[nm[x]] += v[x];
+          else
+            for (int c = 0; c < C; c++)
+              sums[C * nm[x] + c] += v[x][c];
+        }
+      }
+    }
+  } // namespace
+
+  py::array ComponentTree::parent(py::object self)
+  {
+    const auto& t = self.cast<const ComponentTree&>();
+    return details::readonly(
+        py::array_t<int>({static_cast<py::ssize_t>(t.size())}, t.m_tree.parent.data(), self)); // self owns the data
+  }
+
+  py::array ComponentTree::node_map() const
+  {
+    return details::readonly(py::reinterpret_borrow<py::array>(pln::to_numpy(m_node_map)));
+  }
+
+  const py::array& ComponentTree::area()
+  {
+    if (!m_area)
+    {
+      auto area = details::without_gil([this] {
+        const auto&               parent = m_tree.parent;
+        std::vector<std::int64_t> area(parent.size(), 0);
+        for (int y = 0; y < m_node_map.height(); y++)
+        {
+          const int* nm = m_node_map.buffer() + y * m_node_map.stride();
+          for (int x = 0; x < m_node_map.width(); x++)
+            area[nm[x]]++;
+        }
+        for (int i = static_cast<int>(parent.size()) - 1; i > 0; --i)
+          area[parent[i]] += area[i];
+        return area;
+      });
+      m_area = details::readonly(details::as_array(std::move(area)));
+    }
+    return *m_area;
+  }
+
+  const py::array& ComponentTree::depth()
+  {
+    if (!m_depth)
+      m_depth = details::readonly(details::as_array(details::without_gil([this] { return m_tree.compute_depth(); })));
+    return *m_depth;
+  }
+
+  const py::array& ComponentTree::bbox()
+  {
+    if (!m_bbox)
+    {
+      auto bbox = details::without_gil([this] {
+        constexpr int kMin = std::numeric_limits<int>::min();
+        constexpr int kMax = std::numeric_limits<int>::max();
+
+        const auto&      parent = m_tree.parent;
+        const auto       tl     = m_node_map.domain().tl();
+        std::vector<int> bbox(4 * parent.size());
+        for (std::size_t i = 0; i < parent.size(); i++)
+        {
+          bbox[4 * i + 0] = bbox[4 * i + 1] = kMax;
+          bbox[4 * i + 2] = bbox[4 * i + 3] = kMin;
+        }
+
+        for (int y = 0; y < m_node_map.height(); y++)
+        {
+          const int* nm = m_node_map.buffer() + y * m_node_map.stride();
+          for (int x = 0; x < m_node_map.width(); x++)
+          {
+            int* b = bbox.data() + 4 * nm[x];
+            b[0]   = std::min(b[0], tl.x() + x);
+            b[1]   = std::min(b[1], tl.y() + y);
+            b[2]   = std::max(b[2], tl.x() + x + 1);
+            b[3]   = std::max(b[3], tl.y() + y + 1);
+          }
+        }
+
+        for (int i = static_cast<int>(parent.size()) - 1; i > 0; --i)
+        {
+          int* b = bbox.data() + 4 * i;
+          int* p = bbox.data() + 4 * parent[i];
+          p[0]   = std::min(p[0], b[0]);
+          p[1]   = std::min(p[1], b[1]);
+          p[2]   = std::max(p[2], b[2]);
+          p[3]   = std::max(p[3], b[3]);
+        }
+        return bbox;
+      });
+      m_bbox = details::readonly(details::as_array(std::move(bbox), {static_cast<py::ssize_t>(size()), 4}));
+    }
+    return *m_bbox;
+  }
+
+  const py::array& ComponentTree::mean()
+  {
+    if (!m_mean)
+    {
+      if (m_input.pdim() != 2 || m_input.size(0) != m_node_map.width() || m_input.size(1) != m_node_map.height())
+        throw std::runtime_error("The node map does not have the size of the input image (the mean is not available "
+                                 "for a tree of shapes with a node map on the twice-size domain)");
+
+      const int channels = m_input.sample_type() == mln::sample_type_id::RGB8 ? 3 : 1;
+      auto      mean     = details::visit(mean_types{}, m_input, [&](const auto& f) {
+        return details::without_gil([&] {
+          using T              = mln::image_value_t<std::remove_cvref_t<decltype(f)>>;
+          constexpr int C      = std::is_same_v<T, mln::rgb8> ? 3 : 1;
+          const auto&   parent = m_tree.parent;
+
+          std::vector<double> sums(C * parent.size(), 0.);
+          std::vector<double> count(parent.size(), 0.);
+          accumulate_values<T, C>(f, m_node_map, sums);
+          for (int y = 0; y < m_node_map.height(); y++)
+          {
+            const int* nm = m_node_map.buffer() + y * m_node_map.stride();
+            for (int x = 0; x < m_node_map.width(); x++)
+              count[nm[x]]++;
+          }
+
+          for (int i = static_cast<int>(parent.size()) - 1; i > 0; --i)
+          {
+            count[parent[i]] += count[i];
+            for (int c = 0; c < C; c++)
+              sums[C * parent[i] + c] += sums[C * i + c];
+          }
+          // The counts include the descendants. Every node has a pixel when the node map has the input size (the
+          // tree of shapes then removes the interpolated nodes), a node without pixel would get NaN.
+          constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+          for (std::size_t i = 0; i < parent.size(); i++)
+            for (int c = 0; c < C; c++)
+              sums[C * i + c] = count[i] > 0 ? sums[C * i + c] / count[i] : kNaN;
+          return sums;
+        });
+      });
+
+      std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(size())};
+      if (channels > 1)
+        shape.push_back(channels);
+      m_mean = details::readonly(details::as_array(std::move(mean), shape));
+    }
+    return *m_mean;
+  }
+
+  void define_component_tree(py::module& m)
+  {
+    py::class_<ComponentTree>(m, "ComponentTree")
+        .def("__len__", &ComponentTree::size)
+        .def_property_readonly("parent", &ComponentTree::parent)
+        .def_property_readonly("values", &ComponentTree::values)
+        .def_property_readonly("node_map", &ComponentTree::node_map)
+        .def_property_readonly("area", &ComponentTree::area)
+        .def_property_readonly("depth", &ComponentTree::depth)
+        .def_property_readonly("bbox", &ComponentTree::bbox)
+        .def_property_readonly("mean", &ComponentTree::mean);
+  }
+} // namespace pln::morpho
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mln/core/image/ndimage.hpp>
+#include <mln/morpho/component_tree.hpp>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <optional>
+#include <utility>
+
+#include "dispatch.hpp"
+
+namespace pln::morpho
+{
+  /// \brief Component tree exposed in Python
+  ///
+  /// The parent array, the values and the node map are exposed as read-only NumPy arrays sharing their data with the
+  /// tree. The attributes are computed on first access and cached.
+  class ComponentTree
+  {
+  public:
+    /// \param[in] tree The tree
+    /// \param[in] node_map The node map (pixel -> node id)
+    /// \param[in] input The image on which the tree has been computed
+    /// \param[in] input_owner The Python object owning the buffer of \p input
+    template <class V>
+    ComponentTree(mln::morpho::component_tree<V>&& tree, mln::image2d<int>&& node_map, mln::ndbuffer_image input,
+                  pybind11::object input_owner)
+      : m_values(details::readonly(details::as_array(std::move(tree.values))))
+      , m_node_map(std::move(node_map))
+      , m_input(std::move(input))
+      , m_input_owner(std::move(input_owner))
+    {
+      m_tree.parent = std::move(tree.parent);
+    }
+
+    /// \brief The number of nodes
+    std::size_t size() const noexcept { return m_tree.parent.size(); }
+
+    /// \brief The parent array (node id -> parent node id), \p self is the Python object of the tree
+    static pybind11::array parent(pybind11::object self);
+
+    /// \brief The level of the nodes
+    const pybind11::array& values() const noexcept { return m_values; }
+
+    /// \brief The node map (pixel -> node id)
+    pybind11::array node_map() const;
+
+    /// \brief The number of pixels of the nodes
+    const pybind11::array& area();
+
+    /// \brief The depth of the nodes (0 for the root)
+    const pybind11::array& depth();
+
+    /// \brief The bounding box of the nodes as rows (x0, y0, x1, y1) with x1 and y1 excluded, in the coordinates of the
+    /// node map
+    const pybind11::array& bbox();
+
+    /// \brief The mean value of the input pixels of the nodes (an extra dimension holds the channels of rgb8 images),
+    /// NaN for a node without pixel
+    const pybind11::array& mean();
+
+  private:
+    mln::morpho::component_tree<> m_tree;
+    pybind11::array               m_values;
+    mln::image2d<int>             m_node_map;
+    mln::ndbuffer_image           m_input;
+    pybind11::object              m_input_owner; // Keeps the buffer of m_input alive
+
+    // Cached attributes
+    std::optional<pybind11::array> m_area;
+    std::optional<pybind11::array> m_depth;
+    std::optional<pybind11::array> m_bbox;
+    std::optional<pybind11::array> m_mean;
+  };
+
+  /// \brief Export the ComponentTree class
+  /// \param[in] m The module in which the class is exported
+  void define_component_tree(pybind11::module& m);
+} // namespace pln::morpho
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/neighborhood/c4.hpp>
+#include <mln/core/neighborhood/c8.hpp>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <fmt/format.h>
+
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pln::morpho::details
+{
+  template <class... T>
+  struct type_list
+  {
+  };
+
+  /// \brief Call \p f with the 2D image of the first type of the list matching the sample type of \p input (the image
+  /// is a view, no data is copied)
+  template <class... T, class F>
+  auto visit(type_list<T...>, const mln::ndbuffer_image& input, F f)
+  {
+    using R = std::common_type_t<std::invoke_result_t<F, const mln::image2d<T>&>...>;
+
+    if (input.pdim() != 2)
+      throw std::invalid_argument(fmt::format("Invalid number of dimension (Got {} but should be 2)", input.pdim()));
+
+    std::optional<R> res;
+    auto             try_type = [&]<class V>(std::type_identity<V>) {
+      if (const auto* ima = input.template cast_to<V, 2>(); ima && !res)
+        res.emplace(f(*ima));
+    };
+    (try_type(std::type_identity<T>{}), ...);
+
+    if (!res)
+      throw std::invalid_argument("Unsupported dtype for this operator");
+    return std::move(*res);
+  }
+
+  /// \brief Call \p f with the neighborhood of the given connectivity (4 or 8)
+  template <class F>
+  auto with_connectivity(int connectivity, F f)
+  {
+    switch (connectivity)
+    {
+    case 4:
+      return f(mln::c4);
+    case 8:
+      return f(mln::c8);
+    default:
+      throw std::invalid_argument(fmt::format("Invalid connectivity (Got {} expected 4 or 8)", connectivity));
+    }
+  }
+
+  /// \brief Run \p f without holding the GIL (\p f must not touch any Python object)
+  template <class F>
+  auto without_gil(F f)
+  {
+    pybind11::gil_scoped_release release;
+    return f();
+  }
+
+  /// \brief Move a vector into a NumPy array without copying its data
+  /// \param[in] v The vector
+  /// \param[in] shape The shape of the array (by default, a 1D array of the size of the vector)
+  template <class T>
+  pybind11::array as_array(std::vector<T>&& v, std::vector<pybind11::ssize_t> shape = {})
+  {
+    auto*             data = new std::vector<T>(std::move(v));
+    pybind11::capsule owner(data, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    if (shape.empty())
+      shape = {static_cast<pybind11::ssize_t>(data->size())};
+    return pybind11::array_t<T>(shape, data->data(), owner);
+  }
+
+  /// \brief Clear the writeable flag of a NumPy array
+  inline pybind11::array readonly(pybind11::array arr)
+  {
+    pybind11::detail::array_proxy(arr.ptr())->flags &= ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return arr;
+  }
+} // namespace pln::morpho::details
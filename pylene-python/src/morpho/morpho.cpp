@@ -0,0 +1,225 @@
+#include <mln/core/colors.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/se/disc.hpp>
+#include <mln/core/se/periodic_line2d.hpp>
+#include <mln/core/se/rect2d.hpp>
+#include <mln/morpho/alphatree.hpp>
+#include <mln/morpho/area_filter.hpp>
+#include <mln/morpho/closing.hpp>
+#include <mln/morpho/dilation.hpp>
+#include <mln/morpho/dynamic_filter.hpp>
+#include <mln/morpho/erosion.hpp>
+#include <mln/morpho/maxtree.hpp>
+#include <mln/morpho/opening.hpp>
+#include <mln/morpho/tos.hpp>
+#include <mln/morpho/watershed_hierarchy.hpp>
+
+#include <pln/core/image_cast.hpp>
+
+#include <pybind11/stl.h>
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "component_tree.hpp"
+#include "dispatch.hpp"
+#include "morpho.hpp"
+
+namespace pln::morpho
+{
+  namespace py = pybind11;
+
+  namespace
+  {
+    using details::type_list;
+    using details::visit;
+    using details::with_connectivity;
+    using details::without_gil;
+
+    using filter_types    = type_list<std::uint8_t, std::uint16_t, std::int32_t, float>;
+    using leveling_types  = type_list<std::uint8_t, std::uint16_t>;
+    using tos_types       = type_list<std::uint8_t, std::uint16_t, float>;
+    using alphatree_types = type_list<std::uint8_t, std::uint16_t, mln::rgb8>;
+
+    /// \brief Wrap a pair (tree, node_map) computed on the image \p input viewing the array \p arr
+    template <class V>
+    ComponentTree make_tree(std::pair<mln::morpho::component_tree<V>, mln::image2d<int>>&& tree,
+                            const mln::ndbuffer_image& input, py::array arr)
+    {
+      return ComponentTree(std::move(tree.first), std::move(tree.second), input, std::move(arr));
+    }
+
+    template <class SE>
+    void define_structural(py::module& m)
+    {
+      m.def(
+          "dilation",
+          [](const mln::ndbuffer_image& img, const SE& se, bool parallel) {
+            return visit(filter_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+              return without_gil([&] {
+                return parallel ? mln::morpho::parallel::dilation(f, se) : mln::morpho::dilation(f, se);
+              });
+            });
+          },
+          py::arg("img"), py::arg("se"), py::arg("parallel") = false);
+
+      m.def(
+          "erosion",
+          [](const mln::ndbuffer_image& img, const SE& se, bool parallel) {
+            return visit(filter_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+              return without_gil([&] {
+                return parallel ? mln::morpho::parallel::erosion(f, se) : mln::morpho::erosion(f, se);
+              });
+            });
+          },
+          py::arg("img"), py::arg("se"), py::arg("parallel") = false);
+
+      m.def(
+          "opening",
+          [](const mln::ndbuffer_image& img, const SE& se, bool parallel) {
+            return visit(filter_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+              return without_gil([&] {
+                if (parallel)
+                  return mln::morpho::parallel::dilation(mln::morpho::parallel::erosion(f, se), se);
+                return mln::morpho::opening(f, se);
+              });
+            });
+          },
+          py::arg("img"), py::arg("se"), py::arg("parallel") = false);
+
+      m.def(
+          "closing",
+          [](const mln::ndbuffer_image& img, const SE& se, bool parallel) {
+            return visit(filter_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+              return without_gil([&] {
+                if (parallel)
+                  return mln::morpho::parallel::erosion(mln::morpho::parallel::dilation(f, se), se);
+                return mln::morpho::closing(f, se);
+              });
+            });
+          },
+          py::arg("img"), py::arg("se"), py::arg("parallel") = false);
+    }
+  } // namespace
+
+  void define_morpho(py::module& _m)
+  {
+    auto m = _m.def_submodule("morpho");
+
+    define_structural<mln::se::rect2d>(m);
+    define_structural<mln::se::disc>(m);
+    define_structural<mln::se::periodic_line2d>(m);
+
+    // Connected filters
+    m.def(
+        "area_opening",
+        [](const mln::ndbuffer_image& img, int area, int connectivity) {
+          return visit(leveling_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return without_gil([&] { return mln::morpho::area_opening(f, nbh, area); });
+            });
+          });
+        },
+        py::arg("img"), py::arg("area"), py::arg("connectivity") = 4);
+
+    m.def(
+        "area_closing",
+        [](const mln::ndbuffer_image& img, int area, int connectivity) {
+          return visit(leveling_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return without_gil([&] { return mln::morpho::area_closing(f, nbh, area); });
+            });
+          });
+        },
+        py::arg("img"), py::arg("area"), py::arg("connectivity") = 4);
+
+    m.def(
+        "dynamic_opening",
+        [](const mln::ndbuffer_image& img, int dynamic, int connectivity) {
+          return visit(leveling_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return without_gil([&] { return mln::morpho::dynamic_opening(f, nbh, dynamic); });
+            });
+          });
+        },
+        py::arg("img"), py::arg("dynamic"), py::arg("connectivity") = 4);
+
+    m.def(
+        "dynamic_closing",
+        [](const mln::ndbuffer_image& img, int dynamic, int connectivity) {
+          return visit(leveling_types{}, img, [&](const auto& f) -> mln::ndbuffer_image {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return without_gil([&] { return mln::morpho::dynamic_closing(f, nbh, dynamic); });
+            });
+          });
+        },
+        py::arg("img"), py::arg("dynamic"), py::arg("connectivity") = 4);
+
+    // Trees
+    define_component_tree(m);
+
+    m.def(
+        "maxtree",
+        [](py::array arr, int connectivity) {
+          const auto img = pln::from_numpy(arr);
+          return visit(leveling_types{}, img, [&](const auto& f) {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return make_tree(without_gil([&] { return mln::morpho::maxtree(f, nbh); }), img, arr);
+            });
+          });
+        },
+        py::arg("img"), py::arg("connectivity") = 4);
+
+    m.def(
+        "tos",
+        [](py::array arr, std::pair<int, int> root, bool twice_size) {
+          const auto img   = pln::from_numpy(arr);
+          const int  flags = twice_size ? mln::morpho::ToS_NodeMapTwiceSize : mln::morpho::ToS_NodeMapOriginalSize;
+          return visit(tos_types{}, img, [&](const auto& f) {
+            // root is given as (row, column)
+            const mln::point2d pstart{root.second, root.first};
+            if (!f.domain().has(pstart))
+              throw std::invalid_argument("The root point is outside the image");
+            return make_tree(without_gil([&] { return mln::morpho::tos(f, pstart, flags); }), img, arr);
+          });
+        },
+        py::arg("img"), py::arg("root") = std::pair<int, int>{0, 0}, py::arg("twice_size") = true);
+
+    m.def(
+        "alphatree",
+        [](py::array arr, int connectivity) {
+          const auto img = pln::from_numpy(arr);
+          return visit(alphatree_types{}, img, [&](const auto& f) {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return make_tree(without_gil([&] { return mln::morpho::alphatree(f, nbh); }), img, arr);
+            });
+          });
+        },
+        py::arg("img"), py::arg("connectivity") = 4);
+
+    m.def(
+        "watershed_hierarchy",
+        [](py::array arr, const std::string& attribute, int connectivity) {
+          mln::morpho::WatershedAttribute attr;
+          if (attribute == "height")
+            attr = mln::morpho::HEIGHT;
+          else if (attribute == "dynamic")
+            attr = mln::morpho::DYNAMIC;
+          else
+            throw std::invalid_argument(
+                fmt::format("Invalid watershed attribute (Got {} expected height or dynamic)", attribute));
+
+          const auto img = pln::from_numpy(arr);
+          return visit(alphatree_types{}, img, [&](const auto& f) {
+            return with_connectivity(connectivity, [&](auto nbh) {
+              return make_tree(without_gil([&] { return mln::morpho::watershed_hierarchy(f, attr, nbh); }), img, arr);
+            });
+          });
+        },
+        py::arg("img"), py::arg("attribute") = "height", py::arg("connectivity") = 4);
+  }
+} // namespace pln::morpho
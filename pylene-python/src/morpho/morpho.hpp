@@ -0,0 +1,14 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace pln::morpho
+{
+  /// \brief Export the structuring elements in the submodule `se`
+  /// \param[in] _m The module in which the submodule is created
+  void define_se(pybind11::module& _m);
+
+  /// \brief Export the morphological operators and trees in the submodule `morpho`
+  /// \param[in] _m The module in which the submodule is created
+  void define_morpho(pybind11::module& _m);
+} // namespace pln::morpho
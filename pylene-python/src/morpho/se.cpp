@@ -0,0 +1,26 @@
+#include <mln/core/se/disc.hpp>
+#include <mln/core/se/periodic_line2d.hpp>
+#include <mln/core/se/rect2d.hpp>
+
+#include "morpho.hpp"
+
+namespace pln::morpho
+{
+  void define_se(pybind11::module& _m)
+  {
+    namespace py = pybind11;
+    auto m       = _m.def_submodule("se");
+
+    py::class_<mln::se::rect2d>(m, "rect2d").def(py::init<int, int>(), py::arg("width"), py::arg("height"));
+
+    py::class_<mln::se::disc>(m, "disc")
+        .def(py::init([](float radius, bool exact) {
+               return mln::se::disc(radius, exact ? mln::se::disc::EXACT : mln::se::disc::PERIODIC_LINES_8);
+             }),
+             py::arg("radius"), py::arg("exact") = false);
+
+    py::class_<mln::se::periodic_line2d>(m, "periodic_line2d")
+        .def(py::init([](int dx, int dy, int k) { return mln::se::periodic_line2d(mln::point2d{dx, dy}, k); }),
+             py::arg("dx"), py::arg("dy"), py::arg("k"));
+  }
+} // namespace pln::morpho
@@ -12,5 +12,8 @@ namespace pln::scribo
 
     m.def("detect_line", &pln::scribo::detect_line, pybind11::arg("img"), pybind11::arg("min_len"),
           pybind11::arg("mode") = "pixel", pybind11::arg("params") = std::map<std::string, float>());
+
+    m.def("detect_line_batch", &pln::scribo::detect_line_batch, pybind11::arg("imgs"), pybind11::arg("min_len"),
+          pybind11::arg("params") = std::map<std::string, float>(), pybind11::arg("nthreads") = 0);
   }
 } // namespace pln::scribo
\ No newline at end of file
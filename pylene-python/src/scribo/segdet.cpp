@@ -1,12 +1,15 @@
-#include <mln/core/algorithm/fill.hpp>
+#include <mln/core/image/ndimage.hpp>
 #include <mln/core/image/private/ndbuffer_image.hpp>
 #include <mln/core/image_format.hpp>
 #include <scribo/private/segdet_internal.hpp>
-#include <scribo/private/segment.hpp>
+#include <scribo/private/span.hpp>
 
 #include <pln/core/image_cast.hpp>
 #include <pybind11/pybind11.h>
+#include <scribo/segdet.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <exception>
 #include <utility>
 
@@ -25,10 +28,34 @@ namespace pln::scribo
       auto str = kvp.first;
       auto val = kvp.second;
 
-      if (str == GET_VARIABLE_NAME(nb_values_to_keep))
-        params.nb_values_to_keep = val;
+      if (str == GET_VARIABLE_NAME(negate_image))
+        params.negate_image = (val != 0);
       else if (str == GET_VARIABLE_NAME(dyn))
         params.dyn = val;
+      else if (str == GET_VARIABLE_NAME(size_mask))
+        params.size_mask = val;
+      else if (str == GET_VARIABLE_NAME(double_exponential_alpha))
+        params.double_exponential_alpha = val;
+      else if (str == GET_VARIABLE_NAME(simple_moving_average_memory))
+        params.simple_moving_average_memory = val;
+      else if (str == GET_VARIABLE_NAME(exponential_moving_average_memory))
+        params.exponential_moving_average_memory = val;
+      else if (str == GET_VARIABLE_NAME(one_euro_beta))
+        params.one_euro_beta = val;
+      else if (str == GET_VARIABLE_NAME(one_euro_mincutoff))
+        params.one_euro_mincutoff = val;
+      else if (str == GET_VARIABLE_NAME(one_euro_dcutoff))
+        params.one_euro_dcutoff = val;
+      else if (str == GET_VARIABLE_NAME(bucket_size))
+        params.bucket_size = val;
+      else if (str == GET_VARIABLE_NAME(nb_values_to_keep))
+        params.nb_values_to_keep = val;
+      else if (str == GET_VARIABLE_NAME(discontinuity_relative))
+        params.discontinuity_relative = val;
+      else if (str == GET_VARIABLE_NAME(discontinuity_absolute))
+        params.discontinuity_absolute = val;
+      else if (str == GET_VARIABLE_NAME(minimum_for_fusion))
+        params.minimum_for_fusion = val;
       else if (str == GET_VARIABLE_NAME(default_sigma_position))
         params.default_sigma_position = val;
       else if (str == GET_VARIABLE_NAME(default_sigma_thickness))
@@ -43,24 +70,22 @@ namespace pln::scribo
         params.sigma_thickness_min = val;
       else if (str == GET_VARIABLE_NAME(sigma_luminosity_min))
         params.sigma_luminosity_min = val;
-      else if (str == GET_VARIABLE_NAME(max_thickness))
-        params.max_thickness = val;
+      else if (str == GET_VARIABLE_NAME(gradient_threshold))
+        params.gradient_threshold = val;
       else if (str == GET_VARIABLE_NAME(llumi))
         params.llumi = val;
+      else if (str == GET_VARIABLE_NAME(blumi))
+        params.blumi = val;
       else if (str == GET_VARIABLE_NAME(ratio_lum))
         params.ratio_lum = val;
-      else if (str == GET_VARIABLE_NAME(merge_slope_variation))
-        params.merge_slope_variation = val;
-      else if (str == GET_VARIABLE_NAME(merge_distance_max))
-        params.merge_distance_max = val;
+      else if (str == GET_VARIABLE_NAME(max_thickness))
+        params.max_thickness = val;
       else if (str == GET_VARIABLE_NAME(threshold_intersection))
         params.threshold_intersection = val;
-      else if (str == GET_VARIABLE_NAME(minimum_for_fusion))
-        params.minimum_for_fusion = val;
-      else if (str == GET_VARIABLE_NAME(discontinuity))
-        params.discontinuity = val;
+      else if (str == GET_VARIABLE_NAME(remove_duplicates))
+        params.remove_duplicates = (val != 0);
       else
-        exit(-255);
+        throw pybind11::value_error("Unknown parameter " + str);
     }
     return params;
   }
@@ -80,26 +105,45 @@ namespace pln::scribo
     return params_cpp;
   }
 
-  std::vector<::scribo::internal::Segment> detect_line_base(mln::ndbuffer_image img, int min_len,
-                                                            const std::map<std::string, float>& params)
+  /// The spans of a detected segment (including the spans under other objects)
+  struct SegmentSpans
+  {
+    bool                                  is_horizontal;
+    std::vector<::scribo::internal::Span> spans;
+  };
+
+  std::vector<SegmentSpans> detect_line_base(mln::ndbuffer_image img, int min_len,
+                                             const std::map<std::string, float>& params)
   {
     ::scribo::SegDetParams params_cpp = get_parameters(params);
     auto*                  cast_img   = img.cast_to<std::uint8_t, 2>();
     if (!cast_img)
       throw std::invalid_argument("Input image should be 2D uint8");
-    return ::scribo::internal::detect_line_seg(*cast_img, min_len, params_cpp);
+    auto out = ::scribo::internal::detect_line_span(*cast_img, min_len, params_cpp);
+
+    // The spans are grouped by segment with increasing ids
+    std::vector<SegmentSpans> segments;
+    for (std::size_t i = 0; i < out.seg_ids.size(); i++)
+    {
+      if (out.seg_ids[i] >= static_cast<int>(segments.size()))
+        segments.resize(out.seg_ids[i] + 1);
+      auto& seg         = segments[out.seg_ids[i]];
+      seg.is_horizontal = out.angle[i];
+      seg.spans.push_back({out.mid_pos_x[i], out.mid_pos_y[i], out.thickness[i]});
+    }
+    return segments;
   }
 
 
   mln::ndbuffer_image detect_line_pixel(mln::ndbuffer_image img, int min_len,
                                         const std::map<std::string, float>& params)
   {
+    int  width = img.size(0), height = img.size(1);
     auto segments = detect_line_base(std::move(img), min_len, params);
 
     std::vector<std::vector<int>> segment_pixels = {};
 
     int x, y;
-    int width = img.size(0), height = img.size(1);
 
     int segments_number = static_cast<int>(segments.size());
     for (int s = 0; s < segments_number; s++)
@@ -209,7 +253,7 @@ namespace pln::scribo
   mln::ndbuffer_image detect_line_vectors(mln::ndbuffer_image img, int min_len,
                                           const std::map<std::string, float>& params, float precision = 15)
   {
-    std::vector<::scribo::internal::Segment> p = detect_line_base(std::move(img), min_len, params);
+    std::vector<SegmentSpans> p = detect_line_base(std::move(img), min_len, params);
 
     std::vector<std::vector<::scribo::internal::Span>> vector_spans = {};
     int                                                nb_spans     = 0;
@@ -240,38 +284,39 @@ namespace pln::scribo
     return static_cast<mln::ndbuffer_image>(out);
   }
 
-  mln::ndbuffer_image detect_line_vector(mln::ndbuffer_image img, int min_len,
-                                         const std::map<std::string, float>& params)
+  mln::ndbuffer_image segments_to_array(const std::vector<::scribo::VSegment>& segments)
   {
-    std::vector<::scribo::internal::Segment> segments = detect_line_base(std::move(img), min_len, params);
-
     int                         segments_number = static_cast<int>(segments.size());
     mln::image2d<std::uint32_t> out(4, segments_number);
-
     for (int i = 0; i < segments_number; i++)
     {
-      std::vector<::scribo::internal::Span> spans =
-          init_douglas_peucker(segments[i].spans, segments[i].is_horizontal, 50000);
-      out({0, i}) = spans[0].x;
-      out({1, i}) = spans[0].y;
-      out({2, i}) = spans[1].x;
-      out({3, i}) = spans[1].y;
+      out({0, i}) = segments[i].x0;
+      out({1, i}) = segments[i].y0;
+      out({2, i}) = segments[i].x1;
+      out({3, i}) = segments[i].y1;
     }
-
     return static_cast<mln::ndbuffer_image>(out);
   }
 
+  mln::ndbuffer_image detect_line_vector(mln::ndbuffer_image img, int min_len,
+                                         const std::map<std::string, float>& params)
+  {
+    ::scribo::SegDetParams params_cpp = get_parameters(params);
+    auto*                  cast_img   = img.cast_to<std::uint8_t, 2>();
+    if (!cast_img)
+      throw std::invalid_argument("Input image should be 2D uint8");
+    return segments_to_array(::scribo::detect_line_vector(*cast_img, min_len, params_cpp));
+  }
+
   mln::ndbuffer_image detect_line_label(mln::ndbuffer_image img, int min_len,
                                         const std::map<std::string, float>& params)
   {
-    mln::image2d<uint16_t> out(img.size(0), img.size(1));
+    ::scribo::SegDetParams params_cpp = get_parameters(params);
     auto*                  cast_img   = img.cast_to<std::uint8_t, 2>();
     if (!cast_img)
       throw std::invalid_argument("Input image should be 2D uint8");
 
-    auto p = parse_parameters(params);
-    ::scribo::internal::detect_line_label(*cast_img, min_len, out, p);
-
+    auto [out, _] = ::scribo::detect_line_label(*cast_img, min_len, params_cpp);
     return static_cast<mln::ndbuffer_image>(out);
   }
 
@@ -287,4 +332,34 @@ namespace pln::scribo
     else
       throw std::invalid_argument(R"(Invalid mode. Suitable modes are "pixel", "vector", "polyline".)");
   }
-} // namespace pln::scribo
\ No newline at end of file
+
+  std::vector<mln::ndbuffer_image> detect_line_batch(std::vector<mln::ndbuffer_image> imgs, int min_len,
+                                                     const std::map<std::string, float>& params, int nthreads)
+  {
+    // The parameters are parsed once for the whole batch
+    ::scribo::SegDetParams params_cpp = get_parameters(params);
+
+    std::vector<mln::image2d<std::uint8_t>> images;
+    images.reserve(imgs.size());
+    for (auto& img : imgs)
+    {
+      auto* cast_img = img.cast_to<std::uint8_t, 2>();
+      if (!cast_img)
+        throw std::invalid_argument("Input images should be 2D uint8");
+      images.push_back(*cast_img);
+    }
+
+    // The images do not hold Python objects, the detection runs without the GIL
+    std::vector<std::vector<::scribo::VSegment>> segments;
+    {
+      pybind11::gil_scoped_release release;
+      segments = ::scribo::detect_line_batch(images, min_len, params_cpp, nthreads);
+    }
+
+    std::vector<mln::ndbuffer_image> ret;
+    ret.reserve(segments.size());
+    for (const auto& segs : segments)
+      ret.push_back(segments_to_array(segs));
+    return ret;
+  }
+} // namespace pln::scribo
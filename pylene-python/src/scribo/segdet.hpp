@@ -6,6 +6,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace pln::scribo
 {
@@ -16,4 +17,10 @@ namespace pln::scribo
 
   mln::ndbuffer_image detect_line(mln::ndbuffer_image img, int min_len, const std::string& mode = "pixel",
                                   const std::map<std::string, float>& params = std::map<std::string, float>());
+
+  /// Detect the segments of several images in parallel, without holding the GIL. Return a (n, 4) array of segments
+  /// (x0, y0, x1, y1) per image.
+  std::vector<mln::ndbuffer_image>
+  detect_line_batch(std::vector<mln::ndbuffer_image> imgs, int min_len,
+                    const std::map<std::string, float>& params = std::map<std::string, float>(), int nthreads = 0);
 } // namespace pln::scribo
\ No newline at end of file
@@ -8,6 +8,8 @@ namespace mln::bp
 
   /// \brief Return an unitialized 2D-buffer with lines aligned on 32 bytes boundaries.
   ///
+  /// The buffer is allocated with the current image allocator (see ``mln::get_image_allocator``).
+  ///
   /// The pitch is the number of bytes between two consecutive lines. The pointer as to be freed
   /// with ``mlb::bp::free``
   ///
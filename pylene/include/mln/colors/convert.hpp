@@ -0,0 +1,106 @@
+#pragma once
+
+#include <mln/colors/lab.hpp>
+#include <mln/colors/lsh.hpp>
+#include <mln/colors/xyz.hpp>
+#include <mln/colors/ycbcr.hpp>
+#include <mln/core/colors.hpp>
+#include <mln/core/image/ndimage.hpp>
+
+
+namespace mln::colors
+{
+  /// \brief Convert a whole RGB image to another color space
+  ///
+  /// The result is the same as applying the pixelwise conversion (rgb2xyz, rgb2lab, rgb2lsh, rgb2ycbcr) to every
+  /// pixel, up to the float rounding errors for XYZ and L*a*b*. The color space is selected by its tag, e.g.
+  /// `convert(f, lab_tag{})`.
+  ///
+  /// \param f The input RGB image
+  /// \return The converted image
+  image2d<xyz<float>> convert(const image2d<rgb8>& f, xyz_tag);
+  image2d<lab<float>> convert(const image2d<rgb8>& f, lab_tag);
+  image2d<lsh8>       convert(const image2d<rgb8>& f, lsh_tag);
+  image2d<ycbcr8>     convert(const image2d<rgb8>& f, ycbcr_tag);
+
+  namespace parallel
+  {
+    /// \brief Parallel versions of mln::colors::convert (the image is processed by tiles)
+    image2d<xyz<float>> convert(const image2d<rgb8>& f, xyz_tag);
+    image2d<lab<float>> convert(const image2d<rgb8>& f, lab_tag);
+    image2d<lsh8>       convert(const image2d<rgb8>& f, lsh_tag);
+    image2d<ycbcr8>     convert(const image2d<rgb8>& f, ycbcr_tag);
+  } // namespace parallel
+
+
+  /******************************************/
+  /****          Implementation          ****/
+  /******************************************/
+
+  namespace impl
+  {
+    enum class rgb8_conversion
+    {
+      XYZ,
+      LAB,
+      LSH,
+      YCBCR,
+    };
+
+    /// \brief Convert the rgb8 buffer \p in to \p out (same domain)
+    ///
+    /// \p out holds 3 floats per pixel for XYZ and L*a*b*, and 3 bytes per pixel otherwise.
+    void convert_rgb8(const ndbuffer_image& in, ndbuffer_image& out, rgb8_conversion conv, bool parallel);
+
+    template <class V>
+    image2d<V> convert_rgb8_T(const image2d<rgb8>& f, rgb8_conversion conv, bool parallel)
+    {
+      image2d<V> out(f.domain());
+      convert_rgb8(f, out, conv, parallel);
+      return out;
+    }
+  } // namespace impl
+
+  inline image2d<xyz<float>> convert(const image2d<rgb8>& f, xyz_tag)
+  {
+    return impl::convert_rgb8_T<xyz<float>>(f, impl::rgb8_conversion::XYZ, false);
+  }
+
+  inline image2d<lab<float>> convert(const image2d<rgb8>& f, lab_tag)
+  {
+    return impl::convert_rgb8_T<lab<float>>(f, impl::rgb8_conversion::LAB, false);
+  }
+
+  inline image2d<lsh8> convert(const image2d<rgb8>& f, lsh_tag)
+  {
+    return impl::convert_rgb8_T<lsh8>(f, impl::rgb8_conversion::LSH, false);
+  }
+
+  inline image2d<ycbcr8> convert(const image2d<rgb8>& f, ycbcr_tag)
+  {
+    return impl::convert_rgb8_T<ycbcr8>(f, impl::rgb8_conversion::YCBCR, false);
+  }
+
+  namespace parallel
+  {
+    inline image2d<xyz<float>> convert(const image2d<rgb8>& f, xyz_tag)
+    {
+      return impl::convert_rgb8_T<xyz<float>>(f, impl::rgb8_conversion::XYZ, true);
+    }
+
+    inline image2d<lab<float>> convert(const image2d<rgb8>& f, lab_tag)
+    {
+      return impl::convert_rgb8_T<lab<float>>(f, impl::rgb8_conversion::LAB, true);
+    }
+
+    inline image2d<lsh8> convert(const image2d<rgb8>& f, lsh_tag)
+    {
+      return impl::convert_rgb8_T<lsh8>(f, impl::rgb8_conversion::LSH, true);
+    }
+
+    inline image2d<ycbcr8> convert(const image2d<rgb8>& f, ycbcr_tag)
+    {
+      return impl::convert_rgb8_T<ycbcr8>(f, impl::rgb8_conversion::YCBCR, true);
+    }
+  } // namespace parallel
+} // namespace mln::colors
@@ -1,81 +1,125 @@
 #pragma once
 
 #include <mln/core/image/ndimage.hpp>
-#include <mln/core/se/rect2d.hpp>
 #include <mln/core/range/foreach.hpp>
+#include <mln/core/trace.hpp>
 
 #include <mln/core/value/value_traits.hpp>
-#include <mln/core/vec.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
 
 namespace mln
 {
   namespace contrib
   {
+    /// \brief Parameters of the meanshift filter
+    struct meanshift_params
+    {
+      int   radius         = 5;    // Spatial window radius
+      int   max_iterations = 30;   // Maximal number of iterations
+      float epsilon        = 0.1f; // Stop when the joint (site, value) displacement is below epsilon
+    };
 
+    /// \brief Meanshift filtering with a gaussian kernel
+    ///
+    /// Each pixel moves in the joint (site, value) space toward the weighted mean of the pixels of the window centered
+    /// on its original site, until convergence. The pixel gets the value of its point of convergence.
+    ///
+    /// \param f The input image (scalar or vectorial values with at most 4 channels)
+    /// \param hs The spatial bandwidth
+    /// \param hr The range bandwidth
+    /// \param params The window radius and the iteration budget
     template <class V>
-    mln::image2d<V> meanshift(const mln::image2d<V>& f, float hs, float hr)
+    mln::image2d<V> meanshift(const mln::image2d<V>& f, float hs, float hr, meanshift_params params = {});
+
+    namespace parallel
     {
-      int    SR    = 5;   // Spatial window radius
-      int    NITER = 30;  // Maximal number of iteration
-      float  eps   = 0.1f; //
-      double hs2   = hs * hs;
-      double hr2   = hr * hr;
-      double eps2  = eps * eps;
+      /// \brief Parallel version of mln::contrib::meanshift (the rows are processed in parallel)
+      template <class V>
+      mln::image2d<V> meanshift(const mln::image2d<V>& f, float hs, float hr, meanshift_params params = {});
+    } // namespace parallel
 
-      typedef vec<double, value_traits<V>::ndim> value_t;
-      typedef vec<double, 2>                     site_t;
 
-      mln::image2d<V> out;
-      resize(out, f);
+    /******************************************/
+    /****          Implementation          ****/
+    /******************************************/
 
-      mln::se::rect2d win(2 * SR + 1, 2 * SR + 1);
+    namespace impl
+    {
+      /// \brief Meanshift filtering of planar float channels
+      ///
+      /// The weights of a window row are computed with simd (with a vectorized exponential) and the window is clipped
+      /// to the domain once per pixel, so that there is no domain test in the inner loop.
+      ///
+      /// \param in The \p nchannels planes of size width × height (contiguous)
+      /// \param out The output planes (same layout)
+      void meanshift(const float* in, float* out, int nchannels, int width, int height, float hs, float hr,
+                     const meanshift_params& params, bool parallel);
 
-      auto g = [](double x) -> double { return std::exp(-x); };
-      mln_foreach (auto p, f.domain())
+      template <class V>
+      mln::image2d<V> meanshift_T(const mln::image2d<V>& f, float hs, float hr, const meanshift_params& params,
+                                  bool parallel)
       {
-        site_t   py = {static_cast<double>(p.x()), static_cast<double>(p.y())};
-        value_t  vy = f(p).as_vec();
+        mln_entering("mln::contrib::meanshift");
 
-        bool stop = false;
-        for (int i = 0; i <= NITER and (not stop); ++i)
-        {
-          site_t  s1 = literal::zero;
-          value_t s2 = literal::zero;
-          double  s3 = 0;
+        constexpr int N = value_traits<V>::ndim;
+        static_assert(N <= 4, "Only images with at most 4 channels are supported.");
 
-          for (auto q : win(p))
+        const std::size_t size = static_cast<std::size_t>(f.width()) * f.height();
+
+        // Split the channels into float planes
+        std::vector<float> in(N * size), out(N * size);
+        {
+          std::size_t i = 0;
+          mln_foreach (auto v, f.values())
           {
-            if (f.domain().has(q))
-            {
-              site_t vq = {static_cast<double>(q.x()), static_cast<double>(q.y())};
-              double d0 = l2norm_sqr(py - vq) / hs2;
-              double d1 = l2norm_sqr(vy - f(q).as_vec()) / hr2;
-              double d  = g(d0 + d1);
-              s1 += d * vq.as_vec();
-              s2 += d * f(q).as_vec();
-              s3 += d;
-            }
+            if constexpr (N == 1)
+              in[i] = static_cast<float>(v);
+            else
+              for (int c = 0; c < N; ++c)
+                in[c * size + i] = static_cast<float>(v[c]);
+            ++i;
           }
-          site_t  new_py = s1 / s3;
-          value_t new_vy = s2 / s3;
-          stop           = (new_py == py);
-          if (not stop)
+        }
+
+        impl::meanshift(in.data(), out.data(), N, f.width(), f.height(), hs, hr, params, parallel);
+
+        mln::image2d<V> res;
+        resize(res, f);
+        {
+          std::size_t i = 0;
+          mln_foreach (auto& v, res.values())
           {
-            double d0 = l2norm_sqr(py - new_py);
-            double d1 = l2norm_sqr(vy - new_vy);
-            stop      = (d0 + d1) < eps2;
-            // if (stop)
-            //  std::cout << "#NITER:" << i << p << new_py << std::endl;
+            if constexpr (N == 1)
+              v = static_cast<V>(out[i]);
+            else
+              for (int c = 0; c < N; ++c)
+                v[c] = static_cast<std::remove_reference_t<decltype(v[c])>>(out[c * size + i]);
+            ++i;
           }
-          py = new_py;
-          vy = new_vy;
         }
-        // std::cout << vy.as_vec() << std::endl;
-        out(p) = (V)vy.as_vec();
+        return res;
       }
-      return out;
+    } // namespace impl
+
+
+    template <class V>
+    mln::image2d<V> meanshift(const mln::image2d<V>& f, float hs, float hr, meanshift_params params)
+    {
+      return impl::meanshift_T(f, hs, hr, params, false);
     }
 
+    namespace parallel
+    {
+      template <class V>
+      mln::image2d<V> meanshift(const mln::image2d<V>& f, float hs, float hr, meanshift_params params)
+      {
+        return impl::meanshift_T(f, hs, hr, params, true);
+      }
+    } // namespace parallel
+
   } // namespace contrib
 
 } // namespace mln
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace mln
+{
+
+  /// \brief Memory resource used for the buffers of the images (ndbuffer_image, bp 2D buffers)
+  ///
+  /// The allocator used by a buffer is captured when the buffer is allocated, the buffer is released to the same
+  /// allocator even if the current allocator has changed in the meantime.
+  class image_allocator
+  {
+  public:
+    /// The alignment of every block returned by the allocators
+    static constexpr std::size_t alignment = 64;
+
+    virtual ~image_allocator() = default;
+
+    /// \brief Allocate \p n bytes aligned on #alignment bytes (throws std::bad_alloc on failure)
+    virtual void* allocate(std::size_t n) = 0;
+
+    /// \brief Release a block of \p n bytes returned by allocate()
+    virtual void deallocate(void* p, std::size_t n) noexcept = 0;
+  };
+
+
+  /// \brief The default allocator (aligned operator new/delete)
+  class default_image_allocator final : public image_allocator
+  {
+  public:
+    void* allocate(std::size_t n) final;
+    void  deallocate(void* p, std::size_t n) noexcept final;
+  };
+
+
+  /// \brief Allocator that keeps the released blocks to serve the next allocations of the same size
+  ///
+  /// The blocks are rounded up to size classes (4 classes per power of two) and kept in a free-list per class. The
+  /// large blocks (≥ 2MiB) are aligned on 2MiB so that they can be backed by huge pages (on Linux, they are advised
+  /// with MADV_HUGEPAGE). When the released blocks exceed \p max_cached_bytes, the blocks of the largest classes are
+  /// freed first. The allocator is thread-safe.
+  class pooled_image_allocator final : public image_allocator
+  {
+  public:
+    struct stats_t
+    {
+      std::size_t hits;         ///< Allocations served from the cache
+      std::size_t misses;       ///< Allocations served by the system
+      std::size_t evictions;    ///< Blocks freed because the cache was full
+      std::size_t cached_bytes; ///< Bytes currently held by the cache
+    };
+
+    explicit pooled_image_allocator(std::size_t max_cached_bytes = std::size_t(512) << 20);
+    ~pooled_image_allocator() final;
+
+    pooled_image_allocator(const pooled_image_allocator&) = delete;
+    pooled_image_allocator& operator=(const pooled_image_allocator&) = delete;
+
+    void* allocate(std::size_t n) final;
+    void  deallocate(void* p, std::size_t n) noexcept final;
+
+    /// \brief Return the counters of the allocator
+    stats_t stats() const;
+
+    /// \brief Free every cached block
+    void release();
+
+  private:
+    void evict(std::size_t target, bool count) noexcept;
+
+    mutable std::mutex              m_mutex;
+    std::vector<std::vector<void*>> m_free; // Free-lists per size class
+    std::size_t                     m_max_cached_bytes;
+    stats_t                         m_stats = {};
+  };
+
+
+  /// \brief Set the allocator used by the new image buffers (the default allocator if \p a is null)
+  ///
+  /// Each thread keeps a copy of the global allocator, refreshed on its next image allocation: the previous allocator
+  /// is released once every thread has allocated an image or exited.
+  void set_image_allocator(std::shared_ptr<image_allocator> a);
+
+  /// \brief Return the allocator used by the new image buffers of the calling thread
+  ///
+  /// This is the allocator of the innermost scoped_image_allocator of the thread if any, the global allocator
+  /// otherwise.
+  std::shared_ptr<image_allocator> get_image_allocator();
+
+
+  /// \brief Override the allocator of the new image buffers for the calling thread during the lifetime of the object
+  ///
+  /// \code
+  /// auto pool = std::make_shared<mln::pooled_image_allocator>();
+  /// {
+  ///   mln::scoped_image_allocator guard(pool);
+  ///   auto out = mln::morpho::dilation(input, se); // Temporaries and output allocated from the pool
+  /// }
+  /// \endcode
+  class scoped_image_allocator
+  {
+  public:
+    explicit scoped_image_allocator(std::shared_ptr<image_allocator> a);
+    ~scoped_image_allocator();
+
+    scoped_image_allocator(const scoped_image_allocator&) = delete;
+    scoped_image_allocator& operator=(const scoped_image_allocator&) = delete;
+
+  private:
+    std::shared_ptr<image_allocator> m_previous;
+  };
+
+} // namespace mln
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mln/core/image/image_allocator.hpp>
+
 #include <cstddef>
 #include <memory>
 
@@ -20,10 +22,12 @@ namespace mln::internal
   template <class T>
   class __ndbuffer_image_data;
 
+  // The buffers are allocated with the current image allocator (see mln::get_image_allocator) which is kept to release
+  // them.
   template <>
   class __ndbuffer_image_data<void> final : public ndbuffer_image_data
   {
-    std::allocator<std::byte> m_allocator;
+    std::shared_ptr<image_allocator> m_allocator;
 
   public:
 
@@ -35,29 +39,33 @@ namespace mln::internal
   template <class T>
   class __ndbuffer_image_data final : public ndbuffer_image_data
   {
-    std::allocator<T> m_allocator;
+    static_assert(alignof(T) <= image_allocator::alignment);
+
+    std::shared_ptr<image_allocator> m_allocator;
 
   public:
 
     /// \param n Number of **elements** to allocate
     __ndbuffer_image_data(std::size_t n)
+      : m_allocator{get_image_allocator()}
     {
       this->m_size   = n;
-      this->m_buffer = reinterpret_cast<std::byte*>(m_allocator.allocate(n));
+      this->m_buffer = static_cast<std::byte*>(m_allocator->allocate(n * sizeof(T)));
       std::uninitialized_default_construct_n(reinterpret_cast<T*>(m_buffer), m_size);
     }
 
     __ndbuffer_image_data(std::size_t n, T val)
+      : m_allocator{get_image_allocator()}
     {
       this->m_size   = n;
-      this->m_buffer = reinterpret_cast<std::byte*>(m_allocator.allocate(n));
+      this->m_buffer = static_cast<std::byte*>(m_allocator->allocate(n * sizeof(T)));
       std::uninitialized_fill_n(reinterpret_cast<T*>(this->m_buffer), m_size, val);
     }
 
     ~__ndbuffer_image_data() final
     {
       std::destroy_n(reinterpret_cast<T*>(this->m_buffer), m_size);
-      m_allocator.deallocate(reinterpret_cast<T*>(this->m_buffer), m_size);
+      m_allocator->deallocate(this->m_buffer, m_size * sizeof(T));
     }
   };
 
@@ -2,6 +2,10 @@
 
 #include <mln/core/config.hpp>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
 #include <string_view>
 
 #define mln_concat(A, B) A##B
@@ -12,26 +16,72 @@
 
 namespace mln::trace
 {
-  extern bool verbose;
+  /// Print the scopes on std::clog (enabled by the environment variable TRACE)
+  extern std::atomic<bool> verbose;
+
+  /// Record the scopes in memory (enabled by the environment variable TRACE_FILE, the recorded trace is then written
+  /// at exit in the file it names)
+  extern std::atomic<bool> recording;
+
+  /// Number of events kept by each thread (the oldest ones are overwritten)
+  constexpr std::size_t kBufferCapacity = 1 << 15;
+
+  /// \brief Return true if the scopes are printed or recorded
+  bool enabled() noexcept;
+
+  /// \brief Enable or disable the recording of the scopes
+  void set_recording(bool enabled);
+
+  /// \brief Write the recorded scopes in the Chrome trace event format (readable by chrome://tracing and Perfetto)
+  ///
+  /// Each thread keeps only its last kBufferCapacity events. The buffer of an exited thread is kept with its events
+  /// and reused by the next new thread, which appends its events under the same tid. The recorded scopes must not be
+  /// running while dumping.
+  void dump(std::ostream& os);
+
+  /// \brief Write the recorded scopes in the file \p filename (throw std::runtime_error if it cannot be opened)
+  void dump(const char* filename);
+
+  /// \brief Discard the recorded scopes
+  void clear();
 
   struct scoped_trace
   {
+    /// \param desc The name of the scope. It is recorded without copy and must outlive the trace (e.g. a literal).
     scoped_trace(std::string_view desc);
     ~scoped_trace();
 
+    scoped_trace(const scoped_trace&) = delete;
+    scoped_trace& operator=(const scoped_trace&) = delete;
+
+    static constexpr int kMaxArgs = 6;
+
+    struct arg_t
+    {
+      const char*  key;
+      std::int64_t value;
+    };
+
   private:
-    struct impl_t;
+    friend struct scope_access;
 
-    [[gnu::noinline]] void entering(std::string_view desc);
+    [[gnu::noinline]] void entering();
     [[gnu::noinline]] void exiting();
 
-    impl_t* m_impl = nullptr;
+    std::string_view m_desc;
+    bool             m_active = false;
+    int              m_depth;
+    int              m_nargs;
+    std::int64_t     m_begin;
+    scoped_trace*    m_parent;
+    arg_t            m_args[kMaxArgs];
   };
 
   namespace impl
   {
     [[gnu::noinline]] void warn(std::string_view msg);
-  }
+    [[gnu::noinline]] void annotate(const char* key, std::int64_t value);
+  } // namespace impl
 
 } // namespace mln::trace
 
@@ -41,22 +91,38 @@ namespace mln::trace
 
 namespace mln::trace
 {
+  // The flags only enable the tracing, they do not synchronize anything
+  inline bool enabled() noexcept
+  {
+    return verbose.load(std::memory_order_relaxed) || recording.load(std::memory_order_relaxed);
+  }
+
   inline scoped_trace::scoped_trace(std::string_view desc)
+    : m_desc{desc}
   {
-    if (verbose)
-      entering(desc);
+    if (enabled())
+      entering();
   }
 
 
   inline scoped_trace::~scoped_trace()
   {
-    if (m_impl)
+    if (m_active)
       exiting();
   }
 
+  /// \brief Print a message in the current scope (a literal when recording, it is recorded without copy)
   inline void warn(std::string_view msg)
   {
-    if (verbose)
+    if (enabled())
       impl::warn(msg);
   }
+
+  /// \brief Attach an integer argument (image size, tile id...) to the innermost scope of the current thread
+  /// \param key The name of the argument (a literal, it is recorded without copy)
+  inline void annotate(const char* key, std::int64_t value)
+  {
+    if (enabled())
+      impl::annotate(key, value);
+  }
 } // namespace mln::trace
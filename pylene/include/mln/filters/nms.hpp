@@ -1,12 +1,20 @@
 #pragma once
 
 
+#include <mln/core/canvas/parallel_local.hpp>
 #include <mln/core/se/rect2d.hpp>
 #include <mln/morpho/dilation.hpp>
 #include <mln/core/algorithm/accumulate.hpp>
 #include <mln/accu/accumulators/max.hpp>
 
+#include <algorithm>
+#include <climits>
 #include <concepts>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 namespace mln::filters
 {
@@ -16,6 +24,9 @@ namespace mln::filters
    * \param min_xdistance The x-size of the NMS window
    * \param min_ydistance The y-size of the NMS window
    * \param min_intensity The minimum intensity of the peak (if null, 0.5 * the max peak used)
+   * \param num_peaks The maximum number of peaks returned (all the peaks if non-positive)
+   * \param nms_image (optional) The dilation of the input by the NMS window
+   * \return The peaks ordered by decreasing value (and by raster order for equal values)
    */
   template <std::totally_ordered T>
   std::vector<point2d> nms(image2d<T>                             input,
@@ -25,64 +36,275 @@ namespace mln::filters
                            int                                    num_peaks     = -1,           //
                            image2d<T>*                            nms_image     = nullptr);
 
+  namespace parallel
+  {
+    /*
+     * \brief Parallel version of mln::filters::nms
+     *
+     * The tiles of the image compute their own top-k peaks that are merged at the end.
+     */
+    template <std::totally_ordered T>
+    std::vector<point2d> nms(image2d<T>                             input,
+                             int                                    min_xdistance,                //
+                             int                                    min_ydistance,                //
+                             std::optional<std::type_identity_t<T>> min_intensity = std::nullopt, //
+                             int                                    num_peaks     = -1,           //
+                             image2d<T>*                            nms_image     = nullptr);
+  } // namespace parallel
+
 
   /******************************************/
   /****          Implementation          ****/
   /******************************************/
 
-  template <std::totally_ordered T>
-  std::vector<point2d> nms(image2d<T> input, int min_xdistance, int min_ydistance,
-                           std::optional<std::type_identity_t<T>> min_intensity, int num_peaks, image2d<T>* nms_image)
+  namespace details
   {
-    auto r   = mln::se::rect2d{min_xdistance, min_ydistance};
-    auto dil = mln::morpho::dilation(input, r);
+    // Size of the blocks summarized by their max value
+    inline constexpr int NMS_BLOCK_SIZE = 16;
 
-    if (num_peaks <= 0)
-      num_peaks = INT_MAX;
+    // Size (in blocks) of the tiles processed by a task
+    inline constexpr int NMS_TILE_SIZE = 8;
 
-    T minv;
-    if (min_intensity.has_value())
+    // Run a function on the tiles of a (block) domain
+    template <class F>
+    class nms_canvas : public ParallelLocalCanvas2DBase
     {
-      minv = min_intensity.value();
-    }
-    else
+    public:
+      nms_canvas(F f)
+        : m_fun(std::move(f))
+      {
+      }
+
+      std::unique_ptr<ParallelLocalCanvas2DBase> clone() const final { return std::make_unique<nms_canvas>(*this); }
+      void                                       ExecuteTile(mln::box2d roi) const final { m_fun(roi); }
+
+    private:
+      F m_fun;
+    };
+
+    template <class F>
+    void nms_execute(mln::box2d roi, bool parallel, F f)
     {
-      minv = 0.5f * mln::accumulate(input, accu::accumulators::max<T>());
+      if (roi.empty())
+        return;
+
+      nms_canvas<F> canvas(std::move(f));
+      canvas.execute(roi, NMS_TILE_SIZE, NMS_TILE_SIZE, parallel);
     }
 
-    auto cmp = [&input](point2d p, point2d q) { return input(p) > input(q); };
 
-    std::vector<point2d> vec;
-    if (num_peaks != INT_MAX)
-      vec.reserve(num_peaks);
+    template <class T>
+    struct nms_peak
+    {
+      T              value;
+      std::ptrdiff_t index; // Raster index, used to order the peaks with the same value
+    };
 
+    // Bounded set of the best peaks (a heap whose front is the worst kept peak)
+    template <class T>
+    class nms_top_k
     {
-      auto zz = mln::ranges::view::zip(input.pixels(), dil.pixels());
-      mln_foreach((auto [px_v, px_m]), zz)
+    public:
+      explicit nms_top_k(std::size_t k)
+        : m_k(k)
       {
-        if (px_v.val() == px_m.val() && px_v.val() >= minv)
+      }
+
+      static bool better(const nms_peak<T>& a, const nms_peak<T>& b)
+      {
+        return a.value > b.value || (a.value == b.value && a.index < b.index);
+      }
+
+      bool full() const { return m_heap.size() >= m_k; }
+
+      // The value below which a peak cannot be kept (only valid if full)
+      const T& threshold() const { return m_heap.front().value; }
+
+      // Whether a peak would be kept
+      bool accept(const nms_peak<T>& p) const { return !full() || better(p, m_heap.front()); }
+
+      void push(const nms_peak<T>& p)
+      {
+        if (!full())
+        {
+          m_heap.push_back(p);
+          std::push_heap(m_heap.begin(), m_heap.end(), better);
+        }
+        else if (better(p, m_heap.front()))
         {
-          if (vec.size() < static_cast<std::size_t>(num_peaks))
+          std::pop_heap(m_heap.begin(), m_heap.end(), better);
+          m_heap.back() = p;
+          std::push_heap(m_heap.begin(), m_heap.end(), better);
+        }
+      }
+
+      // Return the peaks from the best to the worst
+      std::vector<nms_peak<T>> release()
+      {
+        std::sort_heap(m_heap.begin(), m_heap.end(), better);
+        return std::move(m_heap);
+      }
+
+      const std::vector<nms_peak<T>>& peaks() const { return m_heap; }
+
+    private:
+      std::size_t              m_k;
+      std::vector<nms_peak<T>> m_heap;
+    };
+
+
+    /// \brief Non-maximum suppression using block maxima
+    ///
+    /// The image is summarized by the max value of its blocks. The blocks whose max is below the minimum intensity or
+    /// the value of the k-th best peak found so far are skipped; the remaining blocks of a tile are visited by
+    /// decreasing max so that the k-th best value rises quickly. Only the pixels that could enter the top-k are
+    /// checked against their NMS window. The tiles compute their own top-k peaks, merged in a global one.
+    template <class T>
+    std::vector<point2d> nms(image2d<T> input, int min_xdistance, int min_ydistance,
+                             std::optional<std::type_identity_t<T>> min_intensity, int num_peaks,
+                             image2d<T>* nms_image, bool parallel)
+    {
+      constexpr int B = NMS_BLOCK_SIZE;
+
+      if (nms_image)
+        *nms_image = mln::morpho::dilation(input, mln::se::rect2d{min_xdistance, min_ydistance});
+
+      const mln::box2d domain = input.domain();
+      const int        width  = domain.width();
+      const int        height = domain.height();
+      if (domain.empty())
+        return {};
+
+      const int        rx  = min_xdistance / 2;
+      const int        ry  = min_ydistance / 2;
+      const point2d    tl  = domain.tl();
+      const int        nbx = (width + B - 1) / B;
+      const int        nby = (height + B - 1) / B;
+      const mln::box2d blocks(nbx, nby);
+
+      auto row = [&input, tl](int y) { return input.buffer() + (y - tl.y()) * input.stride(1) - tl.x(); };
+
+      // Block maxima
+      std::vector<T> bmax(static_cast<std::size_t>(nbx) * nby);
+      nms_execute(blocks, parallel, [&](mln::box2d roi) {
+        for (int by = roi.y(); by < roi.br().y(); ++by)
+          for (int bx = roi.x(); bx < roi.br().x(); ++bx)
           {
-            vec.push_back(px_v.point());
-            std::push_heap(vec.begin(), vec.end(), cmp);
+            const int x0 = tl.x() + bx * B, x1 = std::min(x0 + B, tl.x() + width);
+            const int y0 = tl.y() + by * B, y1 = std::min(y0 + B, tl.y() + height);
+
+            T m = row(y0)[x0];
+            for (int y = y0; y < y1; ++y)
+            {
+              const T* lineptr = row(y);
+              for (int x = x0; x < x1; ++x)
+                m = std::max(m, lineptr[x]);
+            }
+            bmax[by * nbx + bx] = m;
           }
-          else if (px_v.val() > input(vec[0]))
+      });
+
+      T minv;
+      if (min_intensity.has_value())
+        minv = min_intensity.value();
+      else
+        minv = 0.5f * *std::max_element(bmax.begin(), bmax.end());
+
+      const std::size_t k = (num_peaks <= 0) ? std::numeric_limits<std::size_t>::max()
+                                             : static_cast<std::size_t>(num_peaks);
+
+      // Whether p is the max of its NMS window (clipped to the domain)
+      auto is_window_max = [&](int x, int y, T v) {
+        const int x0 = std::max(x - rx, tl.x()), x1 = std::min(x + rx + 1, tl.x() + width);
+        const int y0 = std::max(y - ry, tl.y()), y1 = std::min(y + ry + 1, tl.y() + height);
+        for (int qy = y0; qy < y1; ++qy)
+        {
+          const T* lineptr = row(qy);
+          for (int qx = x0; qx < x1; ++qx)
+            if (v < lineptr[qx])
+              return false;
+        }
+        return true;
+      };
+
+      nms_top_k<T> result(k);
+      std::mutex   mutex;
+
+      nms_execute(blocks, parallel, [&](mln::box2d roi) {
+        // The blocks of the tile that may contain a peak, by decreasing max
+        std::vector<int> candidates;
+        for (int by = roi.y(); by < roi.br().y(); ++by)
+          for (int bx = roi.x(); bx < roi.br().x(); ++bx)
+            if (!(bmax[by * nbx + bx] < minv))
+              candidates.push_back(by * nbx + bx);
+        if (candidates.empty())
+          return;
+
+        std::sort(candidates.begin(), candidates.end(), [&bmax](int a, int b) { return bmax[b] < bmax[a]; });
+
+        // Start from the k-th best value found by the other tiles
+        std::optional<T> global_threshold;
+        {
+          std::lock_guard lock(mutex);
+          if (result.full())
+            global_threshold = result.threshold();
+        }
+
+        nms_top_k<T> local(k);
+        for (int b : candidates)
+        {
+          const T m = bmax[b];
+          if ((global_threshold && m < *global_threshold) || (local.full() && m < local.threshold()))
+            break;
+
+          const int x0 = tl.x() + (b % nbx) * B, x1 = std::min(x0 + B, tl.x() + width);
+          const int y0 = tl.y() + (b / nbx) * B, y1 = std::min(y0 + B, tl.y() + height);
+          for (int y = y0; y < y1; ++y)
           {
-            std::pop_heap(vec.begin(), vec.end(), cmp);
-            vec.back() = px_v.point();
-            std::push_heap(vec.begin(), vec.end(), cmp);
-          }
+            const T* lineptr = row(y);
+            for (int x = x0; x < x1; ++x)
+            {
+              const T v = lineptr[x];
+              if (v < minv || (global_threshold && v < *global_threshold))
+                continue;
 
+              nms_peak<T> p = {v, static_cast<std::ptrdiff_t>(y - tl.y()) * width + (x - tl.x())};
+              if (local.accept(p) && is_window_max(x, y, v))
+                local.push(p);
+            }
+          }
         }
-      }
+
+        std::lock_guard lock(mutex);
+        for (const auto& p : local.peaks())
+          result.push(p);
+      });
+
+      auto                 peaks = result.release();
+      std::vector<point2d> out(peaks.size());
+      std::transform(peaks.begin(), peaks.end(), out.begin(), [&](const nms_peak<T>& p) {
+        return point2d{tl.x() + static_cast<int>(p.index % width), tl.y() + static_cast<int>(p.index / width)};
+      });
+      return out;
     }
+  } // namespace details
 
-    if (nms_image)
-      *nms_image = std::move(dil);
 
-    std::sort_heap(vec.begin(), vec.end(), cmp);
-    return vec;
+  template <std::totally_ordered T>
+  std::vector<point2d> nms(image2d<T> input, int min_xdistance, int min_ydistance,
+                           std::optional<std::type_identity_t<T>> min_intensity, int num_peaks, image2d<T>* nms_image)
+  {
+    return details::nms(std::move(input), min_xdistance, min_ydistance, min_intensity, num_peaks, nms_image, false);
   }
 
+  namespace parallel
+  {
+    template <std::totally_ordered T>
+    std::vector<point2d> nms(image2d<T> input, int min_xdistance, int min_ydistance,
+                             std::optional<std::type_identity_t<T>> min_intensity, int num_peaks,
+                             image2d<T>* nms_image)
+    {
+      return details::nms(std::move(input), min_xdistance, min_ydistance, min_intensity, num_peaks, nms_image, true);
+    }
+  } // namespace parallel
 }
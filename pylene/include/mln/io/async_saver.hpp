@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mln/core/image/ndimage_fwd.hpp>
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+
+
+namespace mln::io
+{
+
+  /// \brief Save images in the background
+  ///
+  /// The images are encoded and written by a pool of threads while the caller goes on. The saver shares the buffer of
+  /// the image (no copy): the image must not be modified until its save has completed.
+  ///
+  /// The number of bytes of the images waiting or being encoded is bounded: save() blocks until enough pending
+  /// images have been written.
+  ///
+  /// \code
+  /// mln::io::async_saver saver;
+  /// for (...)
+  /// {
+  ///   mln::image2d<uint8_t> out = process(...);
+  ///   saver.save(out, filename);
+  /// }
+  /// saver.wait();
+  /// \endcode
+  class async_saver
+  {
+  public:
+    /// \param max_queued_bytes The maximum number of bytes of the images waiting or being encoded. An image larger than
+    /// this limit is accepted when nothing else is pending.
+    /// \param nthreads The number of encoding threads (if non-positive, the number of hardware threads)
+    explicit async_saver(std::size_t max_queued_bytes = std::size_t(256) << 20, int nthreads = 0);
+
+    /// Wait for all the pending saves
+    ~async_saver();
+
+    async_saver(const async_saver&) = delete;
+    async_saver& operator=(const async_saver&) = delete;
+
+    /// \brief Schedule the saving of \p image to \p filename
+    ///
+    /// \return A future that becomes ready when the file is written. It holds the exception raised by the encoding,
+    /// if any.
+    std::future<void> save(mln::ndbuffer_image image, std::string filename);
+
+    /// Wait for all the pending saves
+    void wait();
+
+    /// The number of bytes of the images waiting or being encoded
+    std::size_t queued_bytes() const;
+
+  private:
+    struct impl_t;
+
+    std::unique_ptr<impl_t> m_impl;
+  };
+
+} // namespace mln::io
@@ -1,10 +1,65 @@
 #pragma once
 
+#include <mln/core/box.hpp>
 #include <mln/core/image/ndimage_fwd.hpp>
+
+#include <memory>
 #include <string>
 
 namespace mln::io::fits
 {
+    namespace internal
+    {
+      class cfitsio_reader_plugin;
+    }
+
+
     mln::ndbuffer_image imread(const std::string& filename, int ind=0);
     void                imread(const std::string& filename, mln::ndbuffer_image& out, int ind=0);
-}
\ No newline at end of file
+
+    /// \brief Read the region \p roi of the image
+    ///
+    /// Only the pixels of the region are read (and decompressed for the tile-compressed images). The result has the
+    /// domain \p roi (in image coordinates).
+    ///
+    /// \param filename The FITS file
+    /// \param roi The region to read. It must have the dimension of the image and be included in its domain.
+    /// \param ind The index of the HDU
+    /// \exception std::runtime_error if the region is not valid or the file cannot be read
+    mln::ndbuffer_image imread(const std::string& filename, mln::ConstBoxRef roi, int ind = 0);
+    void                imread(const std::string& filename, mln::ConstBoxRef roi, mln::ndbuffer_image& out, int ind = 0);
+
+
+    /// \brief Read an image by strips along its last axis (rows of a 2D image, slices of a 3D image...)
+    ///
+    /// The file is kept open between the strips. The buffer of the output is reused when the strips have the same
+    /// size.
+    ///
+    /// \code
+    /// mln::io::fits::strip_reader reader(filename, 16);
+    /// mln::ndbuffer_image         strip;
+    /// while (reader.next(strip))
+    ///   process(strip);
+    /// \endcode
+    class strip_reader
+    {
+    public:
+      /// \param filename The FITS file
+      /// \param strip_size The number of slices (along the last axis) of a strip
+      /// \param ind The index of the HDU
+      strip_reader(const std::string& filename, int strip_size, int ind = 0);
+      ~strip_reader();
+
+      /// \brief Read the next strip in \p out (its domain is the strip box, in image coordinates)
+      /// \return false if the whole image has been read (\p out is left unchanged)
+      bool next(mln::ndbuffer_image& out);
+
+      /// The domain of the whole image
+      mln::Box domain() const;
+
+    private:
+      std::unique_ptr<internal::cfitsio_reader_plugin> m_plugin;
+      int                                              m_strip_size;
+      int                                              m_next = 0; // Index of the next slice to read
+    };
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <mln/core/image/ndimage_fwd.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <span>
 #include <string>
 
 
@@ -9,4 +13,20 @@ namespace mln::io
   mln::ndbuffer_image imread(const std::string& filename);
   void                imread(const std::string& filename, mln::ndbuffer_image& out);
 
+
+  /// \brief Read a list of images with a pool of workers
+  ///
+  /// The files are decoded concurrently while the callback processes the images already read. The callback is called
+  /// once per file, in the order of \p paths, and never concurrently. The image passed to the callback is only valid
+  /// during the call: its buffer is recycled to decode a next file of the same size (unless the callback keeps a copy
+  /// of the image, in which case a new buffer is allocated).
+  ///
+  /// \param paths The filenames of the images
+  /// \param callback The function called with the index of the file in \p paths and the image
+  /// \param max_in_flight The maximum number of images being decoded or waiting for the callback (if non-positive, the
+  /// number of hardware threads)
+  /// \exception std::runtime_error if a file cannot be read (the remaining files are not processed)
+  void imread_batch(std::span<const std::string>                                  paths,
+                    const std::function<void(std::size_t, mln::ndbuffer_image&)>& callback, int max_in_flight = 0);
+
 } // namespace mln::io
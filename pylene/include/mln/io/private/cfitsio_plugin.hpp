@@ -1,7 +1,10 @@
 #pragma once
 
+#include <mln/core/box.hpp>
 #include <mln/io/private/plugin.hpp>
 
+#include <optional>
+
 namespace mln::io::fits::internal
 {
   class cfitsio_reader_plugin final : public mln::io::internal::plugin_reader
@@ -9,11 +12,23 @@ namespace mln::io::fits::internal
   public:
     cfitsio_reader_plugin() = delete;
     cfitsio_reader_plugin(int ind);
+
+    /// Read only the region \p roi of the image (in image coordinates)
+    cfitsio_reader_plugin(int ind, mln::ConstBoxRef roi);
+
     ~cfitsio_reader_plugin() final;
     void open(const char* filename) final;
     void close() final;
 
+    /// Restrict the next reads to the region \p roi of the opened image. The dimensions returned by the plugin become
+    /// the ones of the region.
+    void select(mln::ConstBoxRef roi);
+
+    /// The domain of the whole image (once opened)
+    mln::Box image_domain() const;
+
   private:
-    const int m_image_index;
+    const int               m_image_index;
+    std::optional<mln::Box> m_roi;
   };
-} // namespace mln::io::fist::internal
\ No newline at end of file
+} // namespace mln::io::fist::internal
@@ -25,7 +25,11 @@ namespace mln::io::internal
 
 
   // Generic ndimension algorithm for buffer encoded image
-  void load(plugin_reader* p, const char* filename, mln::ndbuffer_image& output);
+  // If recycle is true, output is only a storage to reuse: it gets the sample type and the dimension of the file
+  // instead of raising a mismatch error.
+  void load(plugin_reader* p, const char* filename, mln::ndbuffer_image& output, bool recycle = false);
+  // Same as load, with a plugin already opened (the plugin is not closed)
+  void read(plugin_reader* p, mln::ndbuffer_image& output, bool recycle = false);
   void save(const mln::ndbuffer_image& input, plugin_writer* p, const char* filename);
 }
 
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "plugin.hpp"
+
+namespace mln::io::internal
+{
+
+  /// \brief Reader for the binary PNM files (P4, P5, P6) that does not need FreeImage
+  ///
+  /// The lines are read from the file straight into the destination buffer, the samples are not rescaled. The
+  /// supported formats are:
+  /// * P4 (bitmap) as bool
+  /// * P5 (graymap) as uint8 (maxval 255) or uint16 (maxval 65535)
+  /// * P6 (pixmap) as rgb8 (maxval 255)
+  class pnm_reader_plugin final : public plugin_reader
+  {
+  public:
+    ~pnm_reader_plugin() final;
+    void open(const char* filename) final;
+    void close() final;
+
+    /// \brief Return true if the file is a binary PNM file supported by this reader
+    static bool can_read(const char* filename);
+  };
+
+}
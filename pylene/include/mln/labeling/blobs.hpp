@@ -1,11 +1,19 @@
 #pragma once
 
 
+#include <mln/core/box.hpp>
 #include <mln/core/extension/fill.hpp>
 #include <mln/core/image/image.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/image_format.hpp>
+#include <mln/core/neighborhood/c4.hpp>
+#include <mln/core/neighborhood/c8.hpp>
 #include <mln/core/range/foreach.hpp>
 #include <mln/core/trace.hpp>
 
+#include <algorithm>
+#include <climits>
+#include <cstddef>
 #include <type_traits>
 #include <vector>
 
@@ -13,10 +21,37 @@
 namespace mln::labeling
 {
 
+  /// \brief Geometric attributes of a blob
+  struct blob_attributes
+  {
+    std::size_t area = 0;       // Number of pixels
+    mln::box2d  bbox;           // Bounding box
+    float       centroid_x = 0; // Centroid (x coordinate)
+    float       centroid_y = 0; // Centroid (y coordinate)
+  };
+
+
   /// \brief labelize connected components of a binary image ima.
   template <typename Label, class I, class N>
   image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel);
 
+  /// \brief labelize connected components of a binary 2D image ima and compute the attributes of each blob.
+  ///
+  /// \p attributes is resized to nlabel + 1 (the entry 0 of the background is left empty)
+  template <typename Label, class I, class N>
+  image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel, std::vector<blob_attributes>& attributes);
+
+
+  namespace parallel
+  {
+    /// \brief labelize connected components of a binary image ima (the image is processed by strips in parallel)
+    template <typename Label, class I, class N>
+    image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel);
+
+    template <typename Label, class I, class N>
+    image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel, std::vector<blob_attributes>& attributes);
+  } // namespace parallel
+
 
   /******************************************/
   /****          Implementation          ****/
@@ -114,6 +149,112 @@ namespace mln::labeling
       }
       return nlabel;
     }
+
+    /// \brief Run-based union-find labeling of a 2D binary buffer (bool, uint8 or int8).
+    ///
+    /// The runs of each strip of rows are extracted and merged independently (in parallel if \p parallel is set),
+    /// the strips are then merged along their boundaries. Each set keeps the run with the smallest index as root, so
+    /// the labels are assigned in raster order of the first pixel of each component, exactly as the queue-based
+    /// implementations do.
+    ///
+    /// \param output The label image (int8, uint8, int16, uint16 or int32) with the same domain as the input
+    /// \param attributes If not null, the attributes of each blob are computed from the runs
+    /// \return The number of labels
+    int blobs_runs2d(const mln::ndbuffer_image& input, mln::ndbuffer_image& output, bool c8, bool parallel,
+                     std::vector<blob_attributes>* attributes);
+
+
+    // Whether the run-based implementation handles the given input/neighborhood/label types
+    template <class I, class N, class Label>
+    constexpr bool has_runs2d_implementation()
+    {
+      using V = image_value_t<I>;
+
+      constexpr auto lbl = sample_type_traits<Label>::id();
+
+      return std::is_same_v<I, mln::image2d<V>> &&
+             (std::is_same_v<V, bool> || std::is_same_v<V, std::uint8_t> || std::is_same_v<V, std::int8_t>) &&
+             (std::is_same_v<N, mln::c4_t> || std::is_same_v<N, mln::c8_t>) &&
+             (lbl == sample_type_id::INT8 || lbl == sample_type_id::UINT8 || lbl == sample_type_id::INT16 ||
+              lbl == sample_type_id::UINT16 || lbl == sample_type_id::INT32);
+    }
+
+    template <class O>
+    void blobs_attributes(O& out, int nlabel, std::vector<blob_attributes>& attributes)
+    {
+      struct acc_t
+      {
+        std::size_t count = 0;
+        double      sx = 0, sy = 0;
+        int         x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+      };
+      std::vector<acc_t> acc(nlabel + 1);
+
+      mln_foreach (auto px, out.pixels())
+      {
+        int lbl = px.val();
+        if (lbl == 0)
+          continue;
+
+        auto  p = px.point();
+        auto& a = acc[lbl];
+        a.count++;
+        a.sx += p.x();
+        a.sy += p.y();
+        a.x0 = std::min(a.x0, static_cast<int>(p.x()));
+        a.y0 = std::min(a.y0, static_cast<int>(p.y()));
+        a.x1 = std::max(a.x1, static_cast<int>(p.x()));
+        a.y1 = std::max(a.y1, static_cast<int>(p.y()));
+      }
+
+      attributes.assign(nlabel + 1, blob_attributes{});
+      for (int i = 1; i <= nlabel; ++i)
+      {
+        const auto& a = acc[i];
+        attributes[i] = blob_attributes{.area       = a.count,
+                                        .bbox       = mln::box2d(a.x0, a.y0, a.x1 - a.x0 + 1, a.y1 - a.y0 + 1),
+                                        .centroid_x = static_cast<float>(a.sx / a.count),
+                                        .centroid_y = static_cast<float>(a.sy / a.count)};
+      }
+    }
+
+    template <typename Label, class I, class N>
+    image_ch_value_t<I, Label> blobs(I& ima, [[maybe_unused]] N nbh, int& nlabel, bool parallel,
+                                     [[maybe_unused]] std::vector<blob_attributes>* attributes)
+    {
+      static_assert(mln::is_a<I, mln::details::Image>());
+      static_assert(std::is_convertible<image_value_t<I>, bool>::value, "Only supports binary image (type: bool)");
+      static_assert(std::is_integral_v<Label>, "Label value should be integral");
+      static_assert((std::is_signed_v<Label> && sizeof(Label) <= sizeof(int)) ||
+                    (std::is_unsigned_v<Label> && sizeof(Label) < sizeof(int)));
+
+      if constexpr (has_runs2d_implementation<I, N, Label>())
+      {
+        mln_entering("mln::labeling::blobs (runs)");
+
+        image_ch_value_t<I, Label> out = imchvalue<Label>(ima);
+        mln::ndbuffer_image        tmp = out;
+        nlabel = impl::blobs_runs2d(ima, tmp, std::is_same_v<N, mln::c8_t>, parallel, attributes);
+        return out;
+      }
+      else
+      {
+        image_build_error_code     status;
+        image_ch_value_t<I, Label> out = imchvalue<Label>(ima)
+                                             .adjust(nbh)       //
+                                             .set_init_value(0) //
+                                             .get_status(&status);
+        if (status == IMAGE_BUILD_OK)
+          nlabel = impl::blobs_no_boundcheck(ima, nbh, out);
+        else
+          nlabel = impl::blobs_boundcheck(ima, nbh, out);
+
+        if constexpr (std::is_same_v<image_domain_t<I>, mln::box2d>)
+          if (attributes)
+            impl::blobs_attributes(out, nlabel, *attributes);
+        return out;
+      }
+    }
   } // namespace impl
 
 
@@ -121,24 +262,31 @@ namespace mln::labeling
   template <typename Label, class I, class N>
   [[gnu::noinline]] image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel)
   {
-    static_assert(mln::is_a<I, mln::details::Image>());
-    static_assert(std::is_convertible<image_value_t<I>, bool>::value, "Only supports binary image (type: bool)");
-    static_assert(std::is_integral_v<Label>, "Label value should be integral");
-    static_assert((std::is_signed_v<Label> && sizeof(Label) <= sizeof(int)) ||
-                  (std::is_unsigned_v<Label> && sizeof(Label) < sizeof(int)));
-
-    image_build_error_code     status;
-    image_ch_value_t<I, Label> out = imchvalue<Label>(ima)
-                                         .adjust(nbh)       //
-                                         .set_init_value(0) //
-                                         .get_status(&status);
-    if (status == IMAGE_BUILD_OK)
-      nlabel = impl::blobs_no_boundcheck(ima, nbh, out);
-    else
-      nlabel = impl::blobs_boundcheck(ima, nbh, out);
-
-    return out;
+    return impl::blobs<Label>(ima, nbh, nlabel, false, nullptr);
   }
 
+  template <typename Label, class I, class N>
+  image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel, std::vector<blob_attributes>& attributes)
+  {
+    static_assert(std::is_same_v<image_domain_t<I>, mln::box2d>, "Blob attributes are only available in 2D");
+    return impl::blobs<Label>(ima, nbh, nlabel, false, &attributes);
+  }
+
+  namespace parallel
+  {
+    template <typename Label, class I, class N>
+    image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel)
+    {
+      return impl::blobs<Label>(ima, nbh, nlabel, true, nullptr);
+    }
+
+    template <typename Label, class I, class N>
+    image_ch_value_t<I, Label> blobs(I ima, N nbh, int& nlabel, std::vector<blob_attributes>& attributes)
+    {
+      static_assert(std::is_same_v<image_domain_t<I>, mln::box2d>, "Blob attributes are only available in 2D");
+      return impl::blobs<Label>(ima, nbh, nlabel, true, &attributes);
+    }
+  } // namespace parallel
+
 
 } // namespace mln::labeling
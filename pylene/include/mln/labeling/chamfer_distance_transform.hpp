@@ -4,14 +4,21 @@
 #include <mln/core/concepts/neighborhood.hpp>
 #include <mln/core/extension/fill.hpp>
 #include <mln/core/image/image.hpp>
+#include <mln/core/image/ndimage.hpp>
 #include <mln/core/image/view/value_extended.hpp>
+#include <mln/core/neighborhood/c4.hpp>
+#include <mln/core/neighborhood/c8.hpp>
 #include <mln/core/neighborhood/neighborhood.hpp>
 #include <mln/core/range/foreach.hpp>
 #include <mln/core/range/view/reverse.hpp>
 #include <mln/core/range/view/zip.hpp>
+#include <mln/core/se/mask2d.hpp>
 #include <mln/core/trace.hpp>
 
+#include <cstdint>
 #include <limits>
+#include <span>
+#include <vector>
 
 
 namespace mln::labeling
@@ -21,6 +28,17 @@ namespace mln::labeling
   image_ch_value_t<std::remove_reference_t<InputImage>, DistanceType> //
   chamfer_distance_transform(InputImage&& f, Neighborhood&& nbh, bool background_is_object = false);
 
+  namespace parallel
+  {
+    /// \brief Parallel version of mln::labeling::chamfer_distance_transform
+    ///
+    /// For 2D buffer images with a 2D weighted mask, the rows are pipelined across threads in a wavefront. Otherwise,
+    /// it falls back to the sequential version.
+    template <typename DistanceType = int, class InputImage, class Neighborhood>
+    image_ch_value_t<std::remove_reference_t<InputImage>, DistanceType> //
+    chamfer_distance_transform(InputImage&& f, Neighborhood&& nbh, bool background_is_object = false);
+  } // namespace parallel
+
   /**********************************/
   /**   Implementation            ***/
   /**********************************/
@@ -45,6 +63,64 @@ namespace mln::labeling
 
   namespace impl
   {
+    struct chamfer_weight2d
+    {
+      int    dx;
+      int    dy;
+      double w;
+    };
+
+    /// \brief Chamfer distance transform of 2D buffer images
+    ///
+    /// Each row is processed in two steps: the dependencies on the previous rows (next rows for the backward scan)
+    /// are computed with simd min-plus over the whole row, then the dependencies in the row are propagated
+    /// sequentially. In parallel, the image is processed by skewed tiles scheduled in a wavefront.
+    ///
+    /// \param output The output image whose extension is filled with the outside value
+    /// \return false if the images, the weights or the extension of the output are not supported (nothing is done)
+    bool chamfer_distance_transform_2d(const mln::ndbuffer_image& input, std::span<const chamfer_weight2d> weights,
+                                       mln::ndbuffer_image& output, bool parallel);
+
+    template <class N>
+    struct is_wmask2d : std::false_type
+    {
+    };
+
+    template <class W>
+    struct is_wmask2d<mln::se::wmask2d<W>> : std::true_type
+    {
+    };
+
+    template <class I, class N, class DistanceType>
+    constexpr bool has_chamfer_distance_transform_2d_implementation()
+    {
+      using V = image_value_t<I>;
+
+      constexpr bool is_image2d = std::is_same_v<I, mln::image2d<V>>;
+      constexpr bool is_nbh2d   = std::is_same_v<N, mln::c4_t> || std::is_same_v<N, mln::c8_t> || is_wmask2d<N>::value;
+      constexpr bool is_dist =
+          std::is_same_v<DistanceType, std::uint8_t> || std::is_same_v<DistanceType, std::int8_t> ||
+          std::is_same_v<DistanceType, std::uint16_t> || std::is_same_v<DistanceType, std::int16_t> ||
+          std::is_same_v<DistanceType, std::uint32_t> || std::is_same_v<DistanceType, std::int32_t> ||
+          std::is_same_v<DistanceType, float> || std::is_same_v<DistanceType, double>;
+
+      return is_image2d && (std::is_same_v<V, bool> || std::is_integral_v<V>) && is_nbh2d && is_dist;
+    }
+
+    template <class N>
+    std::vector<chamfer_weight2d> chamfer_weights_2d(const N& nbh)
+    {
+      std::vector<chamfer_weight2d> weights;
+      for (auto q : nbh.offsets())
+      {
+        if constexpr (std::is_same_v<N, mln::c4_t> || std::is_same_v<N, mln::c8_t>)
+          weights.push_back({static_cast<int>(q.x()), static_cast<int>(q.y()), 1.0});
+        else
+          weights.push_back({static_cast<int>(q.p.x()), static_cast<int>(q.p.y()), static_cast<double>(q.w)});
+      }
+      return weights;
+    }
+
     template <class I, class N, class O, class SumOp>
     void chamfer_distance_transform(I input, N nbh, O output, SumOp add)
     {
@@ -92,40 +168,68 @@ namespace mln::labeling
         }
       }
     }
-  } // namespace impl
 
-  template <typename DistanceType, class InputImage, class Neighborhood>
-  image_ch_value_t<std::remove_reference_t<InputImage>, DistanceType> //
-  chamfer_distance_transform(InputImage&& f, Neighborhood&& nbh, bool background_is_object)
-  {
-    using I = std::remove_reference_t<InputImage>;
-    using N = std::remove_reference_t<Neighborhood>;
+    template <typename DistanceType, class InputImage, class Neighborhood>
+    image_ch_value_t<std::remove_reference_t<InputImage>, DistanceType> //
+    chamfer_distance_transform_dispatch(InputImage&& f, Neighborhood&& nbh, bool background_is_object, bool parallel)
+    {
+      using I = std::remove_reference_t<InputImage>;
+      using N = std::remove_reference_t<Neighborhood>;
 
-    static_assert(mln::is_a<I, mln::details::Image>());
-    static_assert(mln::is_a<N, mln::details::Neighborhood>());
+      static_assert(mln::is_a<I, mln::details::Image>());
+      static_assert(mln::is_a<N, mln::details::Neighborhood>());
 
-    image_build_error_code err = IMAGE_BUILD_OK;
+      image_build_error_code err = IMAGE_BUILD_OK;
 
-    auto out = imchvalue<DistanceType>(f) //
-                   .adjust(nbh)
-                   .get_status(&err)
-                   .build();
+      auto out = imchvalue<DistanceType>(f) //
+                     .adjust(nbh)
+                     .get_status(&err)
+                     .build();
 
-    DistanceType vfill = (background_is_object) ? std::numeric_limits<DistanceType>::max() : 0;
+      DistanceType vfill = (background_is_object) ? std::numeric_limits<DistanceType>::max() : 0;
 
 
-    if (err == IMAGE_BUILD_OK)
-    {
-      mln::extension::try_fill(out, vfill);
-      impl::chamfer_distance_transform(f, nbh, out, internal::add_saturate<DistanceType>{});
-    }
-    else
-    {
-      auto output = mln::view::value_extended(out, vfill);
-      impl::chamfer_distance_transform(f, nbh, output, internal::add_saturate<DistanceType>{});
+      if (err == IMAGE_BUILD_OK)
+      {
+        mln::extension::try_fill(out, vfill);
+
+        if constexpr (has_chamfer_distance_transform_2d_implementation<std::remove_cv_t<I>, std::remove_cv_t<N>,
+                                                                       DistanceType>())
+        {
+          if (chamfer_distance_transform_2d(f, chamfer_weights_2d(nbh), out, parallel))
+            return out;
+        }
+        impl::chamfer_distance_transform(f, nbh, out, internal::add_saturate<DistanceType>{});
+      }
+      else
+      {
+        auto output = mln::view::value_extended(out, vfill);
+        impl::chamfer_distance_transform(f, nbh, output, internal::add_saturate<DistanceType>{});
+      }
+
+      return out;
     }
+  } // namespace impl
 
-    return out;
+  template <typename DistanceType, class InputImage, class Neighborhood>
+  image_ch_value_t<std::remove_reference_t<InputImage>, DistanceType> //
+  chamfer_distance_transform(InputImage&& f, Neighborhood&& nbh, bool background_is_object)
+  {
+    return impl::chamfer_distance_transform_dispatch<DistanceType>(std::forward<InputImage>(f),
+                                                                   std::forward<Neighborhood>(nbh), background_is_object,
+                                                                   false);
   }
 
+  namespace parallel
+  {
+    template <typename DistanceType, class InputImage, class Neighborhood>
+    image_ch_value_t<std::remove_reference_t<InputImage>, DistanceType> //
+    chamfer_distance_transform(InputImage&& f, Neighborhood&& nbh, bool background_is_object)
+    {
+      return impl::chamfer_distance_transform_dispatch<DistanceType>(std::forward<InputImage>(f),
+                                                                     std::forward<Neighborhood>(nbh),
+                                                                     background_is_object, true);
+    }
+  } // namespace parallel
+
 } // namespace mln::labeling::
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mln/core/image/ndimage.hpp>
+
+#include <span>
+
+
+namespace mln::labeling
+{
+
+  ///
+  /// @brief Compute the exact squared Euclidean distance transform of a binary image
+  ///
+  /// Each foreground pixel gets the squared distance to the closest background pixel (background pixels get 0). The
+  /// outside of the domain is ignored: if the image has no background pixel, the distances are +∞.
+  ///
+  /// @param input The input binary image (2D or 3D)
+  /// @param spacing (optional) The size of the pixels along each axis (x, y[, z]) for anisotropic grids. Unit size if empty.
+  /// @return The squared distance image
+  image2d<float> squared_euclidean_distance_transform(const image2d<bool>& input, std::span<const float> spacing = {});
+  image3d<float> squared_euclidean_distance_transform(const image3d<bool>& input, std::span<const float> spacing = {});
+
+  ///
+  /// @brief Compute the Euclidean feature transform of a binary image
+  ///
+  /// Each pixel gets the coordinates of the closest background pixel (background pixels get their own coordinates).
+  /// The result is unspecified if the image has no background pixel.
+  ///
+  /// @param input The input binary image (2D or 3D)
+  /// @param spacing (optional) The size of the pixels along each axis (x, y[, z]) for anisotropic grids. Unit size if empty.
+  /// @param sqdist (optional) If not null, the squared distance transform is stored in this image
+  /// @return The image of the closest background points
+  image2d<point2d> euclidean_feature_transform(const image2d<bool>& input, std::span<const float> spacing = {},
+                                               image2d<float>* sqdist = nullptr);
+  image3d<point3d> euclidean_feature_transform(const image3d<bool>& input, std::span<const float> spacing = {},
+                                               image3d<float>* sqdist = nullptr);
+
+
+  namespace parallel
+  {
+    /// @brief Parallel version of mln::labeling::squared_euclidean_distance_transform
+    ///
+    /// The separable 1D passes are processed line-wise in parallel.
+    image2d<float> squared_euclidean_distance_transform(const image2d<bool>& input, std::span<const float> spacing = {});
+    image3d<float> squared_euclidean_distance_transform(const image3d<bool>& input, std::span<const float> spacing = {});
+
+    /// @brief Parallel version of mln::labeling::euclidean_feature_transform
+    image2d<point2d> euclidean_feature_transform(const image2d<bool>& input, std::span<const float> spacing = {},
+                                                 image2d<float>* sqdist = nullptr);
+    image3d<point3d> euclidean_feature_transform(const image3d<bool>& input, std::span<const float> spacing = {},
+                                                 image3d<float>* sqdist = nullptr);
+  } // namespace parallel
+
+} // namespace mln::labeling
@@ -6,6 +6,7 @@
 
 #include <mln/core/algorithm/for_each.hpp>
 #include <mln/core/functional_ops.hpp>
+#include <mln/core/trace.hpp>
 #include <mln/morpho/canvas/unionfind.hpp>
 #include <mln/morpho/component_tree.hpp>
 
@@ -346,6 +347,9 @@ namespace mln::morpho
   std::pair<component_tree<std::invoke_result_t<F, image_value_t<I>, image_value_t<I>>>, image_ch_value_t<I, int>> //
   alphatree(I input, N nbh, F distance)
   {
+    mln_entering("mln::morpho::alphatree");
+    mln::trace::annotate("pixels", input.domain().size());
+
     return internal::__alphatree(input, nbh, distance);
   }
 
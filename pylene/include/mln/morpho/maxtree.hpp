@@ -138,6 +138,7 @@ namespace mln::morpho
   maxtree(I input, N nbh)
   {
     mln_entering("mln::morpho::maxtree");
+    mln::trace::annotate("pixels", input.domain().size());
 
     using V = image_value_t<I>;
     constexpr std::size_t kStackReserve = 256;
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <mln/core/assert.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace mln::morpho::details
+{
+
+  /// \brief Set of integers in [0, n) with a fast search of the closest element above or below a value
+  ///
+  /// The elements are bits of 64-bit words. Each layer summarizes the previous one with a bit per non-zero word, up
+  /// to a single word, so that insert, erase, next and prev take O(log₆₄ n) word operations.
+  class bitset_tree
+  {
+  public:
+    bitset_tree() = default;
+
+    /// \param n The size of the universe [0, n)
+    explicit bitset_tree(std::size_t n);
+
+    void insert(std::size_t i) noexcept;
+    void erase(std::size_t i) noexcept;
+    bool contains(std::size_t i) const noexcept;
+
+    /// \brief Return the smallest element ≥ i (-1 if there is none)
+    std::ptrdiff_t next(std::size_t i) const noexcept;
+
+    /// \brief Return the largest element ≤ i (-1 if there is none)
+    std::ptrdiff_t prev(std::size_t i) const noexcept;
+
+  private:
+    static constexpr std::uint64_t bit(std::size_t i) noexcept { return std::uint64_t(1) << (i & 63); }
+
+    std::size_t                             m_size = 0;
+    std::vector<std::vector<std::uint64_t>> m_layers; // m_layers[0] holds the elements
+  };
+
+
+  /******************************************/
+  /****          Implementation          ****/
+  /******************************************/
+
+  inline bitset_tree::bitset_tree(std::size_t n)
+    : m_size{n}
+  {
+    std::size_t nwords = (n + 63) / 64;
+    do
+    {
+      nwords = std::max<std::size_t>(nwords, 1);
+      m_layers.emplace_back(nwords, 0);
+      nwords = (nwords + 63) / 64;
+    } while (m_layers.back().size() > 1);
+  }
+
+  inline void bitset_tree::insert(std::size_t i) noexcept
+  {
+    mln_precondition(i < m_size);
+    for (auto& layer : m_layers)
+    {
+      std::uint64_t& w     = layer[i >> 6];
+      bool           empty = (w == 0);
+      w |= bit(i);
+      if (!empty) // The upper layers already know this word
+        break;
+      i >>= 6;
+    }
+  }
+
+  inline void bitset_tree::erase(std::size_t i) noexcept
+  {
+    mln_precondition(i < m_size);
+    for (auto& layer : m_layers)
+    {
+      std::uint64_t& w = layer[i >> 6];
+      w &= ~bit(i);
+      if (w != 0)
+        break;
+      i >>= 6;
+    }
+  }
+
+  inline bool bitset_tree::contains(std::size_t i) const noexcept
+  {
+    return i < m_size && (m_layers[0][i >> 6] & bit(i)) != 0;
+  }
+
+  inline std::ptrdiff_t bitset_tree::next(std::size_t i) const noexcept
+  {
+    // Go up until a word has a bit at or after i
+    std::size_t k = 0;
+    for (;; ++k)
+    {
+      if (k == m_layers.size() || (i >> 6) >= m_layers[k].size())
+        return -1;
+
+      std::uint64_t w = m_layers[k][i >> 6] & (~std::uint64_t(0) << (i & 63));
+      if (w != 0)
+      {
+        i = (i & ~std::size_t(63)) + std::countr_zero(w);
+        break;
+      }
+      i = (i >> 6) + 1;
+    }
+
+    // Go down following the first bit
+    while (k-- > 0)
+      i = (i << 6) + std::countr_zero(m_layers[k][i]);
+    return static_cast<std::ptrdiff_t>(i);
+  }
+
+  inline std::ptrdiff_t bitset_tree::prev(std::size_t i) const noexcept
+  {
+    if (m_size == 0)
+      return -1;
+    if (i >= m_size)
+      i = m_size - 1;
+
+    // Go up until a word has a bit at or before i
+    std::size_t k = 0;
+    for (;; ++k)
+    {
+      if (k == m_layers.size())
+        return -1;
+
+      std::uint64_t w = m_layers[k][i >> 6] & (~std::uint64_t(0) >> (63 - (i & 63)));
+      if (w != 0)
+      {
+        i = (i & ~std::size_t(63)) + 63 - std::countl_zero(w);
+        break;
+      }
+      if ((i >> 6) == 0)
+        return -1;
+      i = (i >> 6) - 1;
+    }
+
+    // Go down following the last bit
+    while (k-- > 0)
+      i = (i << 6) + 63 - std::countl_zero(m_layers[k][i]);
+    return static_cast<std::ptrdiff_t>(i);
+  }
+
+} // namespace mln::morpho::details
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mln/core/algorithm/transform.hpp>
 #include <mln/core/concepts/image.hpp>
 #include <mln/morpho/private/immersion.spe.hpp>
 #include <mln/core/trace.hpp>
@@ -29,6 +30,18 @@ namespace mln::morpho::details
   immersion(I ima);
 
 
+  /// \brief Immerse a 2d or 3d image into twice-as-big interval-valued image
+  ///
+  /// Same as immersion() but the bounds [inf, sup] of the intervals are interleaved in a single image, as read by the
+  /// propagation.
+  ///
+  /// \param[in] ima The input image
+  /// \return An intervaled valued image
+  template <class I>
+  image_ch_value_t<I, irange<image_value_t<I>>> //
+  interval_immersion(I ima);
+
+
   /******************************************/
   /****          Implementation          ****/
   /******************************************/
@@ -169,4 +182,60 @@ namespace mln::morpho::details
     return { std::move(inf), std::move(sup) };
   }
 
+
+  namespace impl
+  {
+    // For 2d-buffer images
+    template <class T>
+    void interval_immersion(mln::image2d<T>& f, mln::image2d<irange<T>>& out)
+    {
+      mln_entering("mln::morpho::details::interval_immersion (2d-buffer)");
+      interval_immersion_impl_table_t<T> impl;
+      interval_immersion_ndimage(f, out, &impl);
+    }
+
+    // For 3d-buffer images
+    template <class T>
+    void interval_immersion(mln::image3d<T>& f, mln::image3d<irange<T>>& out)
+    {
+      mln_entering("mln::morpho::details::interval_immersion (3d-buffer)");
+      interval_immersion_impl_table_t<T> impl;
+      interval_immersion_ndimage(f, out, &impl);
+    }
+
+    // Fallback: immersion then zip of the bounds
+    template <class I, class J>
+    void interval_immersion(mln::details::Image<I>& f, J& out)
+    {
+      mln_entering("mln::morpho::details::interval_immersion (generic)");
+      using V = image_value_t<I>;
+
+      auto [inf, sup] = details::immersion(static_cast<I&>(f));
+      mln::transform(inf, sup, out, [](V a, V b) -> irange<V> { return {a, b}; });
+    }
+  } // namespace impl
+
+  template <class I>
+  image_ch_value_t<I, irange<image_value_t<I>>> //
+  interval_immersion(I ima)
+  {
+    static_assert(mln::is_a<I, mln::details::Image>());
+    static_assert(std::is_same_v<image_domain_t<I>, mln::box2d> ||
+                  std::is_same_v<image_domain_t<I>, mln::box3d>,
+                  "Input domain must be a box2d or a box3d");
+
+    int dim = image_point_t<I>::ndim;
+
+    // Compute the extended domain
+    auto dom = ima.domain();
+    for (int d = 0; d < dim; ++d)
+    {
+      dom.tl()[d] = dom.tl()[d] * 2;
+      dom.br()[d] = dom.br()[d] * 2 - 1;
+    }
+
+    image_ch_value_t<I, irange<image_value_t<I>>> out(dom);
+    impl::interval_immersion(ima, out);
+    return out;
+  }
 }
@@ -2,12 +2,24 @@
 
 #include <mln/core/image/ndbuffer_image.hpp>
 #include <mln/core/image/ndimage_fwd.hpp>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 
 namespace mln::morpho::details
 {
 
+  /// Interval [inf, sup] of the immersed image
+  template <class V>
+  struct irange
+  {
+    using value_type = V;
+
+    V inf;
+    V sup;
+  };
+
+
   /// Immersion algorithm for raw-contiguous buffer
   ///
   /// Given an input buffer of size \c n
@@ -32,6 +44,35 @@ namespace mln::morpho::details
   void buffer_interpolation_min(const T* __restrict A, const T* __restrict B, std::size_t n, T* __restrict out);
 
 
+  /// Interval immersion algorithm for raw-contiguous buffer
+  ///
+  /// Given an input buffer of size \c n
+  /// [a, b, c],
+  /// it computes the interleaved intervals:
+  /// out = [[a,a]; [min(a,b),max(a,b)]; [b,b]; [min(b,c),max(b,c)]; [c,c]]
+  template <class T>
+  void buffer_interval_immersion(const T* __restrict input, std::size_t n, irange<T>* __restrict out);
+
+  /// Interpolation algorithm for raw-contiguous interval buffers.
+  /// Compute the PW hull of the intervals of two buffers: out[i] = [min(A[i].inf, B[i].inf), max(A[i].sup, B[i].sup)]
+  template <class T>
+  void buffer_interval_interpolation(const irange<T>* __restrict A, const irange<T>* __restrict B, std::size_t n,
+                                     irange<T>* __restrict out);
+
+  /// SIMD versions for low-quantized values (defined in the library)
+  /// \{
+  void buffer_interval_immersion(const std::uint8_t* __restrict input, std::size_t n,
+                                 irange<std::uint8_t>* __restrict out);
+  void buffer_interval_immersion(const std::uint16_t* __restrict input, std::size_t n,
+                                 irange<std::uint16_t>* __restrict out);
+  void buffer_interval_interpolation(const irange<std::uint8_t>* __restrict A, const irange<std::uint8_t>* __restrict B,
+                                     std::size_t n, irange<std::uint8_t>* __restrict out);
+  void buffer_interval_interpolation(const irange<std::uint16_t>* __restrict A,
+                                     const irange<std::uint16_t>* __restrict B, std::size_t n,
+                                     irange<std::uint16_t>* __restrict out);
+  /// \}
+
+
   struct immersion_impl_table_base_t
   {
     virtual void immersion(void* input, std::size_t n, void* inf, void* sup) = 0;
@@ -46,6 +87,19 @@ namespace mln::morpho::details
                          immersion_impl_table_base_t* impl);
 
 
+  struct interval_immersion_impl_table_base_t
+  {
+    virtual void immersion(const void* input, std::size_t n, void* out)                  = 0;
+    virtual void interpolation(const void* A, const void* B, std::size_t n, void* out) = 0;
+  };
+
+  /// Type-erased interval immersion algorithm for any buffer-encoded image
+  ///
+  /// The rows are processed in parallel.
+  void interval_immersion_ndimage(ndbuffer_image& input, ndbuffer_image& out,
+                                  interval_immersion_impl_table_base_t* impl);
+
+
   template <class T>
   struct immersion_impl_table_t : immersion_impl_table_base_t
   {
@@ -65,6 +119,22 @@ namespace mln::morpho::details
   };
 
 
+  template <class T>
+  struct interval_immersion_impl_table_t : interval_immersion_impl_table_base_t
+  {
+    void immersion(const void* input, std::size_t n, void* out) final
+    {
+      buffer_interval_immersion(static_cast<const T*>(input), n, static_cast<irange<T>*>(out));
+    }
+
+    void interpolation(const void* A, const void* B, std::size_t n, void* out) final
+    {
+      buffer_interval_interpolation(static_cast<const irange<T>*>(A), static_cast<const irange<T>*>(B), n,
+                                    static_cast<irange<T>*>(out));
+    }
+  };
+
+
   /******************************************/
   /****          Implementation          ****/
   /******************************************/
@@ -102,4 +172,27 @@ namespace mln::morpho::details
     for (std::size_t i = 0; i < n; ++i)
       out[i] = std::min(A[i], B[i]);
   }
+
+  template <class T>
+  void buffer_interval_immersion(const T* __restrict f, std::size_t n, irange<T>* __restrict out)
+  {
+    if (n == 0)
+      return;
+
+    out[0] = {f[0], f[0]};
+    for (std::size_t x = 1; x < n; ++x)
+    {
+      auto [m, M]    = std::minmax(f[x - 1], f[x]);
+      out[2 * x - 1] = {m, M};
+      out[2 * x]     = {f[x], f[x]};
+    }
+  }
+
+  template <class T>
+  void buffer_interval_interpolation(const irange<T>* __restrict A, const irange<T>* __restrict B, std::size_t n,
+                                     irange<T>* __restrict out)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      out[i] = {std::min(A[i].inf, B[i].inf), std::max(A[i].sup, B[i].sup)};
+  }
 }
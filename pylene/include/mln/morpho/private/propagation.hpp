@@ -9,6 +9,7 @@
 #include <mln/core/neighborhood/c4.hpp>
 #include <mln/core/neighborhood/c6.hpp>
 
+#include <mln/morpho/private/immersion.spe.hpp>
 #include <mln/morpho/private/pset.hpp>
 
 
@@ -19,18 +20,17 @@ namespace mln::morpho::details
   std::vector<image_value_t<I>> //
   propagation(I inf, I sup, image_ch_value_t<I, int> out, image_point_t<I> pstart, int& max_depth);
 
+  /// Propagation on an interval-valued image (see interval_immersion)
+  /// \tparam kind The implementation of the point set (see pset)
+  template <class J, pset_kind kind = pset_default_kind<typename image_value_t<J>::value_type>>
+  std::vector<typename image_value_t<J>::value_type> //
+  propagation(J F, image_ch_value_t<J, int> out, image_point_t<J> pstart, int& max_depth);
+
 
   /******************************************/
   /****          Implementation          ****/
   /******************************************/
 
-  template <class V>
-  struct irange
-  {
-    V inf;
-    V sup;
-  };
-
 
   template <class I>
   [[gnu::noinline]]
@@ -47,16 +47,24 @@ namespace mln::morpho::details
   template <class I>
   std::vector<image_value_t<I>> //
   propagation(I inf, I sup, image_ch_value_t<I, int> ord, image_point_t<I> pstart, int& max_depth)
+  {
+    assert(inf.domain() == sup.domain());
+    return propagation(to_infsup(std::move(inf), std::move(sup)), std::move(ord), pstart, max_depth);
+  }
+
+
+  template <class J, pset_kind kind>
+  std::vector<typename image_value_t<J>::value_type> //
+  propagation(J F, image_ch_value_t<J, int> ord, image_point_t<J> pstart, int& max_depth)
   {
     mln_entering("mln::morpho::details::propagation");
 
-    using P              = image_point_t<I>;
-    using V              = image_value_t<I>;
+    using P              = image_point_t<J>;
+    using V              = typename image_value_t<J>::value_type;
 
     static_assert(P::ndim == 2 || P::ndim == 3, "Invalid number of dimension");
-    assert(inf.domain() == sup.domain());
-    assert(inf.domain() == ord.domain());
-    assert(inf.domain().has(pstart));
+    assert(F.domain() == ord.domain());
+    assert(F.domain().has(pstart));
 
     using connectivity_t = std::conditional_t<P::ndim == 2, mln::c4_t, mln::c6_t>;
 
@@ -80,13 +88,11 @@ namespace mln::morpho::details
     //   sorted_indexes->reserve(ord.domain().size());
 
 
-    auto F = to_infsup(inf, sup);
-
-    pset<I>        queue(inf);
-    std::vector<V> depth2lvl;
+    pset<image_ch_value_t<J, V>, kind> queue(F);
+    std::vector<V>               depth2lvl;
 
     auto p              = pstart;
-    V    previous_level = inf(p);
+    V    previous_level = F(p).inf;
     queue.insert(previous_level, p);
 
     // if (compute_indexes)
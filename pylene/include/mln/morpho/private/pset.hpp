@@ -1,22 +1,56 @@
 #pragma once
 
 
+#include <mln/core/range/foreach.hpp>
+#include <mln/morpho/private/bitset_tree.hpp>
 #include <mln/morpho/private/hsimple_linked_lists.hpp>
 #include <mln/morpho/private/hvector_unbounded.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 namespace mln::morpho::details
 {
 
+  /// \brief True if the keys of type \p Key are stored in a hierarchical queue (one list per level)
+  template <class Key>
+  inline constexpr bool pset_is_hierarchical =
+      std::is_integral_v<Key> && !std::numeric_limits<Key>::is_signed && std::numeric_limits<Key>::digits <= 16;
+
+  /// \brief Implementations of the point set
+  enum class pset_kind
+  {
+    hierarchical, ///< One list per level, for low-quantized unsigned keys (≤ 16 bits)
+    bucket,       ///< One list per level indexed by a bitset tree, for dense 32-bit unsigned keys (e.g. ranks)
+    ordered       ///< Ordered map from the levels to the lists, for any totally ordered key
+  };
+
+  /// \brief The default implementation for the keys of type \p Key
+  template <class Key>
+  inline constexpr pset_kind pset_default_kind = pset_is_hierarchical<Key> ? pset_kind::hierarchical : pset_kind::ordered;
+
+
   /// \brief A point set allows to keep a ordered set of points or indexes
   /// sorted by a given key (generally the pixel value)
   /// For now, it only supports indexes
   ///
+  /// Low-quantized unsigned keys (≤ 16 bits) use a hierarchical queue. The other keys (floating points, signed or 32-bit
+  /// integers...) use an ordered map from the levels to the lists of points; they must be totally ordered (no NaN).
+  /// The bucket queue must be requested explicitly: its keys are 32-bit and must be dense (one list is allocated for
+  /// each level up to the max level of the image).
+  ///
   /// \warning For two entries with identical keys (levels), this data structure acts
   /// like a LIFO (last in first out)
+  template <class I, pset_kind kind = pset_default_kind<image_value_t<I>>>
+  class pset;
+
+
   template <class I>
-  class pset
+  class pset<I, pset_kind::hierarchical>
   {
   public:
     using Key   = image_value_t<I>;
@@ -26,23 +60,20 @@ namespace mln::morpho::details
     pset(J&& ima);
 
     /// \brief Insert a point \p p at the given \p level
-    void insert(int level, Point p) noexcept;
+    void insert(Key level, Point p) noexcept;
 
     /// \brief Return and remove the closest level pair (key,point) such that:
     /// * there is a pair (l₁,p₁) in the set with l₁ ≥ level then (l₁,p₁)
     /// * there is a pair (l₁,p₂) in the set with l₂ < level then (l₂,p₂)
-    std::pair<int, Point> pop(int level) noexcept;
+    std::pair<Key, Point> pop(Key level) noexcept;
 
     /// \brief Return and remove the point if the queue is not empty
-    std::optional<Point> try_pop(int level) noexcept;
+    std::optional<Point> try_pop(Key level) noexcept;
 
     /// \brief Return true if the set is empty
     bool empty() const noexcept;
 
   private:
-    static_assert(std::is_integral_v<Key>);
-    static_assert(!std::numeric_limits<Key>::is_signed);
-    static_assert(std::numeric_limits<Key>::digits <= 16);
     static constexpr int nLevel = 1 << std::numeric_limits<Key>::digits;
 
     //using link_image_t = image_ch_value_t<I, Point>;
@@ -53,6 +84,74 @@ namespace mln::morpho::details
     std::size_t m_size;
   };
 
+
+  template <class I>
+  class pset<I, pset_kind::bucket>
+  {
+  public:
+    using Key   = image_value_t<I>;
+    using Point = image_point_t<I>;
+
+    static_assert(std::is_same_v<Key, std::uint32_t>, "The bucket queue requires 32-bit unsigned keys");
+
+    /// \param ima The image of the keys (or of intervals of keys) that will be inserted, used to get the number of levels
+    template <class J>
+    pset(J&& ima);
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::insert
+    void insert(Key level, Point p) noexcept;
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::pop
+    std::pair<Key, Point> pop(Key level) noexcept;
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::try_pop
+    std::optional<Point> try_pop(Key level) noexcept;
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::empty
+    bool empty() const noexcept;
+
+  private:
+    template <class J>
+    static int count_levels(J& ima);
+
+    int                       m_nlevels;
+    hvectors_unbounded<Point> m_delegate;
+    bitset_tree               m_levels; // Non-empty levels
+    std::size_t               m_size;
+  };
+
+
+  template <class I>
+  class pset<I, pset_kind::ordered>
+  {
+  public:
+    using Key   = image_value_t<I>;
+    using Point = image_point_t<I>;
+
+    template <class J>
+    pset(J&& ima);
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::insert
+    void insert(Key level, Point p);
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::pop
+    std::pair<Key, Point> pop(Key level);
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::try_pop
+    std::optional<Point> try_pop(Key level);
+
+    /// \copydoc pset<I,pset_kind::hierarchical>::empty
+    bool empty() const noexcept;
+
+  private:
+    using map_t = std::map<Key, std::vector<Point>>;
+
+    void erase(typename map_t::iterator it);
+
+    map_t                                  m_levels; // Non-empty levels
+    std::vector<typename map_t::node_type> m_free;   // Nodes of the removed levels, recycled with their buffers
+  };
+
   /******************************************/
   /****          Implementation          ****/
   /******************************************/
@@ -60,21 +159,21 @@ namespace mln::morpho::details
 
   template <class I>
   template <class J>
-  pset<I>::pset(J&&)
+  pset<I, pset_kind::hierarchical>::pset(J&&)
     : m_delegate{nLevel},
       m_size{0}
   {
   }
 
   template <class I>
-  void pset<I>::insert(int level, Point p) noexcept
+  void pset<I, pset_kind::hierarchical>::insert(Key level, Point p) noexcept
   {
     m_delegate.push_front(level, p);
     m_size++;
   }
 
   template <class I>
-  auto pset<I>::pop(int level) noexcept -> std::pair<int, Point>
+  auto pset<I, pset_kind::hierarchical>::pop(Key level) noexcept -> std::pair<Key, Point>
   {
     assert(m_size > 0);
     int l = m_delegate.lower_bound(level);
@@ -84,11 +183,11 @@ namespace mln::morpho::details
       assert(l >= 0);
     }
     m_size--;
-    return {l, m_delegate.pop_front(l)};
+    return {static_cast<Key>(l), m_delegate.pop_front(l)};
   }
 
   template <class I>
-  auto pset<I>::try_pop(int level) noexcept -> std::optional<Point>
+  auto pset<I, pset_kind::hierarchical>::try_pop(Key level) noexcept -> std::optional<Point>
   {
     if (m_delegate.empty(level))
       return std::nullopt;
@@ -98,10 +197,152 @@ namespace mln::morpho::details
 
 
   template <class I>
-  bool pset<I>::empty() const noexcept
+  bool pset<I, pset_kind::hierarchical>::empty() const noexcept
   {
     return m_size == 0;
   }
 
 
+  template <class I>
+  template <class J>
+  int pset<I, pset_kind::bucket>::count_levels(J& ima)
+  {
+    Key m = 0;
+    mln_foreach (auto v, ima.values())
+    {
+      if constexpr (std::is_same_v<std::remove_cvref_t<decltype(v)>, Key>)
+        m = std::max(m, v);
+      else
+        m = std::max(m, v.sup); // Intervals of keys
+    }
+    return static_cast<int>(m) + 1;
+  }
+
+  template <class I>
+  template <class J>
+  pset<I, pset_kind::bucket>::pset(J&& ima)
+    : m_nlevels{count_levels(ima)}
+    , m_delegate{m_nlevels}
+    , m_levels(m_nlevels)
+    , m_size{0}
+  {
+  }
+
+  template <class I>
+  void pset<I, pset_kind::bucket>::insert(Key level, Point p) noexcept
+  {
+    mln_precondition(static_cast<int>(level) < m_nlevels);
+    m_delegate.push_front(level, p);
+    m_levels.insert(level);
+    m_size++;
+  }
+
+  template <class I>
+  auto pset<I, pset_kind::bucket>::pop(Key level) noexcept -> std::pair<Key, Point>
+  {
+    assert(m_size > 0);
+    std::ptrdiff_t l = m_levels.next(level);
+    if (l < 0)
+    {
+      l = m_levels.prev(level);
+      assert(l >= 0);
+    }
+
+    Point p = m_delegate.pop_front(static_cast<int>(l));
+    if (m_delegate.empty(static_cast<int>(l)))
+      m_levels.erase(l);
+    m_size--;
+    return {static_cast<Key>(l), p};
+  }
+
+  template <class I>
+  auto pset<I, pset_kind::bucket>::try_pop(Key level) noexcept -> std::optional<Point>
+  {
+    if (static_cast<int>(level) >= m_nlevels || m_delegate.empty(level))
+      return std::nullopt;
+
+    Point p = m_delegate.pop_front(level);
+    if (m_delegate.empty(level))
+      m_levels.erase(level);
+    m_size--;
+    return p;
+  }
+
+  template <class I>
+  bool pset<I, pset_kind::bucket>::empty() const noexcept
+  {
+    return m_size == 0;
+  }
+
+
+  template <class I>
+  template <class J>
+  pset<I, pset_kind::ordered>::pset(J&&)
+  {
+  }
+
+  template <class I>
+  void pset<I, pset_kind::ordered>::insert(Key level, Point p)
+  {
+    auto it = m_levels.lower_bound(level);
+    if (it == m_levels.end() || level < it->first)
+    {
+      if (m_free.empty())
+      {
+        it = m_levels.emplace_hint(it, level, std::vector<Point>{});
+      }
+      else
+      {
+        auto node = std::move(m_free.back());
+        m_free.pop_back();
+        node.key() = level;
+        it         = m_levels.insert(it, std::move(node));
+      }
+    }
+    it->second.push_back(p);
+  }
+
+  template <class I>
+  void pset<I, pset_kind::ordered>::erase(typename map_t::iterator it)
+  {
+    m_free.push_back(m_levels.extract(it));
+  }
+
+  template <class I>
+  auto pset<I, pset_kind::ordered>::pop(Key level) -> std::pair<Key, Point>
+  {
+    assert(!m_levels.empty());
+    auto it = m_levels.lower_bound(level);
+    if (it == m_levels.end())
+      --it;
+
+    Key   l = it->first;
+    Point p = it->second.back();
+    it->second.pop_back();
+    if (it->second.empty())
+      this->erase(it);
+    return {l, p};
+  }
+
+  template <class I>
+  auto pset<I, pset_kind::ordered>::try_pop(Key level) -> std::optional<Point>
+  {
+    auto it = m_levels.find(level);
+    if (it == m_levels.end())
+      return std::nullopt;
+
+    Point p = it->second.back();
+    it->second.pop_back();
+    if (it->second.empty())
+      this->erase(it);
+    return p;
+  }
+
+  template <class I>
+  bool pset<I, pset_kind::ordered>::empty() const noexcept
+  {
+    return m_levels.empty();
+  }
+
+
 } // namespace mln::morpho::details
@@ -2,23 +2,36 @@
 
 
 #include <mln/morpho/maxtree.hpp>
+#include <mln/morpho/canvas/unionfind.hpp>
 #include <mln/morpho/private/immersion.hpp>
 #include <mln/morpho/private/propagation.hpp>
+#include <mln/core/algorithm/transform.hpp>
 #include <mln/core/image/view/cast.hpp>
+#include <mln/core/range/foreach.hpp>
+#include <mln/core/trace.hpp>
 
 #include <range/v3/algorithm/transform.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
 namespace mln::morpho
 {
 
+  /// Processing flags of the ToS (bit flags)
   enum {
-    ToS_NodeMapOriginalSize,
-    ToS_NodeMapTwiceSize
+    ToS_NodeMapTwiceSize    = 0,
+    ToS_NodeMapOriginalSize = 1 << 0
   };
 
   /// \brief Compute the tree of shapes.
-  /// \param[in] input Input image
+  /// \param[in] input Input image (any totally ordered scalar type, floating point values must not be NaN)
   /// \param[in] start_point Root point
+  /// \param[in] processing_flags ToS_NodeMapTwiceSize to get the node map on the immersed domain (twice the size of
+  /// the input domain), ToS_NodeMapOriginalSize to get it on the input domain (the nodes without any original pixel
+  /// are removed)
   /// \return A pair (tree, node_map) encoding the tree of shapes and the mapping (pixel -> node_index)
   template <class I>
   [[gnu::noinline]] auto tos(I input, image_point_t<I> pstart, int processing_flags = ToS_NodeMapTwiceSize);
@@ -29,10 +42,246 @@ namespace mln::morpho
   /****          Implementation          ****/
   /******************************************/
 
+  namespace details
+  {
+    /// \brief Immersion of \p f followed by the propagation
+    ///
+    /// \param[out] ord The depth image, allocated on the immersed domain
+    /// \tparam kind The implementation of the point set used by the propagation
+    template <pset_kind kind, class I, class O>
+    std::vector<image_value_t<I>> immersion_propagation(I f, O& ord, image_point_t<I> pstart, int& max_depth)
+    {
+      using P              = image_point_t<I>;
+      using connectivity_t = std::conditional_t<P::ndim == 2, mln::c4_t, mln::c6_t>;
+
+      auto F = details::interval_immersion(std::move(f));
+      ord    = imchvalue<int>(F).adjust(connectivity_t{});
+      return details::propagation<decltype(F), kind>(std::move(F), ord, pstart, max_depth);
+    }
+
+    /// \brief Propagation on the ranks of the levels, for the values that do not fit in a hierarchical queue
+    ///
+    /// The values of the input are sorted and replaced by their rank. The immersion of the rank image gives the ranks of
+    /// the interpolated intervals (min and max commute with an increasing map), so only the N original values are
+    /// sorted. With at most 2¹⁶ distinct values, the ranks are 16-bit and use the hierarchical queue; otherwise they are
+    /// 32-bit and use a bucket queue over the ranks.
+    template <class I, class O>
+    std::vector<image_value_t<I>> propagation_by_rank(I input, O& ord, image_point_t<I> pstart, int& max_depth)
+    {
+      mln_entering("mln::morpho::details::propagation_by_rank");
+
+      using V = image_value_t<I>;
+
+      std::vector<V> levels;
+      levels.reserve(input.domain().size());
+      mln_foreach (auto v, input.values())
+        levels.push_back(v);
+      std::sort(levels.begin(), levels.end());
+      levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+
+      auto by_rank = [&](auto rank_type, auto kind) {
+        using R = decltype(rank_type);
+
+        auto rank  = [&levels](V v) -> R {
+          return static_cast<R>(std::lower_bound(levels.begin(), levels.end(), v) - levels.begin());
+        };
+        auto ranks = immersion_propagation<decltype(kind)::value>(mln::transform(input, rank), ord, pstart, max_depth);
+
+        std::vector<V> depth2lvl(ranks.size());
+        std::transform(ranks.begin(), ranks.end(), depth2lvl.begin(), [&levels](R r) { return levels[r]; });
+        return depth2lvl;
+      };
+
+      if (levels.size() <= (1 << 16))
+        return by_rank(std::uint16_t{}, std::integral_constant<pset_kind, pset_kind::hierarchical>{});
+      else
+        return by_rank(std::uint32_t{}, std::integral_constant<pset_kind, pset_kind::bucket>{});
+    }
+
+
+    /// \brief Max-tree of the depth image computed by the propagation
+    ///
+    /// Union-find on the points sorted by depth (counting sort), for the depths that do not fit in 16 bits. The nodes
+    /// are ordered so that parent[i] < i, as in mln::morpho::maxtree.
+    template <class J>
+    std::pair<component_tree<int>, image_ch_value_t<J, component_tree<>::node_id_type>> //
+    depth_maxtree(J ord, int max_depth)
+    {
+      mln_entering("mln::morpho::details::depth_maxtree");
+
+      using P              = image_point_t<J>;
+      using connectivity_t = std::conditional_t<P::ndim == 2, mln::c4_t, mln::c6_t>;
+
+      connectivity_t nbh;
+      const auto     domain = ord.domain();
+
+      // Counting sort of the points by depth
+      std::vector<std::size_t> count(max_depth + 2, 0);
+      mln_foreach (int d, ord.values())
+        ++count[d + 1];
+      std::partial_sum(count.begin(), count.end(), count.begin());
+
+      std::vector<P> S(count.back());
+      mln_foreach (auto px, ord.pixels())
+        S[count[px.val()]++] = px.point();
+
+      // Union-find from the deepest points
+      image_ch_value_t<J, P> par = imchvalue<P>(ord);
+      {
+        image_ch_value_t<J, P>    zpar = imchvalue<P>(ord);
+        image_ch_value_t<J, bool> done = imchvalue<bool>(ord).set_init_value(false);
+
+        for (auto it = S.rbegin(); it != S.rend(); ++it)
+        {
+          P p     = *it;
+          par(p)  = p;
+          zpar(p) = p;
+          for (auto q : nbh(p))
+          {
+            if (!domain.has(q) || !done(q))
+              continue;
+
+            P r = canvas::impl::zfindroot(zpar, q);
+            if (r != p)
+            {
+              par(r)  = p;
+              zpar(r) = p;
+            }
+          }
+          done(p) = true;
+        }
+      } // The union-find buffers are released before the node map is allocated
+
+      // Canonicalization and node numbering (the parent of a point is before the point in S)
+      component_tree<int>                                 t;
+      image_ch_value_t<J, component_tree<>::node_id_type> node_map = imchvalue<component_tree<>::node_id_type>(ord);
+      for (P p : S)
+      {
+        P q = par(p);
+        if (ord(par(q)) == ord(q))
+          par(p) = q = par(q);
+
+        if (q == p || ord(q) != ord(p))
+        {
+          node_map(p) = static_cast<int>(t.parent.size());
+          t.parent.push_back(q == p ? -1 : node_map(q));
+          t.values.push_back(ord(p));
+        }
+        else
+        {
+          node_map(p) = node_map(q);
+        }
+      }
+
+      return {std::move(t), std::move(node_map)};
+    }
+
+    /// \brief Max-tree visitor that records the node map on the original points only (the even points of the immersed
+    /// domain), the node map of the immersed domain is never allocated
+    template <class I, class O>
+    struct tos_original_size_visitor : maxtree_visitor<I>
+    {
+      using typename maxtree_visitor<I>::point_t;
+      using typename maxtree_visitor<I>::level_t;
+
+      void on_done(level_t, point_t p)
+      {
+        point_t q;
+        for (int k = 0; k < point_t::ndim; ++k)
+        {
+          if (p[k] & 1)
+            return;
+          q[k] = p[k] >> 1;
+        }
+        out(q) = this->roots.back().node_root_id;
+      }
+
+      O out; // Node map on the original domain
+    };
+
+    /// \brief Max-tree of the depth image with the node map of the original points
+    ///
+    /// \param out The node map, allocated on the original domain
+    template <class J, class O>
+    std::pair<component_tree<image_value_t<J>>, O> tos_maxtree_original_size(J depth, O out)
+    {
+      mln_entering("mln::morpho::details::tos_maxtree_original_size");
+
+      using P              = image_point_t<J>;
+      using connectivity_t = std::conditional_t<P::ndim == 2, mln::c4_t, mln::c6_t>;
+
+      constexpr std::size_t kStackReserve = 256;
+
+      tos_original_size_visitor<J, O> viz;
+      viz.roots.reserve(kStackReserve);
+      viz.out = std::move(out);
+
+      canvas::depthfirst(depth, connectivity_t{}, viz, depth.domain().tl());
+      permute_parent_and_node_map(viz.out, viz.nodes.data(), viz.lvlnodes.data(), viz.nodes.size());
+
+      component_tree<image_value_t<J>> t;
+      t.parent = std::move(viz.nodes);
+      t.values = std::move(viz.lvlnodes);
+      return {std::move(t), std::move(viz.out)};
+    }
+
+    /// \brief Restrict a node map of the immersed domain to the original points (the even points)
+    template <class J>
+    J tos_subsample_node_map(const J& node_map, image_domain_t<J> domain)
+    {
+      J out(domain);
+      mln_foreach (auto px, out.pixels())
+        px.val() = node_map(2 * px.point());
+      return out;
+    }
+
+    /// \brief Remove the nodes of the ToS without any original point
+    ///
+    /// \param node_map The node map of the original points
+    ///
+    /// The children of a removed node are attached to their closest kept ancestor. The root is always kept and the nodes
+    /// remain ordered so that parent[i] < i.
+    template <class V, class J>
+    void tos_remove_interpolated_nodes(component_tree<V>& t, J& node_map)
+    {
+      mln_entering("mln::morpho::details::tos_remove_interpolated_nodes");
+
+      const std::size_t n = t.parent.size();
+      std::vector<bool> keep(n, false);
+      keep[0] = true;
+      mln_foreach (int id, node_map.values())
+        keep[id] = true;
+
+      std::vector<int> newid(n);
+      int              count = 0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        int par = t.parent[i];
+        if (!keep[i])
+        {
+          newid[i] = newid[par];
+          continue;
+        }
+        newid[i]        = count;
+        t.parent[count] = (par < 0) ? -1 : newid[par];
+        t.values[count] = t.values[i];
+        ++count;
+      }
+      t.parent.resize(count);
+      t.values.resize(count);
+
+      mln_foreach (auto& id, node_map.values())
+        id = newid[id];
+    }
+  } // namespace details
+
 
   template <class I>
-  auto tos(I input, image_point_t<I> pstart, int /* processing_flags */)
+  auto tos(I input, image_point_t<I> pstart, int processing_flags)
   {
+    mln_entering("mln::morpho::tos");
+    mln::trace::annotate("pixels", input.domain().size());
+
     static_assert(mln::is_a<I, mln::details::Image>());
 
     using Domain = image_domain_t<I>;
@@ -43,25 +292,60 @@ namespace mln::morpho
                   "Only 2D or 3D regular domain supported");
 
     using connectivity_t = std::conditional_t<P::ndim == 2, mln::c4_t, mln::c6_t>;
+    using node_map_t     = image_ch_value_t<image_ch_value_t<I, int>, component_tree<>::node_id_type>;
     connectivity_t nbh;
 
-    int max_depth;
-    auto [inf, sup] = details::immersion(input);
+    int                      max_depth;
+    image_ch_value_t<I, int> ord;
+    std::vector<V>           depth2lvl;
+    // The interval image is released before the tree construction
+    if constexpr (details::pset_is_hierarchical<V>)
+      depth2lvl = details::immersion_propagation<details::pset_kind::hierarchical>(input, ord, pstart, max_depth);
+    else
+      depth2lvl = details::propagation_by_rank(input, ord, pstart, max_depth);
 
-    image_ch_value_t<I, int> ord = imchvalue<int>(inf).adjust(nbh);
-    auto depth2lvl = details::propagation(inf, sup, ord, pstart, max_depth);
+    component_tree<V> t2;
+    node_map_t        node_map;
 
-    if (max_depth >= (1 << 16))
-      throw std::runtime_error("The ToS is too deep (too many number of levels)");
+    auto set_levels = [&t2, &depth2lvl](auto& t1) {
+      std::size_t n = t1.parent.size();
+      t2.parent = std::move(t1.parent);
+      t2.values.resize(n);
+      ::ranges::transform(t1.values, std::begin(t2.values), [&depth2lvl](int l) -> V { return depth2lvl[l]; });
+    };
 
-    auto casted = mln::view::cast<uint16_t>(ord);
-    auto [t1, node_map] = maxtree(casted, nbh);
+    // With ToS_NodeMapOriginalSize, the node map is only written on the original points
+    const bool original_size = (processing_flags & ToS_NodeMapOriginalSize) != 0;
+    if (max_depth < (1 << 16))
+    {
+      auto casted = mln::view::cast<uint16_t>(ord);
+      if (original_size)
+      {
+        auto [t1, nm] = details::tos_maxtree_original_size(casted, node_map_t(input.domain()));
+        set_levels(t1);
+        node_map = std::move(nm);
+      }
+      else
+      {
+        auto [t1, nm] = maxtree(casted, nbh);
+        set_levels(t1);
+        node_map = std::move(nm);
+      }
+    }
+    else
+    {
+      auto [t1, nm] = details::depth_maxtree(ord, max_depth);
+      set_levels(t1);
+      ord      = image_ch_value_t<I, int>();
+      // The canonicalization needs the node ids of the odd points: the immersed node map is built then subsampled
+      node_map = original_size ? details::tos_subsample_node_map(nm, input.domain()) : std::move(nm);
+    }
 
-    std::size_t n = t1.parent.size();
-    component_tree<V> t2;
-    t2.parent = std::move(t1.parent);
-    t2.values.resize(n);
-    ::ranges::transform(t1.values, std::begin(t2.values), [&depth2lvl](int l) -> V { return depth2lvl[l]; });
+    if (original_size)
+    {
+      ord = image_ch_value_t<I, int>();
+      details::tos_remove_interpolated_nodes(t2, node_map);
+    }
 
     return std::make_pair(std::move(t2), std::move(node_map));
   }
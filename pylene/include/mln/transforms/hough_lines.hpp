@@ -11,21 +11,34 @@ namespace mln::transforms
 
   class HoughLineAccumulator
   {
-    std::unique_ptr<float[]>  m_sin_angles;
-    std::unique_ptr<float[]>  m_cos_angles;
+    std::unique_ptr<float[]>  m_sin_angles;   // Padded with zeros to a multiple of the SIMD batch size
+    std::unique_ptr<float[]>  m_cos_angles;   // Padded with zeros to a multiple of the SIMD batch size
+    std::unique_ptr<int[]>    m_base_indexes; // Index of the cell (angle, radius = 0) in the accumulator
+    std::unique_ptr<int[]>    m_indexes;      // Buffer for the indexes of the votes of a point
     std::size_t               m_count;
+    std::size_t               m_padded_count;
     int                       m_max_distance;
     mln::ndbuffer_image       m_acc;
 
     void _init(std::span<float> angles, float max_distance);
+    void _init_indexes();
+    const int* _compute_indexes(point2d p) noexcept;
 
   public:
     HoughLineAccumulator(std::span<float> angles, float max_distance, bool weighted);
+
+    /// The accumulator image can be an image2d<int>, an image2d<float> for the weighted votes, or an
+    /// image2d<uint16_t> to halve the memory traffic. In the latter case, the caller must ensure that a cell does not
+    /// overflow (e.g. by taking at most 65535 points).
     HoughLineAccumulator(std::span<float> angles, float max_distance, mln::ndbuffer_image* acc);
 
     void take(point2d p) noexcept;
     void take(point2d p, float w) noexcept;
 
+    /// Batched versions of take(). The radii are computed with SIMD over the angles.
+    void take(std::span<const point2d> points) noexcept;
+    void take(std::span<const point2d> points, std::span<const float> weights) noexcept;
+
     image2d<int> get_accumulator_image() const { return m_acc.__cast<int, 2>(); }
     image2d<float> get_waccumulator_image() const { return m_acc.__cast<float, 2>(); }
   };
@@ -66,6 +79,21 @@ namespace mln::transforms
   /// @return image2d<float> The output image of size (W × H) where H is the length of the diagonal
   image2d<float> hough_lines(const image2d<float>& input, std::span<float> angles, image2d<float>* out = nullptr);
 
+  namespace parallel
+  {
+    /// @brief Parallel version of mln::transforms::hough_lines
+    ///
+    /// The points are split among the threads that vote in private accumulators, merged at the end.
+    ///
+    /// @param use_16bit_accumulators If true, the private accumulators are 16-bit (they are flushed in the output
+    /// before they may overflow). It halves the memory used by the threads.
+    image2d<int> hough_lines(const image2d<bool>& input, std::span<float> angles, image2d<int>* out = nullptr,
+                             bool use_16bit_accumulators = false);
+
+    /// @brief Parallel version of mln::transforms::hough_lines (weighted)
+    image2d<float> hough_lines(const image2d<float>& input, std::span<float> angles, image2d<float>* out = nullptr);
+  } // namespace parallel
+
   ///
   /// @brief Detect the peaks in a Hough vote image
   /// 
@@ -4,6 +4,8 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
+#include <span>
 #include <tuple>
 #include <vector>
 
@@ -164,4 +166,73 @@ namespace scribo
 
   std::tuple<mln::image2d<std::uint8_t>, mln::image2d<std::uint8_t>, mln::image2d<std::uint8_t>>
   detect_line_pp(const mln::image2d<std::uint8_t>& image, const SegDetParams& params);
+
+  /**
+   * Detects lines in several images concurrently (one task per image)
+   * @param images The images to process
+   * @param min_len The minimum length of segments to detect
+   * @param params A struct containing the parameters of the method (shared by all the images)
+   * @param nthreads The maximum number of threads used (if non-positive, the default number of threads)
+   * @return The vector of detected segments of each image (as detect_line_vector)
+   */
+  std::vector<std::vector<VSegment>> detect_line_batch(std::span<const mln::image2d<std::uint8_t>> images, int min_len,
+                                                       const SegDetParams& params = SegDetParams(), int nthreads = 0);
+
+  /**
+   * @brief Line detection on an image given as a sequence of horizontal bands, for images too tall to be held in
+   * memory (e.g. long continuous scans)
+   *
+   * The vertical segments are tracked row by row across the bands and are returned as soon as their trackers end. The
+   * horizontal segments are detected on successive windows of rows sharing \p overlap rows, and each segment is
+   * returned by the window where its top row lies in the first half of the overlap with the next window. A horizontal
+   * segment spanning more than overlap / 2 rows may thus be split. The duplicates between horizontal and vertical
+   * segments are not removed.
+   *
+   * Each row is preprocessed once, when its band is pushed. The BLACK_TOP_HAT preprocessing is not supported (its
+   * reconstruction spans the whole image and cannot be computed band by band): apply it on the image beforehand, or
+   * use detect_line_vector.
+   *
+   * The memory used only depends on the width of the image, the size of the bands and the overlap.
+   *
+   * \code
+   * scribo::StreamingLineDetector detector(width, min_len, params);
+   * while (read_next_band(band))
+   *   consume(detector.push(band));
+   * consume(detector.finish());
+   * \endcode
+   */
+  class StreamingLineDetector
+  {
+  public:
+    /**
+     * @param width The width of the image (and of every band)
+     * @param min_len The minimum length of segments to detect
+     * @param params A struct containing the parameters of the method
+     * @param overlap The number of rows shared by two successive windows of horizontal detection (2 * max_thickness
+     * if negative)
+     * @throw std::runtime_error if the width is not positive or if the preprocessing is BLACK_TOP_HAT
+     */
+    StreamingLineDetector(int width, int min_len, const SegDetParams& params = SegDetParams(), int overlap = -1);
+    ~StreamingLineDetector();
+
+    StreamingLineDetector(StreamingLineDetector&&) noexcept;
+    StreamingLineDetector& operator=(StreamingLineDetector&&) noexcept;
+
+    /**
+     * Process the next band of the image
+     * @param band The rows following the rows of the previous bands
+     * @return The segments ended so far (coordinates in the whole image)
+     */
+    std::vector<VSegment> push(const mln::image2d<std::uint8_t>& band);
+
+    /**
+     * Process the remaining rows. The detector cannot be used anymore afterwards.
+     * @return The last segments
+     */
+    std::vector<VSegment> finish();
+
+  private:
+    struct impl_t;
+    std::unique_ptr<impl_t> m_impl;
+  };
 } // namespace scribo
\ No newline at end of file
@@ -1,28 +1,47 @@
 #include <mln/bp/alloc.hpp>
-#include <cstdlib>
+#include <mln/core/image/image_allocator.hpp>
+
+#include <new>
 
 namespace mln::bp
 {
+  namespace
+  {
+    // Header stored before the buffer to release it to the allocator that provided it
+    struct block_header
+    {
+      std::shared_ptr<image_allocator> allocator;
+      std::size_t                      size;
+    };
+
+    constexpr std::size_t kHeaderSize = image_allocator::alignment;
+    static_assert(sizeof(block_header) <= kHeaderSize);
+  } // namespace
 
 
   void* aligned_alloc_2d(int width, int height, std::size_t e, std::ptrdiff_t& pitch)
   {
     pitch = (width * e + 0x1F) & 0xFFFFFFE0;
-#ifdef _MSC_VER
-    return _aligned_malloc(pitch * height, 32);
-#else
-      return std::aligned_alloc(32, pitch * height);
-#endif
+
+    auto        a    = get_image_allocator();
+    std::size_t size = kHeaderSize + pitch * height;
+    auto*       ptr  = static_cast<std::byte*>(a->allocate(size));
+    new (ptr) block_header{std::move(a), size};
+    return ptr + kHeaderSize;
   }
 
 
   void aligned_free_2d(void* ptr)
   {
-#ifdef _MSC_VER
-    return _aligned_free(ptr);
-#else
-    return std::free(ptr);
-#endif
+    if (ptr == nullptr)
+      return;
+
+    auto* block  = static_cast<std::byte*>(ptr) - kHeaderSize;
+    auto* header = std::launder(reinterpret_cast<block_header*>(block));
+    auto  a      = std::move(header->allocator);
+    auto  size   = header->size;
+    header->~block_header();
+    a->deallocate(block, size);
   }
 
 }
@@ -0,0 +1,206 @@
+#include <mln/colors/convert.hpp>
+
+#include <mln/core/canvas/parallel_pointwise.hpp>
+#include <mln/core/trace.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+
+namespace mln::colors::impl
+{
+  namespace
+  {
+    using simd_t            = xsimd::simd_type<float>;
+    constexpr int WARP_SIZE = simd_t::size;
+
+    // Number of pixels converted at once from/to the planar buffers (multiple of WARP_SIZE)
+    constexpr int kChunkSize = 128;
+
+
+    // Per-channel products with the coefficients of a 3×3 matrix: the matrix-vector product of an rgb8 value is
+    // computed with lookups and additions only. The products are kept in double so that the results are exactly those
+    // of the pixelwise conversion.
+    struct lut3x3_t
+    {
+      double m[3][3][256];
+
+      explicit lut3x3_t(const double (&coefs)[3][3])
+      {
+        for (int i = 0; i < 3; ++i)
+          for (int j = 0; j < 3; ++j)
+            for (int v = 0; v < 256; ++v)
+              m[i][j][v] = coefs[i][j] * v;
+      }
+    };
+
+
+    // Split the rgb8 values into 3 float planes and pad the last batch with zeros
+    void deinterleave(const std::uint8_t* in, int n, float* r, float* g, float* b) noexcept
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        r[i] = in[3 * i + 0];
+        g[i] = in[3 * i + 1];
+        b[i] = in[3 * i + 2];
+      }
+      for (int i = n; i % WARP_SIZE != 0; ++i)
+        r[i] = g[i] = b[i] = 0.f;
+    }
+
+    // RGB → XYZ on the planes (in place) with simd
+    void xyz_planes(float* x, float* y, float* z, int n) noexcept
+    {
+      for (int i = 0; i < n; i += WARP_SIZE)
+      {
+        const simd_t r = xsimd::load_unaligned(x + i);
+        const simd_t g = xsimd::load_unaligned(y + i);
+        const simd_t b = xsimd::load_unaligned(z + i);
+
+        xsimd::store_unaligned(x + i, simd_t(0.4125f) * r + simd_t(0.3576f) * g + simd_t(0.1805f) * b);
+        xsimd::store_unaligned(y + i, simd_t(0.2127f) * r + simd_t(0.7152f) * g + simd_t(0.0722f) * b);
+        xsimd::store_unaligned(z + i, simd_t(0.0193f) * r + simd_t(0.1192f) * g + simd_t(0.9505f) * b);
+      }
+    }
+
+    // XYZ → L*a*b* on the planes (in place) with simd (see mln::rgb2lab)
+    void lab_planes(float* x, float* y, float* z, int n) noexcept
+    {
+      constexpr float xn = (0.4125 + 0.3576 + 0.1804) * 255;
+      constexpr float yn = (0.2127 + 0.7152 + 0.0722) * 255;
+      constexpr float zn = (0.0193 + 0.1192 + 0.9502) * 255;
+
+      auto f = [](simd_t t) {
+        return xsimd::select(t > simd_t(.008856f), xsimd::cbrt(t), t * simd_t(7.787f) + simd_t(16.0f / 116.0f));
+      };
+
+      for (int i = 0; i < n; i += WARP_SIZE)
+      {
+        const simd_t xr = f(xsimd::load_unaligned(x + i) / simd_t(xn));
+        const simd_t yr = f(xsimd::load_unaligned(y + i) / simd_t(yn));
+        const simd_t zr = f(xsimd::load_unaligned(z + i) / simd_t(zn));
+
+        xsimd::store_unaligned(x + i, simd_t(116.f) * yr - simd_t(16.f));
+        xsimd::store_unaligned(y + i, simd_t(500.f) * (xr - yr));
+        xsimd::store_unaligned(z + i, simd_t(200.f) * (yr - zr));
+      }
+    }
+
+
+    class convert_canvas : public ParallelCanvas2d
+    {
+    public:
+      convert_canvas(const ndbuffer_image& in, ndbuffer_image& out, rgb8_conversion conv)
+        : m_in(in.buffer())
+        , m_in_stride(in.byte_stride(1))
+        , m_out(out.buffer())
+        , m_out_stride(out.byte_stride(1))
+        , m_width(in.width())
+        , m_height(in.height())
+        , m_conv(conv)
+      {
+      }
+
+      mln::box2d GetDomain() const final { return mln::box2d(m_width, m_height); }
+
+      void ExecuteTile(mln::box2d b) const final
+      {
+        for (int y = b.y(); y < b.br().y(); ++y)
+        {
+          const auto* in  = reinterpret_cast<const std::uint8_t*>(m_in + y * m_in_stride) + 3 * b.x();
+          std::byte*  out = m_out + y * m_out_stride;
+          switch (m_conv)
+          {
+          case rgb8_conversion::XYZ:
+          case rgb8_conversion::LAB:
+            float_row(in, reinterpret_cast<float*>(out) + 3 * b.x(), b.width());
+            break;
+          case rgb8_conversion::LSH:
+            lsh_row(in, reinterpret_cast<std::uint8_t*>(out) + 3 * b.x(), b.width());
+            break;
+          case rgb8_conversion::YCBCR:
+            ycbcr_row(in, reinterpret_cast<std::uint8_t*>(out) + 3 * b.x(), b.width());
+            break;
+          }
+        }
+      }
+
+    private:
+      // XYZ and L*a*b*: simd matrix product on planar chunks
+      void float_row(const std::uint8_t* in, float* out, int width) const noexcept
+      {
+        alignas(64) float p[3][kChunkSize];
+
+        for (int x = 0; x < width; x += kChunkSize)
+        {
+          const int n = std::min(kChunkSize, width - x);
+          deinterleave(in + 3 * x, n, p[0], p[1], p[2]);
+          xyz_planes(p[0], p[1], p[2], n);
+          if (m_conv == rgb8_conversion::LAB)
+            lab_planes(p[0], p[1], p[2], n);
+
+          float* o = out + 3 * x;
+          for (int i = 0; i < n; ++i)
+          {
+            o[3 * i + 0] = p[0][i];
+            o[3 * i + 1] = p[1][i];
+            o[3 * i + 2] = p[2][i];
+          }
+        }
+      }
+
+      // YCbCr: matrix product with the lookup tables (see mln::rgb2ycbcr)
+      void ycbcr_row(const std::uint8_t* in, std::uint8_t* out, int width) const noexcept
+      {
+        static const lut3x3_t lut({{0.299, 0.587, 0.114}, {-0.1687, 0.3313, 0.5}, {0.5, 0.4187, 0.0813}});
+        constexpr double      bias = 127.5;
+
+        for (int x = 0; x < width; ++x, in += 3, out += 3)
+        {
+          const int r = in[0], g = in[1], b = in[2];
+          out[0]      = static_cast<std::uint8_t>(lut.m[0][0][r] + lut.m[0][1][g] + lut.m[0][2][b]);
+          out[1]      = static_cast<std::uint8_t>(lut.m[1][0][r] - lut.m[1][1][g] + lut.m[1][2][b] + bias);
+          out[2]      = static_cast<std::uint8_t>(lut.m[2][0][r] - lut.m[2][1][g] - lut.m[2][2][b] + bias);
+        }
+      }
+
+      // LSH: the conversion depends on the order of the channels, it stays pixelwise
+      void lsh_row(const std::uint8_t* in, std::uint8_t* out, int width) const noexcept
+      {
+        for (int x = 0; x < width; ++x, in += 3, out += 3)
+        {
+          const lsh8 v = rgb2lsh(rgb8{in[0], in[1], in[2]});
+          out[0]       = v[0];
+          out[1]       = v[1];
+          out[2]       = v[2];
+        }
+      }
+
+      const std::byte* m_in;
+      std::ptrdiff_t   m_in_stride;
+      std::byte*       m_out;
+      std::ptrdiff_t   m_out_stride;
+      int              m_width;
+      int              m_height;
+      rgb8_conversion  m_conv;
+    };
+  } // namespace
+
+
+  void convert_rgb8(const ndbuffer_image& in, ndbuffer_image& out, rgb8_conversion conv, bool parallel)
+  {
+    if (in.pdim() != 2 || out.pdim() != 2 || in.width() != out.width() || in.height() != out.height())
+      throw std::runtime_error("The input and output images of the color conversion must have the same domain.");
+
+    mln_entering("mln::colors::convert");
+
+    convert_canvas canvas(in, out, conv);
+    if (parallel)
+      parallel_execute2d(canvas);
+    else
+      canvas.ExecuteTile(canvas.GetDomain());
+  }
+} // namespace mln::colors::impl
@@ -0,0 +1,242 @@
+#include <mln/contrib/meanshift/meanshift.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+namespace mln::contrib::impl
+{
+  namespace
+  {
+    using simd_t            = xsimd::simd_type<float>;
+    constexpr int WARP_SIZE = simd_t::size;
+
+    // Sum of the lanes of a batch
+    float reduce_add(const simd_t& v) noexcept
+    {
+      float tmp[WARP_SIZE];
+      xsimd::store_unaligned(tmp, v);
+
+      float s = 0;
+      for (int i = 0; i < WARP_SIZE; ++i)
+        s += tmp[i];
+      return s;
+    }
+
+
+    template <int N>
+    class meanshift_t
+    {
+    public:
+      meanshift_t(const float* in, float* out, int width, int height, float hs, float hr,
+                  const meanshift_params& params)
+        : m_width(width)
+        , m_height(height)
+        , m_inv_hs2(1.f / (hs * hs))
+        , m_inv_hr2(1.f / (hr * hr))
+        , m_eps2(params.epsilon * params.epsilon)
+        , m_radius(params.radius)
+        , m_niter(params.max_iterations)
+      {
+        const std::ptrdiff_t size = static_cast<std::ptrdiff_t>(width) * height;
+        for (int c = 0; c < N; ++c)
+        {
+          m_in[c]  = in + c * size;
+          m_out[c] = out + c * size;
+        }
+        for (int i = 0; i < WARP_SIZE; ++i)
+          m_iota[i] = static_cast<float>(i);
+      }
+
+      void run_row(int y) const noexcept
+      {
+        for (int x = 0; x < m_width; ++x)
+          run_pixel(x, y);
+      }
+
+    private:
+      // Weighted sums over the window
+      struct sums_t
+      {
+        float w;     // Sum of the weights
+        float x, y;  // Weighted sum of the sites
+        float v[N];  // Weighted sum of the values
+      };
+
+      // Sums of the window [x0,x1) × [y0,y1) for the current estimate (px, py, v)
+      sums_t window_sums(int x0, int x1, int y0, int y1, float px, float py, const float* v) const noexcept
+      {
+        const simd_t iota    = xsimd::load_unaligned(m_iota);
+        const simd_t vpx     = simd_t(px);
+        const simd_t inv_hs2 = simd_t(m_inv_hs2);
+        const simd_t inv_hr2 = simd_t(m_inv_hr2);
+
+        simd_t vv[N], acc_v[N];
+        for (int c = 0; c < N; ++c)
+        {
+          vv[c]    = simd_t(v[c]);
+          acc_v[c] = simd_t(0.f);
+        }
+        simd_t acc_w(0.f), acc_x(0.f), acc_y(0.f);
+
+        sums_t s = {};
+        for (int qy = y0; qy < y1; ++qy)
+        {
+          const float          fy   = static_cast<float>(qy);
+          const float          dy2  = (py - fy) * (py - fy) * m_inv_hs2;
+          const std::ptrdiff_t line = static_cast<std::ptrdiff_t>(qy) * m_width;
+
+          int qx = x0;
+          for (; qx + WARP_SIZE <= x1; qx += WARP_SIZE)
+          {
+            const simd_t fx = iota + simd_t(static_cast<float>(qx));
+            const simd_t dx = vpx - fx;
+
+            simd_t vals[N];
+            simd_t dr(0.f);
+            for (int c = 0; c < N; ++c)
+            {
+              vals[c]        = xsimd::load_unaligned(m_in[c] + line + qx);
+              const simd_t e = vv[c] - vals[c];
+              dr += e * e;
+            }
+
+            const simd_t w = xsimd::exp(-(dx * dx * inv_hs2 + simd_t(dy2) + dr * inv_hr2));
+            acc_w += w;
+            acc_x += w * fx;
+            acc_y += w * simd_t(fy);
+            for (int c = 0; c < N; ++c)
+              acc_v[c] += w * vals[c];
+          }
+
+          for (; qx < x1; ++qx)
+          {
+            const float fx = static_cast<float>(qx);
+            float       dr = 0;
+            for (int c = 0; c < N; ++c)
+            {
+              const float e = v[c] - m_in[c][line + qx];
+              dr += e * e;
+            }
+
+            const float w = std::exp(-((px - fx) * (px - fx) * m_inv_hs2 + dy2 + dr * m_inv_hr2));
+            s.w += w;
+            s.x += w * fx;
+            s.y += w * fy;
+            for (int c = 0; c < N; ++c)
+              s.v[c] += w * m_in[c][line + qx];
+          }
+        }
+
+        s.w += reduce_add(acc_w);
+        s.x += reduce_add(acc_x);
+        s.y += reduce_add(acc_y);
+        for (int c = 0; c < N; ++c)
+          s.v[c] += reduce_add(acc_v[c]);
+        return s;
+      }
+
+      void run_pixel(int x, int y) const noexcept
+      {
+        // The window stays centered on the original site, clipped once to the domain
+        const int x0 = std::max(0, x - m_radius), x1 = std::min(m_width, x + m_radius + 1);
+        const int y0 = std::max(0, y - m_radius), y1 = std::min(m_height, y + m_radius + 1);
+
+        const std::ptrdiff_t i = static_cast<std::ptrdiff_t>(y) * m_width + x;
+
+        float px = static_cast<float>(x);
+        float py = static_cast<float>(y);
+        float v[N];
+        for (int c = 0; c < N; ++c)
+          v[c] = m_in[c][i];
+
+        bool stop = false;
+        for (int k = 0; k <= m_niter && !stop; ++k)
+        {
+          const sums_t s = window_sums(x0, x1, y0, y1, px, py, v);
+          if (!(s.w > 0)) // Every weight underflows: keep the current estimate
+            break;
+
+          const float npx = s.x / s.w;
+          const float npy = s.y / s.w;
+          float       nv[N];
+          for (int c = 0; c < N; ++c)
+            nv[c] = s.v[c] / s.w;
+
+          stop = (npx == px && npy == py);
+          if (!stop)
+          {
+            float d = (px - npx) * (px - npx) + (py - npy) * (py - npy);
+            for (int c = 0; c < N; ++c)
+              d += (v[c] - nv[c]) * (v[c] - nv[c]);
+            stop = d < m_eps2;
+          }
+
+          px = npx;
+          py = npy;
+          for (int c = 0; c < N; ++c)
+            v[c] = nv[c];
+        }
+
+        for (int c = 0; c < N; ++c)
+          m_out[c][i] = v[c];
+      }
+
+      const float* m_in[N];
+      float*       m_out[N];
+      float        m_iota[WARP_SIZE];
+      int          m_width;
+      int          m_height;
+      float        m_inv_hs2;
+      float        m_inv_hr2;
+      float        m_eps2;
+      int          m_radius;
+      int          m_niter;
+    };
+
+
+    template <int N>
+    void meanshift_T(const float* in, float* out, int width, int height, float hs, float hr,
+                     const meanshift_params& params, bool parallel)
+    {
+      meanshift_t<N> algo(in, out, width, height, hs, hr, params);
+
+      auto process_rows = [&algo](const tbb::blocked_range<int>& rng) {
+        for (int y = rng.begin(); y < rng.end(); ++y)
+          algo.run_row(y);
+      };
+
+      if (parallel)
+        tbb::parallel_for(tbb::blocked_range<int>(0, height), process_rows);
+      else
+        process_rows(tbb::blocked_range<int>(0, height));
+    }
+  } // namespace
+
+
+  void meanshift(const float* in, float* out, int nchannels, int width, int height, float hs, float hr,
+                 const meanshift_params& params, bool parallel)
+  {
+    if (params.radius < 0 || params.max_iterations < 0)
+      throw std::runtime_error("The radius and the number of iterations of the meanshift must be non-negative.");
+
+    switch (nchannels)
+    {
+    case 1:
+      return meanshift_T<1>(in, out, width, height, hs, hr, params, parallel);
+    case 2:
+      return meanshift_T<2>(in, out, width, height, hs, hr, params, parallel);
+    case 3:
+      return meanshift_T<3>(in, out, width, height, hs, hr, params, parallel);
+    case 4:
+      return meanshift_T<4>(in, out, width, height, hs, hr, params, parallel);
+    default:
+      throw std::runtime_error("The meanshift supports images with at most 4 channels.");
+    }
+  }
+} // namespace mln::contrib::impl
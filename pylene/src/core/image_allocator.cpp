@@ -0,0 +1,229 @@
+#include <mln/core/image/image_allocator.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+
+namespace mln
+{
+  namespace
+  {
+    constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+
+    // The large blocks are aligned on the huge pages
+    std::size_t block_alignment(std::size_t n) noexcept
+    {
+      return n >= kHugePageSize ? kHugePageSize : image_allocator::alignment;
+    }
+
+    void* system_allocate(std::size_t n)
+    {
+      return ::operator new(n, std::align_val_t(block_alignment(n)));
+    }
+
+    void system_deallocate(void* p, std::size_t n) noexcept
+    {
+      ::operator delete(p, n, std::align_val_t(block_alignment(n)));
+    }
+
+
+    // Size classes: 4 classes per power of two, from 256 bytes
+    constexpr int         kMinClassLog2 = 8;
+    constexpr std::size_t kMinClassSize = std::size_t(1) << kMinClassLog2;
+
+    struct size_class_t
+    {
+      int         index;
+      std::size_t size;
+    };
+
+    size_class_t size_class(std::size_t n) noexcept
+    {
+      n = std::max(n, kMinClassSize + 1);
+
+      const int         k    = std::bit_width(n - 1) - 1; // 2^k < n ≤ 2^(k+1)
+      const std::size_t base = std::size_t(1) << k;
+      const std::size_t step = base / 4;
+      const std::size_t j    = (n - base + step - 1) / step; // 1..4
+
+      return {(k - kMinClassLog2) * 4 + static_cast<int>(j - 1), base + j * step};
+    }
+
+    // Size of the blocks of the class i
+    std::size_t class_size(int i) noexcept
+    {
+      const std::size_t base = kMinClassSize << (i / 4);
+      return base + (i % 4 + 1) * (base / 4);
+    }
+
+
+    // Function-local so that the images allocated during the static initialization get a valid allocator
+    struct global_allocator_t
+    {
+      std::mutex                       mutex;
+      std::shared_ptr<image_allocator> allocator = std::make_shared<default_image_allocator>();
+      std::atomic<std::uint64_t>       version   = 1; // Incremented when the allocator is replaced
+    };
+
+    global_allocator_t& global_allocator()
+    {
+      static global_allocator_t g;
+      return g;
+    }
+
+    thread_local std::shared_ptr<image_allocator> t_allocator; // Set by scoped_image_allocator
+
+    // Copy of the global allocator, refreshed when its version changes (no lock on the allocation path)
+    thread_local std::shared_ptr<image_allocator> t_global_allocator;
+    thread_local std::uint64_t                    t_global_version = 0;
+  } // namespace
+
+
+  void* default_image_allocator::allocate(std::size_t n)
+  {
+    return system_allocate(n);
+  }
+
+  void default_image_allocator::deallocate(void* p, std::size_t n) noexcept
+  {
+    system_deallocate(p, n);
+  }
+
+
+  pooled_image_allocator::pooled_image_allocator(std::size_t max_cached_bytes)
+    : m_max_cached_bytes{max_cached_bytes}
+  {
+  }
+
+  pooled_image_allocator::~pooled_image_allocator()
+  {
+    this->release();
+  }
+
+  void* pooled_image_allocator::allocate(std::size_t n)
+  {
+    const auto c = size_class(n);
+    {
+      std::scoped_lock lock(m_mutex);
+      if (c.index < static_cast<int>(m_free.size()) && !m_free[c.index].empty())
+      {
+        void* p = m_free[c.index].back();
+        m_free[c.index].pop_back();
+        m_stats.cached_bytes -= c.size;
+        m_stats.hits++;
+        return p;
+      }
+      m_stats.misses++;
+    }
+
+    void* p = system_allocate(c.size);
+#ifdef __linux__
+    if (c.size >= kHugePageSize)
+      ::madvise(p, c.size & ~(kHugePageSize - 1), MADV_HUGEPAGE);
+#endif
+    return p;
+  }
+
+  void pooled_image_allocator::deallocate(void* p, std::size_t n) noexcept
+  {
+    const auto c = size_class(n);
+    if (c.size > m_max_cached_bytes)
+    {
+      system_deallocate(p, c.size);
+      return;
+    }
+
+    std::scoped_lock lock(m_mutex);
+    try
+    {
+      if (c.index >= static_cast<int>(m_free.size()))
+        m_free.resize(c.index + 1);
+      m_free[c.index].push_back(p);
+    }
+    catch (const std::bad_alloc&)
+    {
+      system_deallocate(p, c.size);
+      return;
+    }
+
+    m_stats.cached_bytes += c.size;
+    if (m_stats.cached_bytes > m_max_cached_bytes)
+      this->evict(m_max_cached_bytes, true);
+  }
+
+  // Free the blocks of the largest classes until the cache holds at most target bytes (lock held)
+  void pooled_image_allocator::evict(std::size_t target, bool count) noexcept
+  {
+    for (int i = static_cast<int>(m_free.size()) - 1; i >= 0 && m_stats.cached_bytes > target; --i)
+    {
+      const std::size_t sz = class_size(i);
+      auto&             fl = m_free[i];
+      while (!fl.empty() && m_stats.cached_bytes > target)
+      {
+        system_deallocate(fl.back(), sz);
+        fl.pop_back();
+        m_stats.cached_bytes -= sz;
+        m_stats.evictions += count;
+      }
+    }
+  }
+
+  pooled_image_allocator::stats_t pooled_image_allocator::stats() const
+  {
+    std::scoped_lock lock(m_mutex);
+    return m_stats;
+  }
+
+  void pooled_image_allocator::release()
+  {
+    std::scoped_lock lock(m_mutex);
+    this->evict(0, false);
+  }
+
+
+  void set_image_allocator(std::shared_ptr<image_allocator> a)
+  {
+    if (!a)
+      a = std::make_shared<default_image_allocator>();
+
+    auto&            g = global_allocator();
+    std::scoped_lock lock(g.mutex);
+    g.allocator = std::move(a);
+    g.version.fetch_add(1, std::memory_order_release);
+  }
+
+  std::shared_ptr<image_allocator> get_image_allocator()
+  {
+    if (t_allocator)
+      return t_allocator;
+
+    auto& g = global_allocator();
+    if (g.version.load(std::memory_order_acquire) != t_global_version)
+    {
+      std::scoped_lock lock(g.mutex);
+      t_global_allocator = g.allocator;
+      t_global_version   = g.version.load(std::memory_order_relaxed);
+    }
+    return t_global_allocator;
+  }
+
+
+  scoped_image_allocator::scoped_image_allocator(std::shared_ptr<image_allocator> a)
+    : m_previous{std::move(t_allocator)}
+  {
+    t_allocator = std::move(a);
+  }
+
+  scoped_image_allocator::~scoped_image_allocator()
+  {
+    t_allocator = std::move(m_previous);
+  }
+
+} // namespace mln
@@ -4,14 +4,15 @@
 namespace mln::internal
 {
   __ndbuffer_image_data<void>::__ndbuffer_image_data(std::size_t n)
+    : m_allocator{get_image_allocator()}
   {
     m_size   = n;
-    m_buffer = m_allocator.allocate(m_size);
+    m_buffer = static_cast<std::byte*>(m_allocator->allocate(m_size));
   }
 
   __ndbuffer_image_data<void>::~__ndbuffer_image_data()
   {
-    m_allocator.deallocate(m_buffer, m_size);
+    m_allocator->deallocate(m_buffer, m_size);
   }
 
 } // namespace mln::internal
@@ -1,4 +1,5 @@
 #include <mln/core/canvas/parallel_local.hpp>
+#include <mln/core/trace.hpp>
 
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
@@ -6,15 +7,40 @@
 
 namespace mln
 {
+  namespace
+  {
+    /// \brief Attach the position of the tile \p roi of the grid of \p domain to the current trace scope
+    void annotate_tile(mln::box2d roi, mln::box2d domain, int tile_width, int tile_height)
+    {
+      if (!mln::trace::enabled())
+        return;
+
+      const int nx = (domain.width() + tile_width - 1) / tile_width;
+      const int tx = (roi.x() - domain.x()) / tile_width;
+      const int ty = (roi.y() - domain.y()) / tile_height;
+      mln::trace::annotate("tile", ty * nx + tx);
+      mln::trace::annotate("x", roi.x());
+      mln::trace::annotate("y", roi.y());
+      mln::trace::annotate("width", roi.width());
+      mln::trace::annotate("height", roi.height());
+    }
+  } // namespace
+
   class ParallelLocalCanvas2DImpl
   {
   public:
-    ParallelLocalCanvas2DImpl(ParallelLocalCanvas2DBase* delegate)
+    ParallelLocalCanvas2DImpl(ParallelLocalCanvas2DBase* delegate, mln::box2d domain, int tile_width, int tile_height)
+      : m_domain{domain}
+      , m_tile_width{tile_width}
+      , m_tile_height{tile_height}
     {
       m_delegate = delegate->clone();
     }
 
     ParallelLocalCanvas2DImpl(const ParallelLocalCanvas2DImpl& other)
+      : m_domain{other.m_domain}
+      , m_tile_width{other.m_tile_width}
+      , m_tile_height{other.m_tile_height}
     {
       m_delegate = other.m_delegate->clone();
     }
@@ -23,6 +49,9 @@ namespace mln
 
   private:
     std::unique_ptr<ParallelLocalCanvas2DBase> m_delegate = nullptr;
+    mln::box2d                                 m_domain;
+    int                                        m_tile_width;
+    int                                        m_tile_height;
   };
 
   void ParallelLocalCanvas2DImpl::operator()(const tbb::blocked_range2d<int>& tile) const
@@ -34,6 +63,8 @@ namespace mln
 
     mln::box2d roi(x, y, w, h);
 
+    mln_entering("mln::ParallelLocalCanvas2D::tile");
+    annotate_tile(roi, m_domain, m_tile_width, m_tile_height);
     m_delegate->ExecuteTile(roi);
   }
 
@@ -46,7 +77,7 @@ namespace mln
   */
   void ParallelLocalCanvas2DBase::execute_parallel(mln::box2d roi, int tile_width, int tile_height)
   {
-    ParallelLocalCanvas2DImpl wrapper(this);
+    ParallelLocalCanvas2DImpl wrapper(this, roi, tile_width, tile_height);
 
     tbb::blocked_range2d<int> rng(roi.y(), roi.y() + roi.height(), tile_height, //
                                   roi.x(), roi.x() + roi.width(), tile_width);
@@ -65,6 +96,9 @@ namespace mln
       {
         int w = std::min(tile_width, x1 - x);
         int h = std::min(tile_height, y1 - y);
+
+        mln_entering("mln::ParallelLocalCanvas2D::tile");
+        annotate_tile({x, y, w, h}, roi, tile_width, tile_height);
         this->ExecuteTile({x, y, w, h});
       }
   }
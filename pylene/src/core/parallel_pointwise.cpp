@@ -1,4 +1,5 @@
 #include <mln/core/canvas/parallel_pointwise.hpp>
+#include <mln/core/trace.hpp>
 
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
@@ -30,6 +31,21 @@ namespace mln
     int h = tile.rows().end() - tile.rows().begin();
 
     mln::box2d domain(x, y, w, h);
+
+    mln_entering("mln::ParallelCanvas2d::tile");
+    if (mln::trace::enabled())
+    {
+      // Index of the first tile of the block in the grid of the domain
+      const mln::box2d whole = m_delegate->GetDomain();
+      const int        nx    = (whole.width() + m_delegate->TILE_WIDTH - 1) / m_delegate->TILE_WIDTH;
+      const int        tx    = (x - whole.x()) / m_delegate->TILE_WIDTH;
+      const int        ty    = (y - whole.y()) / m_delegate->TILE_HEIGHT;
+      mln::trace::annotate("tile", ty * nx + tx);
+      mln::trace::annotate("x", x);
+      mln::trace::annotate("y", y);
+      mln::trace::annotate("width", w);
+      mln::trace::annotate("height", h);
+    }
     m_delegate->ExecuteTile(domain);
   }
 
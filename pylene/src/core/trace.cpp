@@ -1,12 +1,20 @@
 #include <mln/core/trace.hpp>
 #include <mln/core/assert.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <cstdlib> //getenv
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <vector>
 
 
 #ifdef _MSC_VER
@@ -16,67 +24,312 @@
 
 namespace mln::trace
 {
-  bool             verbose       = (std::getenv("TRACE") != NULL);
-  thread_local int __stack_depth = 0;
+  namespace
+  {
+    const auto kEpoch = std::chrono::steady_clock::now();
 
+    /// \brief Nanoseconds elapsed since the start of the process
+    std::int64_t now()
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch).count();
+    }
 
-  struct scoped_trace::impl_t
-  {
-    void entering(std::string_view view);
-    void exiting();
+    struct event_t
+    {
+      std::string_view     name;
+      std::int64_t         begin;
+      std::int64_t         end; // -1 for an instant event
+      int                  nargs;
+      scoped_trace::arg_t  args[scoped_trace::kMaxArgs];
+    };
 
-    int                                                m_depth;
-    std::string                                        m_desc;
-    std::chrono::time_point<std::chrono::system_clock> m_clock;
-  };
+    /// Ring buffer of the events of a thread. It is only written by its thread, the recorder keeps it alive after the
+    /// thread has exited and gives it to the next new thread.
+    struct thread_buffer
+    {
+      explicit thread_buffer(int tid)
+        : tid{tid}
+        , events(kBufferCapacity)
+      {
+      }
 
+      void push(const event_t& e)
+      {
+        auto n                        = count.load(std::memory_order_relaxed);
+        events[n % kBufferCapacity] = e;
+        count.store(n + 1, std::memory_order_release);
+      }
 
+      int                        tid;
+      std::vector<event_t>       events;
+      std::atomic<std::uint64_t> count = 0; // Number of events pushed since the last clear
+    };
 
-  void scoped_trace::impl_t::entering(std::string_view desc)
-  {
-    m_depth = __stack_depth++;
-    m_desc  = desc;
-    m_clock = std::chrono::system_clock::now();
+    struct recorder_t
+    {
+      std::mutex                                  mutex;
+      std::vector<std::unique_ptr<thread_buffer>> buffers;
+      std::vector<thread_buffer*>                 free_buffers; // The buffers of the exited threads
+    };
 
-    for (int k = 0; k < m_depth; ++k)
-      std::clog.put(' ');
-    std::clog << "#" << std::this_thread::get_id() << " - " << m_desc << std::endl;
-  }
+    // Never destroyed: the threads of the pool may still be running traced scopes at exit
+    recorder_t& recorder()
+    {
+      static recorder_t* r = new recorder_t;
+      return *r;
+    }
+
+    void dump_at_exit()
+    {
+      const char* filename = std::getenv("TRACE_FILE");
+      try
+      {
+        dump(filename);
+      }
+      catch (const std::exception& e)
+      {
+        std::fprintf(stderr, "Unable to write the trace: %s\n", e.what());
+      }
+    }
+
+    bool init_recording()
+    {
+      const char* filename = std::getenv("TRACE_FILE");
+      if (filename == nullptr || *filename == '\0')
+        return false;
+      std::atexit(dump_at_exit);
+      return true;
+    }
+
+    thread_local int            __stack_depth = 0;
+    thread_local scoped_trace*  __current     = nullptr;
+    thread_local thread_buffer* __buffer      = nullptr;
+    thread_local bool           __exited      = false;
+
+    /// Gives the buffer of the thread back to the recorder when the thread exits
+    struct buffer_owner_t
+    {
+      ~buffer_owner_t()
+      {
+        auto&            r = recorder();
+        std::scoped_lock lock(r.mutex);
+        r.free_buffers.push_back(__buffer);
+        __buffer = nullptr;
+        __exited = true; // The scopes run by the destructors of the other thread locals are not recorded
+      }
+    };
+
+    /// Return the buffer of the thread (nullptr if the thread is exiting)
+    thread_buffer* local_buffer()
+    {
+      if (__buffer == nullptr && !__exited)
+      {
+        thread_local buffer_owner_t owner; // Releases the buffer when the thread exits
+
+        auto&            r = recorder();
+        std::scoped_lock lock(r.mutex);
+        if (r.free_buffers.empty())
+        {
+          r.buffers.push_back(std::make_unique<thread_buffer>(static_cast<int>(r.buffers.size()) + 1));
+          __buffer = r.buffers.back().get();
+        }
+        else
+        {
+          // The events of the previous thread are kept, the new ones follow them under the same tid
+          __buffer = r.free_buffers.back();
+          r.free_buffers.pop_back();
+        }
+      }
+      return __buffer;
+    }
+
+    void indent(int depth)
+    {
+      for (int k = 0; k < depth; ++k)
+        std::clog.put(' ');
+    }
+
+    void write_string(std::ostream& os, std::string_view s)
+    {
+      os.put('"');
+      for (char c : s)
+      {
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+          os << buf;
+        }
+        else
+          os.put(c);
+      }
+      os.put('"');
+    }
+
+    // Chrome timestamps are in microseconds
+    void write_us(std::ostream& os, std::int64_t ns)
+    {
+      os << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+    }
+
+    void write_event(std::ostream& os, int tid, const event_t& e)
+    {
+      os << "{\"name\":";
+      write_string(os, e.name);
+      os << ",\"cat\":\"mln\",\"pid\":1,\"tid\":" << tid << ",\"ts\":";
+      write_us(os, e.begin);
+      if (e.end < 0)
+        os << ",\"ph\":\"i\",\"s\":\"t\"";
+      else
+      {
+        os << ",\"ph\":\"X\",\"dur\":";
+        write_us(os, e.end - e.begin);
+      }
+      if (e.nargs > 0)
+      {
+        os << ",\"args\":{";
+        for (int i = 0; i < e.nargs; ++i)
+        {
+          if (i > 0)
+            os.put(',');
+          write_string(os, e.args[i].key);
+          os << ':' << e.args[i].value;
+        }
+        os.put('}');
+      }
+      os.put('}');
+    }
+  } // namespace
+
+  std::atomic<bool> verbose   = (std::getenv("TRACE") != NULL);
+  std::atomic<bool> recording = init_recording();
 
 
-  void scoped_trace::impl_t::exiting()
+  struct scope_access
   {
-    --__stack_depth;
-    for (int k = 0; k < m_depth; ++k)
-      std::clog.put(' ');
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - m_clock);
-    std::clog << "#" << std::this_thread::get_id() << " - " << m_desc << " in " << duration.count() << "ms"
-              << std::endl;
-  }
+    static void annotate(scoped_trace& s, const char* key, std::int64_t value)
+    {
+      if (s.m_nargs < scoped_trace::kMaxArgs)
+        s.m_args[s.m_nargs++] = {key, value};
+    }
+  };
 
-  void scoped_trace::entering(std::string_view desc)
+
+  void scoped_trace::entering()
   {
-    mln_precondition(m_impl == nullptr);
-    m_impl = new impl_t();
-    m_impl->entering(desc);
+    mln_precondition(!m_active);
+    m_active = true;
+    m_depth  = __stack_depth++;
+    m_nargs  = 0;
+    m_parent = __current;
+    __current = this;
+
+    if (verbose.load(std::memory_order_relaxed))
+    {
+      indent(m_depth);
+      std::clog << "#" << std::this_thread::get_id() << " - " << m_desc << std::endl;
+    }
+    m_begin = now();
   }
 
+
   void scoped_trace::exiting()
   {
-    mln_precondition(m_impl != nullptr);
-    m_impl->exiting();
-    delete m_impl;
+    mln_precondition(m_active && __current == this);
+    const std::int64_t end = now();
+
+    --__stack_depth;
+    __current = m_parent;
+
+    if (recording.load(std::memory_order_relaxed))
+    {
+      if (auto* buffer = local_buffer())
+      {
+        event_t e{m_desc, m_begin, end, m_nargs, {}};
+        std::copy_n(m_args, m_nargs, e.args);
+        buffer->push(e);
+      }
+    }
+
+    if (verbose.load(std::memory_order_relaxed))
+    {
+      indent(m_depth);
+      std::clog << "#" << std::this_thread::get_id() << " - " << m_desc << " in " << (end - m_begin) / 1000000
+                << "ms";
+      for (int i = 0; i < m_nargs; ++i)
+        std::clog << (i == 0 ? " (" : ", ") << m_args[i].key << "=" << m_args[i].value;
+      std::clog << (m_nargs > 0 ? ")" : "") << std::endl;
+    }
   }
 
   namespace impl
   {
     void warn(std::string_view msg)
     {
-      for (int k = 0; k < __stack_depth; ++k)
-        std::clog.put(' ');
+      if (recording.load(std::memory_order_relaxed))
+        if (auto* buffer = local_buffer())
+          buffer->push(event_t{msg, now(), -1, 0, {}});
 
-      std::clog << "#" << std::this_thread::get_id() << " - " << msg << std::endl;
+      if (verbose.load(std::memory_order_relaxed))
+      {
+        indent(__stack_depth);
+        std::clog << "#" << std::this_thread::get_id() << " - " << msg << std::endl;
+      }
+    }
+
+    void annotate(const char* key, std::int64_t value)
+    {
+      if (__current)
+        scope_access::annotate(*__current, key, value);
     }
   } // namespace impl
 
+
+  void set_recording(bool enabled)
+  {
+    if (enabled)
+      recorder();
+    recording.store(enabled, std::memory_order_relaxed);
+  }
+
+  void clear()
+  {
+    auto&            r = recorder();
+    std::scoped_lock lock(r.mutex);
+    for (auto& b : r.buffers)
+      b->count.store(0, std::memory_order_relaxed);
+  }
+
+  void dump(std::ostream& os)
+  {
+    auto&            r = recorder();
+    std::scoped_lock lock(r.mutex);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"pylene\"}}";
+    for (const auto& b : r.buffers)
+    {
+      os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid
+         << ",\"args\":{\"name\":\"thread " << b->tid << "\"}}";
+
+      const std::uint64_t n     = b->count.load(std::memory_order_acquire);
+      const std::uint64_t first = n > kBufferCapacity ? n - kBufferCapacity : 0;
+      for (std::uint64_t i = first; i < n; ++i)
+      {
+        os << ",\n";
+        write_event(os, b->tid, b->events[i % kBufferCapacity]);
+      }
+    }
+    os << "\n]}\n";
+  }
+
+  void dump(const char* filename)
+  {
+    std::ofstream os(filename);
+    if (!os)
+      throw std::runtime_error(std::string("Unable to open the trace file ") + filename);
+    dump(os);
+  }
 } // namespace mln::trace
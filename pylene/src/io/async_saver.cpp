@@ -0,0 +1,102 @@
+#include <mln/io/async_saver.hpp>
+
+#include <mln/core/image/ndbuffer_image.hpp>
+#include <mln/io/private/freeimage_plugin.hpp>
+#include <mln/io/private/io.hpp>
+
+#include <tbb/task_arena.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+namespace mln::io
+{
+  struct async_saver::impl_t
+  {
+    tbb::task_arena         arena;
+    std::size_t             max_queued_bytes;
+    std::size_t             queued_bytes = 0; // Bytes of the images waiting or being encoded
+    int                     pending      = 0; // Number of images waiting or being encoded
+    std::mutex              mutex;
+    std::condition_variable cv;
+  };
+
+  namespace
+  {
+    std::size_t byte_size(const mln::ndbuffer_image& image)
+    {
+      std::size_t n = get_sample_type_id_traits(image.sample_type()).size();
+      for (int k = 0; k < image.pdim(); ++k)
+        n *= image.size(k);
+      return n;
+    }
+  } // namespace
+
+
+  async_saver::async_saver(std::size_t max_queued_bytes, int nthreads)
+  {
+    if (nthreads <= 0)
+      nthreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // No slot is reserved for the caller: the saves are only run by the workers of the arena
+    m_impl                   = std::make_unique<impl_t>();
+    m_impl->max_queued_bytes = max_queued_bytes;
+    m_impl->arena.initialize(nthreads, 0);
+  }
+
+  async_saver::~async_saver() { this->wait(); }
+
+  std::future<void> async_saver::save(mln::ndbuffer_image image, std::string filename)
+  {
+    const std::size_t size = byte_size(image);
+    impl_t*           impl = m_impl.get();
+
+    // Back-pressure: wait for the pending images to be written
+    {
+      std::unique_lock lock(impl->mutex);
+      impl->cv.wait(lock, [&] { return impl->pending == 0 || impl->queued_bytes + size <= impl->max_queued_bytes; });
+      impl->queued_bytes += size;
+      impl->pending++;
+    }
+
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future  = promise->get_future();
+
+    impl->arena.enqueue([impl, size, promise, image = std::move(image), filename = std::move(filename)]() {
+      try
+      {
+        internal::freeimage_writer_plugin p;
+        internal::save(image, &p, filename.c_str());
+        promise->set_value();
+      }
+      catch (...)
+      {
+        promise->set_exception(std::current_exception());
+      }
+
+      // Notify under the lock: the saver may be destroyed as soon as the last pending save is released
+      std::lock_guard lock(impl->mutex);
+      impl->queued_bytes -= size;
+      impl->pending--;
+      impl->cv.notify_all();
+    });
+
+    return future;
+  }
+
+  void async_saver::wait()
+  {
+    std::unique_lock lock(m_impl->mutex);
+    m_impl->cv.wait(lock, [&] { return m_impl->pending == 0; });
+  }
+
+  std::size_t async_saver::queued_bytes() const
+  {
+    std::lock_guard lock(m_impl->mutex);
+    return m_impl->queued_bytes;
+  }
+
+} // namespace mln::io
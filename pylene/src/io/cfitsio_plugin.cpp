@@ -7,8 +7,11 @@
 #include <fitsio.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
 
 namespace mln::io::fits
 {
@@ -39,29 +42,135 @@ namespace mln::io::fits
         return {};
       }
 
+      [[noreturn]] void throw_fits_error(int status)
+      {
+        char msg[80];
+        fits_get_errstatus(status, msg);
+        throw std::runtime_error(fmt::format("Unable to read the image ({})", msg));
+      }
+
       struct impl_cfitsio_t : mln::io::internal::plugin_base::impl_t
       {
         fitsfile* file = nullptr;
         int       datatype;
+        int       sample_size;
+        long      image_dims[4]; // Dimensions of the whole image
 
         void read_next_line(std::byte* __restrict buffer) final
+        {
+          if (m_subset)
+            read_subset_line(buffer);
+          else
+            read_whole_line(buffer);
+          m_line++;
+        }
+
+        void write_next_line(const std::byte* /* buffer */) final { std::abort(); }
+
+        // Restrict the reads to a region of the image and restart from its first line
+        void select(mln::ConstBoxRef roi)
+        {
+          if (roi.dim() != m_ndim)
+            throw std::runtime_error(fmt::format("The region has {} dimensions (expected {})", roi.dim(), m_ndim));
+
+          for (int k = 0; k < m_ndim; ++k)
+          {
+            if (roi.tl()[k] < 0 || roi.br()[k] > image_dims[k] || roi.size(k) <= 0)
+              throw std::runtime_error("The region is empty or not included in the image");
+            m_begin[k] = roi.tl()[k];
+            m_dims[k]  = roi.size(k);
+          }
+
+          m_subset      = true;
+          m_line        = 0;
+          m_block_first = -1;
+          m_block_rows  = 1;
+
+          // The tile-compressed images are decompressed by tiles: read the rows of a tile at once
+          int status = 0;
+          if (m_ndim > 1 && fits_is_compressed_image(file, &status))
+          {
+            long tile[4] = {1, 1, 1, 1};
+            fits_get_tile_dim(file, m_ndim, tile, &status);
+            if (status)
+              throw_fits_error(status);
+            m_block_rows = static_cast<int>(tile[1]);
+          }
+
+          // A block holds the rows of a tile that are in the region
+          if (m_block_rows > 1)
+            m_block.resize(static_cast<std::size_t>(std::min<long>(m_block_rows, m_dims[1])) * m_dims[0] * sample_size);
+        }
+
+      private:
+        void read_whole_line(std::byte* __restrict buffer)
         {
           int anynul;
           int status = 0;
           fits_read_img(file, datatype, m_line * m_dims[0] + 1, m_dims[0], nullptr, buffer, &anynul, &status);
           if (status)
+            throw_fits_error(status);
+        }
+
+        // Read rows [y, y + n) of the region at the plane of the current line (cfitsio coordinates are 1-based)
+        void read_subset(long y, long n, void* buffer)
+        {
+          long fpixel[4], lpixel[4], inc[4] = {1, 1, 1, 1};
+          fpixel[0] = m_begin[0] + 1;
+          lpixel[0] = m_begin[0] + m_dims[0];
+
+          long l = m_line;
+          for (int k = 1; k < m_ndim; ++k)
           {
-            char msg[80];
-            fits_get_errstatus(status, msg);
-            throw std::runtime_error(fmt::format("Unable to read the image ({})", msg));
+            long c = l % m_dims[k];
+            l /= m_dims[k];
+            fpixel[k] = lpixel[k] = m_begin[k] + c + 1;
           }
-          m_line++;
+          if (m_ndim > 1)
+          {
+            fpixel[1] = m_begin[1] + y + 1;
+            lpixel[1] = m_begin[1] + y + n;
+          }
+
+          int anynul;
+          int status = 0;
+          fits_read_subset(file, datatype, fpixel, lpixel, inc, nullptr, buffer, &anynul, &status);
+          if (status)
+            throw_fits_error(status);
         }
 
-        void write_next_line(const std::byte* /* buffer */) final { std::abort(); }
+        void read_subset_line(std::byte* __restrict buffer)
+        {
+          // Position of the line in its plane
+          const long y = (m_ndim > 1) ? m_line % m_dims[1] : 0;
 
-      private:
-        int m_line = 0;
+          if (m_block_rows == 1)
+          {
+            read_subset(y, 1, buffer);
+            return;
+          }
+
+          // The blocks are aligned on the tiles of the file (absolute rows), clipped to the region
+          const long tile  = (m_begin[1] + y) / m_block_rows;
+          const long y0    = std::max<long>(tile * m_block_rows - m_begin[1], 0);
+          const long y1    = std::min<long>((tile + 1) * m_block_rows - m_begin[1], m_dims[1]);
+          const long first = m_line - y + y0;
+          if (first != m_block_first)
+          {
+            read_subset(y0, y1 - y0, m_block.data());
+            m_block_first = first;
+          }
+
+          const std::size_t line_size = static_cast<std::size_t>(m_dims[0]) * sample_size;
+          std::memcpy(buffer, m_block.data() + (m_line - first) * line_size, line_size);
+        }
+
+        long                   m_line   = 0;
+        bool                   m_subset = false;
+        int                    m_begin[4];
+        int                    m_block_rows  = 1;  // Number of rows read at once
+        long                   m_block_first = -1; // Index of the first line in m_block
+        std::vector<std::byte> m_block;
       };
     } // namespace
 
@@ -70,6 +179,12 @@ namespace mln::io::fits
     {
     }
 
+    cfitsio_reader_plugin::cfitsio_reader_plugin(int ind, mln::ConstBoxRef roi)
+      : m_image_index(ind)
+      , m_roi(mln::Box(roi.tl(), roi.br()))
+    {
+    }
+
     cfitsio_reader_plugin::~cfitsio_reader_plugin() { this->close(); }
 
     void cfitsio_reader_plugin::open(const char* filename)
@@ -82,6 +197,10 @@ namespace mln::io::fits
       if (status)
         throw std::runtime_error(fmt::format("Unable to read the file {}", filename));
 
+      auto impl  = std::make_unique<impl_cfitsio_t>();
+      impl->file = file;
+      this->m_impl = std::move(impl);
+
       // Go to the index of the image
       fits_movrel_hdu(file, m_image_index, nullptr, &status);
       if (status)
@@ -108,15 +227,34 @@ namespace mln::io::fits
       fits_get_img_type(file, &type, &status);
       const auto [sample_type, datatype] = get_type_info(type);
 
-      auto impl    = std::make_unique<impl_cfitsio_t>();
-      impl->file   = file;
-      impl->m_ndim = ndim;
+      auto* p   = static_cast<impl_cfitsio_t*>(this->m_impl.get());
+      p->m_ndim = ndim;
       for (int i = 0; i < ndim; i++)
-        impl->m_dims[i] = dims[i];
-      impl->m_sample_type_id = sample_type;
-      impl->datatype = datatype;
+      {
+        p->m_dims[i]       = dims[i];
+        p->image_dims[i]   = dims[i];
+      }
+      p->m_sample_type_id = sample_type;
+      p->datatype         = datatype;
+      p->sample_size      = static_cast<int>(get_sample_type_id_traits(sample_type).size());
 
-      this->m_impl = std::move(impl);
+      if (m_roi)
+        p->select(*m_roi);
+    }
+
+    void cfitsio_reader_plugin::select(mln::ConstBoxRef roi)
+    {
+      static_cast<impl_cfitsio_t*>(this->m_impl.get())->select(roi);
+    }
+
+    mln::Box cfitsio_reader_plugin::image_domain() const
+    {
+      auto* p = static_cast<const impl_cfitsio_t*>(this->m_impl.get());
+
+      int begin[4] = {0}, end[4];
+      for (int k = 0; k < p->m_ndim; ++k)
+        end[k] = static_cast<int>(p->image_dims[k]);
+      return mln::Box(mln::ConstPointRef{p->m_ndim, begin}, mln::ConstPointRef{p->m_ndim, end});
     }
 
     void cfitsio_reader_plugin::close()
@@ -124,7 +262,7 @@ namespace mln::io::fits
       auto* impl = static_cast<impl_cfitsio_t*>(this->m_impl.get());
       if (impl && impl->file)
       {
-        int status;
+        int status = 0;
         fits_close_file(impl->file, &status);
         impl->file = nullptr;
       }
@@ -143,4 +281,49 @@ namespace mln::io::fits
     internal::cfitsio_reader_plugin p(ind);
     mln::io::internal::load(&p, filename.c_str(), out);
   }
+
+  mln::ndbuffer_image imread(const std::string& filename, mln::ConstBoxRef roi, int ind)
+  {
+    mln::ndbuffer_image out;
+    imread(filename, roi, out, ind);
+    return out;
+  }
+
+  void imread(const std::string& filename, mln::ConstBoxRef roi, mln::ndbuffer_image& out, int ind)
+  {
+    internal::cfitsio_reader_plugin p(ind, roi);
+    mln::io::internal::load(&p, filename.c_str(), out);
+    out.set_domain_topleft(roi.tl());
+  }
+
+
+  strip_reader::strip_reader(const std::string& filename, int strip_size, int ind)
+    : m_plugin(std::make_unique<internal::cfitsio_reader_plugin>(ind))
+    , m_strip_size(strip_size)
+  {
+    if (strip_size <= 0)
+      throw std::runtime_error("The size of the strips must be positive");
+    m_plugin->open(filename.c_str());
+  }
+
+  strip_reader::~strip_reader() = default;
+
+  mln::Box strip_reader::domain() const { return m_plugin->image_domain(); }
+
+  bool strip_reader::next(mln::ndbuffer_image& out)
+  {
+    mln::Box  roi  = this->domain();
+    const int last = roi.dim() - 1;
+    if (m_next >= roi.br()[last])
+      return false;
+
+    roi.tl()[last] = m_next;
+    roi.br()[last] = std::min(m_next + m_strip_size, roi.br()[last]);
+    m_next         = roi.br()[last];
+
+    m_plugin->select(roi);
+    mln::io::internal::read(m_plugin.get(), out);
+    out.set_domain_topleft(roi.tl());
+    return true;
+  }
 } // namespace mln::io::fits
\ No newline at end of file
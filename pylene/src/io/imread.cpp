@@ -1,11 +1,40 @@
 #include <mln/io/imread.hpp>
 
 #include <mln/core/image/ndbuffer_image.hpp>
+#include <mln/core/trace.hpp>
 #include <mln/io/private/freeimage_plugin.hpp>
 #include <mln/io/private/io.hpp>
+#include <mln/io/private/pnm_plugin.hpp>
+
+#include <tbb/parallel_pipeline.h>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace mln::io
 {
+  namespace
+  {
+    // Call f with the reader plugin of the file
+    template <class F>
+    void with_reader(const std::string& filename, F f)
+    {
+      // The binary PNM files are read directly into the image buffer
+      if (internal::pnm_reader_plugin::can_read(filename.c_str()))
+      {
+        internal::pnm_reader_plugin p;
+        f(&p);
+      }
+      else
+      {
+        internal::freeimage_reader_plugin p;
+        f(&p);
+      }
+    }
+  } // namespace
+
   mln::ndbuffer_image imread(const std::string& filename)
   {
     mln::ndbuffer_image out;
@@ -15,7 +44,80 @@ namespace mln::io
 
   void imread(const std::string& filename, mln::ndbuffer_image& out)
   {
-    internal::freeimage_reader_plugin p;
-    internal::load(&p, filename.c_str(), out);
+    with_reader(filename, [&](internal::plugin_reader* p) { internal::load(p, filename.c_str(), out); });
+  }
+
+
+  namespace
+  {
+    struct batch_item
+    {
+      std::size_t         index;
+      mln::ndbuffer_image image;
+    };
+
+    // The images released by the callback, reused for the next files
+    class image_pool
+    {
+    public:
+      mln::ndbuffer_image acquire()
+      {
+        std::lock_guard lock(m_mutex);
+        if (m_images.empty())
+          return {};
+
+        auto ima = std::move(m_images.back());
+        m_images.pop_back();
+        return ima;
+      }
+
+      void release(mln::ndbuffer_image&& ima)
+      {
+        std::lock_guard lock(m_mutex);
+        m_images.push_back(std::move(ima));
+      }
+
+    private:
+      std::mutex                       m_mutex;
+      std::vector<mln::ndbuffer_image> m_images;
+    };
+  } // namespace
+
+  void imread_batch(std::span<const std::string>                                  paths,
+                    const std::function<void(std::size_t, mln::ndbuffer_image&)>& callback, int max_in_flight)
+  {
+    mln_entering("mln::io::imread_batch");
+
+    if (max_in_flight <= 0)
+      max_in_flight = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    image_pool  pool;
+    std::size_t next = 0;
+
+    auto produce = [&](tbb::flow_control& fc) -> std::size_t {
+      if (next == paths.size())
+      {
+        fc.stop();
+        return 0;
+      }
+      return next++;
+    };
+
+    auto decode = [&](std::size_t i) {
+      batch_item item = {i, pool.acquire()};
+      with_reader(paths[i], [&](internal::plugin_reader* p) { internal::load(p, paths[i].c_str(), item.image, true); });
+      return item;
+    };
+
+    auto consume = [&](batch_item item) {
+      callback(item.index, item.image);
+      pool.release(std::move(item.image));
+    };
+
+    // The number of tokens bounds the number of images alive at the same time
+    tbb::parallel_pipeline(static_cast<std::size_t>(max_in_flight),
+                           tbb::make_filter<void, std::size_t>(tbb::filter_mode::serial_in_order, produce) &
+                               tbb::make_filter<std::size_t, batch_item>(tbb::filter_mode::parallel, decode) &
+                               tbb::make_filter<batch_item, void>(tbb::filter_mode::serial_in_order, consume));
   }
 } // namespace mln::io
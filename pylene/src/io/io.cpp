@@ -12,15 +12,26 @@
 namespace mln::io::internal
 {
 
-  void load(plugin_reader* p, const char* filename, mln::ndbuffer_image& output)
+  void load(plugin_reader* p, const char* filename, mln::ndbuffer_image& output, bool recycle)
   {
     // Read header
     p->open(filename);
 
+    read(p, output, recycle);
+
+    // Close handle
+    p->close();
+  }
+
+  void read(plugin_reader* p, mln::ndbuffer_image& output, bool recycle)
+  {
     // Allocate image
     int            pdim   = p->get_ndim();
     sample_type_id tid    = p->get_sample_type_id();
 
+    if (recycle && (output.sample_type() != tid || output.pdim() != pdim))
+      output = mln::ndbuffer_image();
+
     if (output.sample_type() != sample_type_id::OTHER && output.sample_type() != tid)
       throw std::runtime_error(
           fmt::format("Sample type mismatch. The input is {} (requested: {}).", (int)tid, (int)output.sample_type()));
@@ -28,13 +39,23 @@ namespace mln::io::internal
     if (output.pdim() != 0 && output.pdim() != pdim)
       throw std::runtime_error(fmt::format("Number of dimensions mismath (={}) (should be {}).", output.pdim(), pdim));
 
-    output.resize(tid, pdim, p->get_dim_array(), image_build_params{});
+    // Reuse the storage of the output if it has the right layout and it is not shared with another image
+    bool reuse = output.sample_type() == tid && output.pdim() == pdim && output.__data().use_count() == 1;
+    for (int k = 0; k < pdim && reuse; ++k)
+      reuse = output.size(k) == p->get_dim(k);
+
+    if (reuse)
+    {
+      int origin[16] = {0};
+      output.set_domain_topleft(ConstPointRef{pdim, origin});
+    }
+    else
+    {
+      output.resize(tid, pdim, p->get_dim_array(), image_build_params{});
+    }
 
     // Fill content (up to 4 dimensions for now)
     mln::canvas::details::apply_line(output, std::bind(&plugin_reader::read_next_line, p, std::placeholders::_1));
-
-    // Close handle
-    p->close();
   }
 
   void save(const mln::ndbuffer_image& input, plugin_writer* p, const char* filename)
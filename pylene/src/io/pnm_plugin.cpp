@@ -0,0 +1,198 @@
+#include <mln/io/private/pnm_plugin.hpp>
+#include <fmt/core.h>
+#include <stdexcept>
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace mln::io::internal
+{
+
+  namespace
+  {
+
+    struct pnm_header
+    {
+      char kind; // '4', '5' or '6'
+      int  width;
+      int  height;
+      int  maxval;
+    };
+
+    // Read a decimal number of the header, skipping the whitespaces and the comments
+    bool read_header_int(std::FILE* f, int& value)
+    {
+      int c = std::fgetc(f);
+      while (c != EOF && (std::isspace(c) || c == '#'))
+      {
+        if (c == '#')
+          while (c != EOF && c != '\n')
+            c = std::fgetc(f);
+        c = std::fgetc(f);
+      }
+
+      if (c == EOF || !std::isdigit(c))
+        return false;
+
+      long v = 0;
+      for (; c != EOF && std::isdigit(c); c = std::fgetc(f))
+      {
+        v = v * 10 + (c - '0');
+        if (v > (1 << 30))
+          return false;
+      }
+
+      // A single whitespace separates the header from the raster
+      if (c == EOF || !std::isspace(c))
+        return false;
+
+      value = static_cast<int>(v);
+      return true;
+    }
+
+    bool read_header(std::FILE* f, pnm_header& h)
+    {
+      char magic[2];
+      if (std::fread(magic, 1, 2, f) != 2 || magic[0] != 'P' || magic[1] < '4' || magic[1] > '6')
+        return false;
+
+      h.kind   = magic[1];
+      h.maxval = 1;
+      if (!read_header_int(f, h.width) || !read_header_int(f, h.height))
+        return false;
+      if (h.kind != '4' && !read_header_int(f, h.maxval))
+        return false;
+
+      // The samples are copied without rescaling: the other maxvals are left to FreeImage, which rescales them
+      const bool full_range = h.kind == '4' || h.maxval == 255 || (h.kind == '5' && h.maxval == 65535);
+      return h.width > 0 && h.height > 0 && full_range;
+    }
+
+
+    struct impl_base_t : plugin_base::impl_t
+    {
+      std::FILE* m_file = nullptr;
+
+      void read_line(void* buffer, std::size_t n)
+      {
+        if (std::fread(buffer, 1, n, m_file) != n)
+          throw std::runtime_error("Unexpected end of PNM file.");
+      }
+
+      void write_next_line(const std::byte* /* buffer */) final { std::abort(); }
+    };
+
+    // P5 (8 bits, maxval 255) and P6 (maxval 255): the file line has the layout of the image line
+    struct impl_raw_t : impl_base_t
+    {
+      std::size_t m_line_size;
+
+      void read_next_line(std::byte* buffer) final { this->read_line(buffer, m_line_size); }
+    };
+
+    // P5 (16 bits, maxval 65535): big-endian samples
+    struct impl_raw16_t : impl_base_t
+    {
+      void read_next_line(std::byte* buffer) final
+      {
+        this->read_line(buffer, m_dims[0] * 2);
+
+        auto* p = reinterpret_cast<std::uint8_t*>(buffer);
+        for (int x = 0; x < m_dims[0]; ++x)
+        {
+          std::uint16_t v = static_cast<std::uint16_t>(p[2 * x] << 8 | p[2 * x + 1]);
+          std::memcpy(p + 2 * x, &v, 2);
+        }
+      }
+    };
+
+    // P4: packed bits - 1 is black
+    struct impl_bit_t : impl_base_t
+    {
+      std::vector<std::uint8_t> m_line;
+
+      void read_next_line(std::byte* __restrict buffer) final
+      {
+        this->read_line(m_line.data(), m_line.size());
+        for (int x = 0; x < m_dims[0]; ++x)
+          buffer[x] = std::byte((m_line[x / 8] & (0x80 >> (x % 8))) == 0);
+      }
+    };
+  }
+
+  bool pnm_reader_plugin::can_read(const char* filename)
+  {
+    std::FILE* f = std::fopen(filename, "rb");
+    if (!f)
+      return false;
+
+    pnm_header h;
+    bool       res = read_header(f, h);
+    std::fclose(f);
+    return res;
+  }
+
+  void pnm_reader_plugin::open(const char* filename)
+  {
+    std::FILE* f = std::fopen(filename, "rb");
+    if (!f)
+      throw std::runtime_error(fmt::format("Unable to open the file {}.", filename));
+
+    pnm_header h;
+    if (!read_header(f, h))
+    {
+      std::fclose(f);
+      throw std::runtime_error("File format not supported");
+    }
+
+    std::unique_ptr<impl_base_t> impl;
+    sample_type_id               sid;
+    if (h.kind == '4')
+    {
+      auto p = std::make_unique<impl_bit_t>();
+      p->m_line.resize((h.width + 7) / 8);
+      impl = std::move(p);
+      sid  = sample_type_id::BOOL;
+    }
+    else if (h.kind == '5' && h.maxval > 255)
+    {
+      impl = std::make_unique<impl_raw16_t>();
+      sid  = sample_type_id::UINT16;
+    }
+    else
+    {
+      auto p         = std::make_unique<impl_raw_t>();
+      p->m_line_size = static_cast<std::size_t>(h.width) * (h.kind == '6' ? 3 : 1);
+      impl           = std::move(p);
+      sid            = (h.kind == '6') ? sample_type_id::RGB8 : sample_type_id::UINT8;
+    }
+
+    impl->m_file           = f;
+    impl->m_ndim           = 2;
+    impl->m_dims[0]        = h.width;
+    impl->m_dims[1]        = h.height;
+    impl->m_sample_type_id = sid;
+
+    m_impl = std::move(impl);
+  }
+
+  void pnm_reader_plugin::close()
+  {
+    auto impl = static_cast<impl_base_t*>(m_impl.get());
+    if (impl && impl->m_file)
+    {
+      std::fclose(impl->m_file);
+      impl->m_file = nullptr;
+    }
+  }
+
+  pnm_reader_plugin::~pnm_reader_plugin()
+  {
+    this->close();
+  }
+}
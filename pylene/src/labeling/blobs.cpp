@@ -0,0 +1,388 @@
+#include <mln/labeling/blobs.hpp>
+
+#include <mln/bp/utils.hpp>
+#include <mln/core/image/ndbuffer_image.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+namespace mln::labeling::impl
+{
+  namespace
+  {
+    constexpr int kStripHeight = 128;
+
+    // A read-only view over the binary input buffer
+    struct input_view_t
+    {
+      const std::uint8_t* buffer;
+      int                 width;
+      int                 height;
+      std::ptrdiff_t      stride;
+      mln::point2d        origin; // Coordinates of the first pixel of the buffer
+
+      const std::uint8_t* row(int y) const noexcept { return mln::bp::ptr_offset(buffer, y * stride); }
+    };
+
+    struct run_t
+    {
+      int x0; // First pixel of the run
+      int x1; // Past-the-end pixel of the run
+    };
+
+    // The runs of a horizontal strip of the image [y0, y1)
+    // The runs of the row y are runs[row_begin[y - y0]:row_begin[y - y0 + 1]]
+    struct strip_t
+    {
+      int                y0;
+      int                y1;
+      std::vector<run_t> runs;
+      std::vector<int>   row_begin;
+      std::vector<int>   parent;
+    };
+
+
+    // Return the first position >= x such that (row[x] != 0) == fg (or width if there is none)
+    // The whole batches that do not contain any transition are skipped with simd comparisons.
+    template <bool fg>
+    int find_next(const std::uint8_t* __restrict row, int x, int width) noexcept
+    {
+      using simd_t = xsimd::simd_type<std::uint8_t>;
+      constexpr int WARP_SIZE = simd_t::size;
+
+      const simd_t zero(0);
+
+      // Scalar prologue until the next batch boundary
+      for (; x < width && (x % WARP_SIZE) != 0; ++x)
+        if ((row[x] != 0) == fg)
+          return x;
+
+      for (; x + WARP_SIZE <= width; x += WARP_SIZE)
+      {
+        simd_t v;
+        xsimd::load_unaligned(row + x, v);
+        if constexpr (fg)
+        {
+          if (xsimd::any(v != zero))
+            break;
+        }
+        else
+        {
+          if (!xsimd::all(v != zero))
+            break;
+        }
+      }
+
+      for (; x < width; ++x)
+        if ((row[x] != 0) == fg)
+          return x;
+      return width;
+    }
+
+    void extract_runs(const std::uint8_t* row, int width, std::vector<run_t>& runs)
+    {
+      int x = find_next<true>(row, 0, width);
+      while (x < width)
+      {
+        int x1 = find_next<false>(row, x + 1, width);
+        runs.push_back({x, x1});
+        x = find_next<true>(row, x1 + 1, width);
+      }
+    }
+
+
+    // Path halving. Since the root of a set is its smallest element, parent[x] <= x holds for every x.
+    int find_root(int* parent, int x) noexcept
+    {
+      while (parent[x] != x)
+      {
+        parent[x] = parent[parent[x]];
+        x         = parent[x];
+      }
+      return x;
+    }
+
+    void merge(int* parent, int a, int b) noexcept
+    {
+      a = find_root(parent, a);
+      b = find_root(parent, b);
+      if (a < b)
+        parent[b] = a;
+      else if (b < a)
+        parent[a] = b;
+    }
+
+    // Merge the overlapping runs of two consecutive rows
+    // \param prev The runs of the upper row (whose indexes start at prev_offset)
+    // \param cur The runs of the lower row (whose indexes start at cur_offset)
+    // \param d 0 for the 4-connectivity, 1 for the 8-connectivity
+    void merge_rows(const run_t* prev, int prev_count, int prev_offset, const run_t* cur, int cur_count,
+                    int cur_offset, int d, int* parent) noexcept
+    {
+      int i = 0, j = 0;
+      while (i < prev_count && j < cur_count)
+      {
+        if (prev[i].x1 + d <= cur[j].x0)
+          ++i;
+        else if (cur[j].x1 + d <= prev[i].x0)
+          ++j;
+        else
+        {
+          merge(parent, prev_offset + i, cur_offset + j);
+          if (prev[i].x1 < cur[j].x1)
+            ++i;
+          else
+            ++j;
+        }
+      }
+    }
+
+    // Extract and merge the runs of the strip (indexes are local to the strip)
+    void label_strip(const input_view_t& input, int d, strip_t& strip)
+    {
+      const int h = strip.y1 - strip.y0;
+      strip.row_begin.resize(h + 1);
+
+      for (int i = 0; i < h; ++i)
+      {
+        strip.row_begin[i] = static_cast<int>(strip.runs.size());
+        extract_runs(input.row(strip.y0 + i), input.width, strip.runs);
+      }
+      strip.row_begin[h] = static_cast<int>(strip.runs.size());
+
+      const int n = static_cast<int>(strip.runs.size());
+      strip.parent.resize(n);
+      for (int k = 0; k < n; ++k)
+        strip.parent[k] = k;
+
+      for (int i = 1; i < h; ++i)
+      {
+        int pb = strip.row_begin[i - 1], cb = strip.row_begin[i], ce = strip.row_begin[i + 1];
+        merge_rows(strip.runs.data() + pb, cb - pb, pb, strip.runs.data() + cb, ce - cb, cb, d, strip.parent.data());
+      }
+    }
+
+
+    template <class Label>
+    void paint_strip(const strip_t& strip, const int* labels, const mln::bp::Tile2DView<Label>& out)
+    {
+      const int h = strip.y1 - strip.y0;
+      for (int i = 0; i < h; ++i)
+      {
+        Label* lineptr = out.row(strip.y0 + i);
+        int    x       = 0;
+        for (int k = strip.row_begin[i]; k < strip.row_begin[i + 1]; ++k)
+        {
+          auto r = strip.runs[k];
+          std::fill(lineptr + x, lineptr + r.x0, Label(0));
+          std::fill(lineptr + r.x0, lineptr + r.x1, static_cast<Label>(labels[k]));
+          x = r.x1;
+        }
+        std::fill(lineptr + x, lineptr + out.width(), Label(0));
+      }
+    }
+
+    template <class Label>
+    int blobs_runs2d_T(const input_view_t& input, const mln::bp::Tile2DView<Label>& out,
+                       bool c8, bool parallel, std::vector<blob_attributes>* attributes)
+    {
+      const int d       = c8 ? 1 : 0;
+      const int height  = input.height;
+      const int nstrips = parallel ? std::max(1, (height + kStripHeight - 1) / kStripHeight) : 1;
+
+      std::vector<strip_t> strips(nstrips);
+      for (int s = 0; s < nstrips; ++s)
+      {
+        strips[s].y0 = std::min(height, s * kStripHeight);
+        strips[s].y1 = (s == nstrips - 1) ? height : std::min(height, (s + 1) * kStripHeight);
+      }
+
+      // 1. Label each strip independently
+      auto label_strips = [&](const tbb::blocked_range<int>& rng) {
+        for (int s = rng.begin(); s < rng.end(); ++s)
+          label_strip(input, d, strips[s]);
+      };
+
+      // 2. Gather the union-find forests (the run indexes are offset by the number of runs of the previous strips)
+      std::vector<int> offsets(nstrips + 1, 0);
+      auto             gather_strips = [&](const tbb::blocked_range<int>& rng, int* parent) {
+        for (int s = rng.begin(); s < rng.end(); ++s)
+        {
+          const int off = offsets[s];
+          const int n   = static_cast<int>(strips[s].parent.size());
+          for (int k = 0; k < n; ++k)
+            parent[off + k] = off + strips[s].parent[k];
+          strips[s].parent = {};
+        }
+      };
+
+      if (parallel)
+        tbb::parallel_for(tbb::blocked_range<int>(0, nstrips), label_strips);
+      else
+        label_strips(tbb::blocked_range<int>(0, nstrips));
+
+      for (int s = 0; s < nstrips; ++s)
+        offsets[s + 1] = offsets[s] + static_cast<int>(strips[s].runs.size());
+
+      const int        nruns = offsets[nstrips];
+      std::vector<int> parent(nruns);
+      if (parallel)
+        tbb::parallel_for(tbb::blocked_range<int>(0, nstrips),
+                          [&](const tbb::blocked_range<int>& rng) { gather_strips(rng, parent.data()); });
+      else
+        gather_strips(tbb::blocked_range<int>(0, nstrips), parent.data());
+
+      // 3. Merge the strips along their boundaries
+      for (int s = 1; s < nstrips; ++s)
+      {
+        const strip_t& a = strips[s - 1];
+        const strip_t& b = strips[s];
+        if (a.y0 == a.y1 || b.y0 == b.y1)
+          continue;
+
+        const int ab = a.row_begin[a.y1 - a.y0 - 1], ae = a.row_begin[a.y1 - a.y0];
+        const int bb = b.row_begin[0], be = b.row_begin[1];
+        merge_rows(a.runs.data() + ab, ae - ab, offsets[s - 1] + ab, b.runs.data() + bb, be - bb, offsets[s] + bb, d,
+                   parent.data());
+      }
+
+      // 4. Resolve the labels in raster order. parent[k] < k for non-root runs, so its label is already final.
+      constexpr int LBL_MAX = std::numeric_limits<Label>::max();
+
+      int nlabel = 0;
+      for (int k = 0; k < nruns; ++k)
+      {
+        if (parent[k] == k)
+        {
+          if (nlabel++ >= LBL_MAX)
+            throw std::runtime_error("Detected overflow in the number of labels.");
+          parent[k] = nlabel;
+        }
+        else
+        {
+          parent[k] = parent[parent[k]];
+        }
+      }
+      // Now parent[k] holds the label of the run k (reuse the buffer)
+      const int* labels = parent.data();
+
+
+      // 5. Compute the attributes from the runs (in the coordinates of the domain, as the generic implementation)
+      if (attributes)
+      {
+        const int ox = input.origin.x();
+        const int oy = input.origin.y();
+
+        struct acc_t
+        {
+          std::size_t count = 0;
+          double      sx = 0, sy = 0;
+          int         x0 = std::numeric_limits<int>::max(), y0 = std::numeric_limits<int>::max();
+          int         x1 = std::numeric_limits<int>::min(), y1 = std::numeric_limits<int>::min();
+        };
+        std::vector<acc_t> acc(nlabel + 1);
+
+        for (int s = 0; s < nstrips; ++s)
+          for (int i = 0; i < strips[s].y1 - strips[s].y0; ++i)
+          {
+            const int y = oy + strips[s].y0 + i;
+            for (int k = strips[s].row_begin[i]; k < strips[s].row_begin[i + 1]; ++k)
+            {
+              auto  r = strips[s].runs[k];
+              r.x0 += ox;
+              r.x1 += ox;
+              auto& a = acc[labels[offsets[s] + k]];
+              int   n = r.x1 - r.x0;
+              a.count += n;
+              a.sx += 0.5 * double(r.x0 + r.x1 - 1) * n;
+              a.sy += double(y) * n;
+              a.x0 = std::min(a.x0, r.x0);
+              a.x1 = std::max(a.x1, r.x1 - 1);
+              a.y0 = std::min(a.y0, y);
+              a.y1 = std::max(a.y1, y);
+            }
+          }
+
+        attributes->assign(nlabel + 1, blob_attributes{});
+        for (int i = 1; i <= nlabel; ++i)
+        {
+          const auto& a    = acc[i];
+          (*attributes)[i] = blob_attributes{.area       = a.count,
+                                             .bbox       = mln::box2d(a.x0, a.y0, a.x1 - a.x0 + 1, a.y1 - a.y0 + 1),
+                                             .centroid_x = static_cast<float>(a.sx / a.count),
+                                             .centroid_y = static_cast<float>(a.sy / a.count)};
+        }
+      }
+
+      // 6. Write the labels
+      auto paint_strips = [&](const tbb::blocked_range<int>& rng) {
+        for (int s = rng.begin(); s < rng.end(); ++s)
+          paint_strip(strips[s], labels + offsets[s], out);
+      };
+
+      if (parallel)
+        tbb::parallel_for(tbb::blocked_range<int>(0, nstrips), paint_strips);
+      else
+        paint_strips(tbb::blocked_range<int>(0, nstrips));
+
+      return nlabel;
+    }
+
+    template <class Label>
+    int blobs_runs2d_T(const input_view_t& input, mln::ndbuffer_image& output, bool c8,
+                       bool parallel, std::vector<blob_attributes>* attributes)
+    {
+      auto out = output.__cast<Label, 2>().as_tile();
+      return blobs_runs2d_T<Label>(input, out, c8, parallel, attributes);
+    }
+
+  } // namespace
+
+
+  int blobs_runs2d(const mln::ndbuffer_image& input, mln::ndbuffer_image& output, bool c8, bool parallel,
+                   std::vector<blob_attributes>* attributes)
+  {
+    if (input.pdim() != 2 || output.pdim() != 2 || input.width() != output.width() ||
+        input.height() != output.height())
+      throw std::runtime_error("Invalid input/output images (2D images of same dimensions are expected)");
+
+    switch (input.sample_type())
+    {
+    case sample_type_id::BOOL:
+    case sample_type_id::UINT8:
+    case sample_type_id::INT8:
+      break;
+    default:
+      throw std::runtime_error("Invalid input image type (should be bool, uint8 or int8).");
+    }
+
+    const auto tl = input.domain().tl();
+    auto       in = input_view_t{reinterpret_cast<const std::uint8_t*>(input.buffer()), input.width(), input.height(),
+                           input.byte_stride(), mln::point2d{tl.x(), tl.y()}};
+
+    switch (output.sample_type())
+    {
+    case sample_type_id::INT8:
+      return blobs_runs2d_T<std::int8_t>(in, output, c8, parallel, attributes);
+    case sample_type_id::UINT8:
+      return blobs_runs2d_T<std::uint8_t>(in, output, c8, parallel, attributes);
+    case sample_type_id::INT16:
+      return blobs_runs2d_T<std::int16_t>(in, output, c8, parallel, attributes);
+    case sample_type_id::UINT16:
+      return blobs_runs2d_T<std::uint16_t>(in, output, c8, parallel, attributes);
+    case sample_type_id::INT32:
+      return blobs_runs2d_T<std::int32_t>(in, output, c8, parallel, attributes);
+    default:
+      throw std::runtime_error("Invalid label image type.");
+    }
+  }
+} // namespace mln::labeling::impl
@@ -0,0 +1,317 @@
+#include <mln/labeling/chamfer_distance_transform.hpp>
+
+#include <mln/bp/utils.hpp>
+#include <mln/core/trace.hpp>
+
+#include <tbb/parallel_for_each.h>
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <vector>
+
+
+namespace mln::labeling::impl
+{
+  namespace
+  {
+    // Size of the tiles processed by a task in the parallel wavefront
+    constexpr int kTileWidth  = 256;
+    constexpr int kTileHeight = 32;
+
+    template <class T>
+    struct woffset_t
+    {
+      int dx;
+      int dy;
+      T   w;
+      T   cap; // max - w, so that min(x, cap) + w is the saturated sum
+    };
+
+    template <class T>
+    struct kernel_t
+    {
+      std::vector<woffset_t<T>> before_rows; // Offsets of the forward scan in the previous rows
+      std::vector<woffset_t<T>> before_line; // Offsets of the forward scan in the current row
+      std::vector<woffset_t<T>> after_rows;  // Offsets of the backward scan in the next rows
+      std::vector<woffset_t<T>> after_line;  // Offsets of the backward scan in the current row
+      int                       radius = 0;
+    };
+
+    template <class T>
+    [[gnu::always_inline]] inline T add_saturate(T x, const woffset_t<T>& o) noexcept
+    {
+      return static_cast<T>(std::min(x, o.cap) + o.w);
+    }
+
+    // r[x] = min(r[x], q[x] +ₛ w) for x in [a, b)
+    // r and q are different rows, so the whole range is processed with simd min-plus
+    template <class T>
+    void minplus_row(T* __restrict r, const T* __restrict q, const woffset_t<T>& o, int a, int b) noexcept
+    {
+      using simd_t            = xsimd::simd_type<T>;
+      constexpr int WARP_SIZE = simd_t::size;
+
+      const simd_t w(o.w);
+      const simd_t cap(o.cap);
+
+      int x = a;
+      for (; x + WARP_SIZE <= b; x += WARP_SIZE)
+      {
+        simd_t vr = xsimd::load_unaligned(r + x);
+        simd_t vq = xsimd::load_unaligned(q + x);
+        xsimd::store_unaligned(r + x, xsimd::min(vr, xsimd::min(vq, cap) + w));
+      }
+      for (; x < b; ++x)
+        r[x] = std::min(r[x], add_saturate(q[x], o));
+    }
+
+
+    template <class T, class U>
+    class chamfer_2d_t
+    {
+    public:
+      chamfer_2d_t(const ndbuffer_image& input, ndbuffer_image& output, const kernel_t<T>& k)
+        : m_in(input.buffer())
+        , m_in_stride(input.byte_stride(1))
+        , m_out(reinterpret_cast<T*>(output.buffer()))
+        , m_out_stride(output.byte_stride(1))
+        , m_width(output.width())
+        , m_height(output.height())
+        , m_k(k)
+      {
+      }
+
+      void run(bool parallel)
+      {
+        if (m_width == 0 || m_height == 0)
+          return;
+
+        if (parallel)
+        {
+          scan<true>(kTileWidth, kTileHeight);
+          scan<false>(kTileWidth, kTileHeight);
+        }
+        else
+        {
+          // Whole rows
+          for (int y = 0; y < m_height; ++y)
+            forward_row(y, 0, m_width);
+          for (int y = m_height - 1; y >= 0; --y)
+            backward_row(y, 0, m_width);
+        }
+      }
+
+    private:
+      T* row(int y) const noexcept { return bp::ptr_offset(m_out, y * m_out_stride); }
+
+      // Forward scan of the row y on [a,b): the previous rows are final, and so is the row on [0, a)
+      void forward_row(int y, int a, int b) const noexcept
+      {
+        T*       r  = row(y);
+        const U* in = static_cast<const U*>(bp::ptr_offset(m_in, y * m_in_stride));
+
+        // The background pixels are set to 0 and stay to 0 (the weights are non-negative)
+        for (int x = a; x < b; ++x)
+          r[x] = in[x] ? std::numeric_limits<T>::max() : T(0);
+
+        for (const auto& o : m_k.before_rows)
+          minplus_row(r, row(y + o.dy) + o.dx, o, a, b);
+
+        for (int x = a; x < b; ++x)
+          for (const auto& o : m_k.before_line)
+            r[x] = std::min(r[x], add_saturate(r[x + o.dx], o));
+      }
+
+      // Backward scan of the row y on [a,b): the next rows are final, and so is the row on [b, width)
+      void backward_row(int y, int a, int b) const noexcept
+      {
+        T* r = row(y);
+
+        for (const auto& o : m_k.after_rows)
+          minplus_row(r, row(y + o.dy) + o.dx, o, a, b);
+
+        for (int x = b - 1; x >= a; --x)
+          for (const auto& o : m_k.after_line)
+            r[x] = std::min(r[x], add_saturate(r[x + o.dx], o));
+      }
+
+      /// Wavefront scan of the image by tiles
+      ///
+      /// The rows are grouped in bands of \p h rows, split in tiles of \p w columns. To make the tiles of a band
+      /// independent of the next tile on their previous rows, the tiles are skewed: the l-th row of a band is shifted
+      /// by -l × radius columns. The tile (i, j) depends on the tile (i, j-1) (same band) and on the tile (i-1, j+s)
+      /// (previous band), where s = ⌈h × radius / w⌉. The backward scan runs the same schedule on the mirrored image.
+      template <bool forward>
+      void scan(int w, int h)
+      {
+        const int r      = m_k.radius;
+        const int nbands = (m_height + h - 1) / h;
+        const int ntiles = (m_width + r * (h - 1) + w - 1) / w;
+        const int skew   = (h * r + w - 1) / w;
+        const int ntotal = nbands * ntiles;
+
+        auto counters = std::make_unique<std::atomic<int>[]>(ntotal);
+        for (int i = 0; i < nbands; ++i)
+          for (int j = 0; j < ntiles; ++j)
+            counters[i * ntiles + j].store((i > 0) + (j > 0), std::memory_order_relaxed);
+
+        auto process_tile = [&](int i, int j) {
+          const int l_end = std::min(h, m_height - i * h);
+          for (int l = 0; l < l_end; ++l)
+          {
+            int a = std::clamp(j * w - l * r, 0, m_width);
+            int b = std::clamp((j + 1) * w - l * r, 0, m_width);
+            if (a >= b)
+              continue;
+
+            const int k = i * h + l;
+            if constexpr (forward)
+              forward_row(k, a, b);
+            else
+              backward_row(m_height - 1 - k, m_width - b, m_width - a);
+          }
+        };
+
+        auto body = [&](int t, tbb::feeder<int>& feeder) {
+          const int i = t / ntiles;
+          const int j = t % ntiles;
+          process_tile(i, j);
+
+          auto release = [&](int i2, int j2) {
+            int t2 = i2 * ntiles + j2;
+            if (counters[t2].fetch_sub(1, std::memory_order_acq_rel) == 1)
+              feeder.add(t2);
+          };
+
+          if (j + 1 < ntiles)
+            release(i, j + 1);
+
+          // The tiles of the next band depending on this one
+          if (i + 1 < nbands)
+          {
+            if (j + 1 < ntiles)
+            {
+              if (j - skew >= 0)
+                release(i + 1, j - skew);
+            }
+            else
+            {
+              for (int j2 = std::max(0, j - skew); j2 < ntiles; ++j2)
+                release(i + 1, j2);
+            }
+          }
+        };
+
+        int start = 0;
+        tbb::parallel_for_each(&start, &start + 1, body);
+      }
+
+      const void*        m_in;
+      std::ptrdiff_t     m_in_stride;
+      T*                 m_out;
+      std::ptrdiff_t     m_out_stride;
+      int                m_width;
+      int                m_height;
+      const kernel_t<T>& m_k;
+    };
+
+
+    template <class T, class U>
+    void chamfer_distance_transform_2d_T(const ndbuffer_image& input, ndbuffer_image& output, const kernel_t<T>& k,
+                                         bool parallel)
+    {
+      chamfer_2d_t<T, U> algo(input, output, k);
+      algo.run(parallel);
+    }
+
+    template <class T>
+    bool chamfer_distance_transform_2d_T(const ndbuffer_image& input, std::span<const chamfer_weight2d> weights,
+                                         ndbuffer_image& output, bool parallel)
+    {
+      kernel_t<T> k;
+      for (const auto& [dx, dy, weight] : weights)
+      {
+        if (weight < 0 || (dx == 0 && dy == 0))
+          return false;
+
+        const T w = static_cast<T>(weight);
+
+        woffset_t<T> o = {dx, dy, w, static_cast<T>(std::numeric_limits<T>::max() - w)};
+        if (dy < 0)
+          k.before_rows.push_back(o);
+        else if (dy > 0)
+          k.after_rows.push_back(o);
+        else if (dx < 0)
+          k.before_line.push_back(o);
+        else
+          k.after_line.push_back(o);
+        k.radius = std::max({k.radius, std::abs(dx), std::abs(dy)});
+      }
+
+      // The rows out of the domain are read from the extension
+      if (output.border() < k.radius)
+        return false;
+
+      switch (input.sample_type())
+      {
+      case sample_type_id::BOOL:
+      case sample_type_id::UINT8:
+      case sample_type_id::INT8:
+        chamfer_distance_transform_2d_T<T, std::uint8_t>(input, output, k, parallel);
+        return true;
+      case sample_type_id::UINT16:
+      case sample_type_id::INT16:
+        chamfer_distance_transform_2d_T<T, std::uint16_t>(input, output, k, parallel);
+        return true;
+      case sample_type_id::UINT32:
+      case sample_type_id::INT32:
+        chamfer_distance_transform_2d_T<T, std::uint32_t>(input, output, k, parallel);
+        return true;
+      case sample_type_id::UINT64:
+      case sample_type_id::INT64:
+        chamfer_distance_transform_2d_T<T, std::uint64_t>(input, output, k, parallel);
+        return true;
+      default:
+        return false;
+      }
+    }
+  } // namespace
+
+
+  bool chamfer_distance_transform_2d(const ndbuffer_image& input, std::span<const chamfer_weight2d> weights,
+                                     ndbuffer_image& output, bool parallel)
+  {
+    if (input.pdim() != 2 || output.pdim() != 2 || input.width() != output.width() ||
+        input.height() != output.height())
+      return false;
+
+    mln_entering("mln::labeling::chamfer_distance_transform_2d");
+
+    switch (output.sample_type())
+    {
+    case sample_type_id::UINT8:
+      return chamfer_distance_transform_2d_T<std::uint8_t>(input, weights, output, parallel);
+    case sample_type_id::INT8:
+      return chamfer_distance_transform_2d_T<std::int8_t>(input, weights, output, parallel);
+    case sample_type_id::UINT16:
+      return chamfer_distance_transform_2d_T<std::uint16_t>(input, weights, output, parallel);
+    case sample_type_id::INT16:
+      return chamfer_distance_transform_2d_T<std::int16_t>(input, weights, output, parallel);
+    case sample_type_id::UINT32:
+      return chamfer_distance_transform_2d_T<std::uint32_t>(input, weights, output, parallel);
+    case sample_type_id::INT32:
+      return chamfer_distance_transform_2d_T<std::int32_t>(input, weights, output, parallel);
+    case sample_type_id::FLOAT:
+      return chamfer_distance_transform_2d_T<float>(input, weights, output, parallel);
+    case sample_type_id::DOUBLE:
+      return chamfer_distance_transform_2d_T<double>(input, weights, output, parallel);
+    default:
+      return false;
+    }
+  }
+} // namespace mln::labeling::impl
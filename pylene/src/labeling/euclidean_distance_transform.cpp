@@ -0,0 +1,289 @@
+#include <mln/labeling/euclidean_distance_transform.hpp>
+
+#include <mln/bp/utils.hpp>
+#include <mln/core/trace.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+
+namespace mln::labeling
+{
+  namespace
+  {
+    constexpr double kInf = std::numeric_limits<double>::infinity();
+
+    ///
+    /// Lower envelope of the parabolas x ↦ (x - p)² + f(p) of a sampled function (Felzenszwalb & Huttenlocher)
+    ///
+    /// \param f The values of the function (+∞ for the positions that are not sites)
+    /// \param n The number of samples
+    /// \param s The sampling step
+    /// \param d (out) The value of the lower envelope at each position
+    /// \param arg (out) The site of the parabola reaching the envelope at each position (-1 if there is no site)
+    /// \param v, z Scratch buffers of size n and n + 1
+    void lower_envelope(const double* __restrict f, int n, double s, double* __restrict d, int* __restrict arg,
+                        int* __restrict v, double* __restrict z) noexcept
+    {
+      int k = -1;
+      for (int q = 0; q < n; ++q)
+      {
+        if (f[q] == kInf)
+          continue;
+
+        const double xq = q * s;
+        double       b  = -kInf;
+        while (k >= 0)
+        {
+          const double xv = v[k] * s;
+          b               = ((f[q] + xq * xq) - (f[v[k]] + xv * xv)) / (2 * (xq - xv));
+          if (b > z[k])
+            break;
+          --k;
+        }
+        if (k < 0)
+          b = -kInf;
+        ++k;
+        v[k] = q;
+        z[k] = b;
+      }
+
+      if (k < 0)
+      {
+        std::fill_n(d, n, kInf);
+        std::fill_n(arg, n, -1);
+        return;
+      }
+
+      for (int q = 0, j = 0; q < n; ++q)
+      {
+        const double xq = q * s;
+        while (j < k && z[j + 1] < xq)
+          ++j;
+        const double dx = xq - v[j] * s;
+        d[q]            = dx * dx + f[v[j]];
+        arg[q]          = v[j];
+      }
+    }
+
+    // Scratch buffers used to process a line
+    template <int D>
+    struct line_buffers_t
+    {
+      std::vector<double>     f, d, z;
+      std::vector<int>        v, arg;
+      std::vector<ndpoint<D>> feat;
+
+      explicit line_buffers_t(int n)
+        : f(n)
+        , d(n)
+        , z(n + 1)
+        , v(n)
+        , arg(n)
+        , feat(n)
+      {
+      }
+    };
+
+    ///
+    /// One separable pass of the distance transform along the given axis
+    ///
+    /// The first pass (axis 0) reads the input binary image, the other ones update the squared distance (and feature)
+    /// images in place. The lines of a pass are independent and are processed in parallel if required.
+    template <int D>
+    void edt_pass(int axis, const __ndbuffer_image<bool, D>& input, __ndbuffer_image<float, D>& dist,
+                  __ndbuffer_image<ndpoint<D>, D>* feat, double spacing, bool parallel)
+    {
+      const auto domain = input.domain();
+      const auto tl     = domain.tl();
+
+      int sizes[D];
+      for (int k = 0; k < D; ++k)
+        sizes[k] = domain.size(k);
+
+      // The axes orthogonal to the line
+      int other[D - 1];
+      for (int k = 0, i = 0; k < D; ++k)
+        if (k != axis)
+          other[i++] = k;
+
+      int nlines = 1;
+      for (int k : other)
+        nlines *= sizes[k];
+
+      const int n = sizes[axis];
+      if (n == 0 || nlines == 0)
+        return;
+
+      const std::ptrdiff_t in_step   = input.byte_stride(axis);
+      const std::ptrdiff_t dist_step = dist.byte_stride(axis);
+      const std::ptrdiff_t feat_step = feat ? feat->byte_stride(axis) : 0;
+
+      auto process_lines = [&](const tbb::blocked_range<int>& rng) {
+        line_buffers_t<D> buf(n);
+
+        for (int l = rng.begin(); l < rng.end(); ++l)
+        {
+          // Coordinates (relative to the top-left corner) of the first point of the line
+          ndpoint<D> p;
+          p[axis] = 0;
+          for (int i = 0, r = l; i < D - 1; ++i)
+          {
+            p[other[i]] = r % sizes[other[i]];
+            r /= sizes[other[i]];
+          }
+
+          std::ptrdiff_t in_offset = 0, dist_offset = 0, feat_offset = 0;
+          for (int k : other)
+          {
+            in_offset += p[k] * input.byte_stride(k);
+            dist_offset += p[k] * dist.byte_stride(k);
+            if (feat)
+              feat_offset += p[k] * feat->byte_stride(k);
+          }
+
+          float*      dline = bp::ptr_offset(dist.buffer(), dist_offset);
+          ndpoint<D>* fline = feat ? bp::ptr_offset(feat->buffer(), feat_offset) : nullptr;
+
+          // Gather
+          if (axis == 0)
+          {
+            const bool* iline = bp::ptr_offset(input.buffer(), in_offset);
+            for (int i = 0; i < n; ++i)
+              buf.f[i] = *bp::ptr_offset(iline, i * in_step) ? kInf : 0.0;
+          }
+          else
+          {
+            for (int i = 0; i < n; ++i)
+              buf.f[i] = *bp::ptr_offset(dline, i * dist_step);
+            if (fline)
+              for (int i = 0; i < n; ++i)
+                buf.feat[i] = *bp::ptr_offset(fline, i * feat_step);
+          }
+
+          lower_envelope(buf.f.data(), n, spacing, buf.d.data(), buf.arg.data(), buf.v.data(), buf.z.data());
+
+          // Scatter
+          for (int i = 0; i < n; ++i)
+            *bp::ptr_offset(dline, i * dist_step) = static_cast<float>(buf.d[i]);
+
+          if (fline)
+          {
+            for (int i = 0; i < n; ++i)
+            {
+              ndpoint<D>& out = *bp::ptr_offset(fline, i * feat_step);
+              if (axis == 0)
+              {
+                out       = p + tl;
+                out[axis] = (buf.arg[i] < 0 ? i : buf.arg[i]) + tl[axis];
+              }
+              else if (buf.arg[i] >= 0)
+              {
+                out = buf.feat[buf.arg[i]];
+              }
+            }
+          }
+        }
+      };
+
+      if (parallel)
+        tbb::parallel_for(tbb::blocked_range<int>(0, nlines), process_lines);
+      else
+        process_lines(tbb::blocked_range<int>(0, nlines));
+    }
+
+    template <int D>
+    void edt(const __ndbuffer_image<bool, D>& input, std::span<const float> spacing, __ndbuffer_image<float, D>& dist,
+             __ndbuffer_image<ndpoint<D>, D>* feat, bool parallel)
+    {
+      mln_entering("mln::labeling::euclidean_distance_transform");
+
+      if (!spacing.empty() && spacing.size() != static_cast<std::size_t>(D))
+        throw std::runtime_error("The spacing must be given for every axis of the image.");
+      if (std::any_of(spacing.begin(), spacing.end(), [](float s) { return !(s > 0); }))
+        throw std::runtime_error("The spacing must be positive.");
+
+      dist.resize(input.domain());
+      if (feat)
+        feat->resize(input.domain());
+
+      for (int axis = 0; axis < D; ++axis)
+        edt_pass(axis, input, dist, feat, spacing.empty() ? 1.0 : spacing[axis], parallel);
+    }
+
+    template <int D>
+    __ndbuffer_image<float, D> sedt_T(const __ndbuffer_image<bool, D>& input, std::span<const float> spacing,
+                                      bool parallel)
+    {
+      __ndbuffer_image<float, D> dist;
+      edt<D>(input, spacing, dist, nullptr, parallel);
+      return dist;
+    }
+
+    template <int D>
+    __ndbuffer_image<ndpoint<D>, D> eft_T(const __ndbuffer_image<bool, D>& input, std::span<const float> spacing,
+                                          __ndbuffer_image<float, D>* sqdist, bool parallel)
+    {
+      __ndbuffer_image<float, D>      dist;
+      __ndbuffer_image<ndpoint<D>, D> feat;
+      edt<D>(input, spacing, dist, &feat, parallel);
+      if (sqdist)
+        *sqdist = dist;
+      return feat;
+    }
+  } // namespace
+
+
+  image2d<float> squared_euclidean_distance_transform(const image2d<bool>& input, std::span<const float> spacing)
+  {
+    return sedt_T<2>(input, spacing, false);
+  }
+
+  image3d<float> squared_euclidean_distance_transform(const image3d<bool>& input, std::span<const float> spacing)
+  {
+    return sedt_T<3>(input, spacing, false);
+  }
+
+  image2d<point2d> euclidean_feature_transform(const image2d<bool>& input, std::span<const float> spacing,
+                                               image2d<float>* sqdist)
+  {
+    return eft_T<2>(input, spacing, sqdist, false);
+  }
+
+  image3d<point3d> euclidean_feature_transform(const image3d<bool>& input, std::span<const float> spacing,
+                                               image3d<float>* sqdist)
+  {
+    return eft_T<3>(input, spacing, sqdist, false);
+  }
+
+  namespace parallel
+  {
+    image2d<float> squared_euclidean_distance_transform(const image2d<bool>& input, std::span<const float> spacing)
+    {
+      return sedt_T<2>(input, spacing, true);
+    }
+
+    image3d<float> squared_euclidean_distance_transform(const image3d<bool>& input, std::span<const float> spacing)
+    {
+      return sedt_T<3>(input, spacing, true);
+    }
+
+    image2d<point2d> euclidean_feature_transform(const image2d<bool>& input, std::span<const float> spacing,
+                                                 image2d<float>* sqdist)
+    {
+      return eft_T<2>(input, spacing, sqdist, true);
+    }
+
+    image3d<point3d> euclidean_feature_transform(const image3d<bool>& input, std::span<const float> spacing,
+                                                 image3d<float>* sqdist)
+    {
+      return eft_T<3>(input, spacing, sqdist, true);
+    }
+  } // namespace parallel
+} // namespace mln::labeling
@@ -1,9 +1,89 @@
 #include <mln/morpho/private/immersion.spe.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <cassert>
+
 namespace mln::morpho::details
 {
   namespace
   {
+    // Number of rows processed by a task
+    constexpr int kRowGrain = 16;
+
+    // out[2x] = [f(x), f(x)] and out[2x+1] = [f(x) ∧ f(x+1), f(x) ∨ f(x+1)]
+    // The min/max are vectorized, the interleaving of the 4 values of each input pixel is left to the compiler.
+    template <class T>
+    void interval_immersion_simd(const T* __restrict f, std::size_t n, irange<T>* __restrict out) noexcept
+    {
+      using simd_t                    = xsimd::simd_type<T>;
+      constexpr std::size_t WARP_SIZE = simd_t::size;
+
+      if (n == 0)
+        return;
+
+      T*          o = reinterpret_cast<T*>(out);
+      T           m[WARP_SIZE], M[WARP_SIZE];
+      std::size_t x = 0;
+      for (; x + WARP_SIZE < n; x += WARP_SIZE)
+      {
+        simd_t a = xsimd::load_unaligned(f + x);
+        simd_t b = xsimd::load_unaligned(f + x + 1);
+        xsimd::store_unaligned(m, xsimd::min(a, b));
+        xsimd::store_unaligned(M, xsimd::max(a, b));
+
+        T* q = o + 4 * x;
+        for (std::size_t i = 0; i < WARP_SIZE; ++i)
+        {
+          q[4 * i + 0] = f[x + i];
+          q[4 * i + 1] = f[x + i];
+          q[4 * i + 2] = m[i];
+          q[4 * i + 3] = M[i];
+        }
+      }
+      for (; x + 1 < n; ++x)
+      {
+        auto [a, b]    = std::minmax(f[x], f[x + 1]);
+        out[2 * x]     = {f[x], f[x]};
+        out[2 * x + 1] = {a, b};
+      }
+      out[2 * x] = {f[x], f[x]};
+    }
+
+    // The intervals are read as a flat buffer of bounds: the even lanes hold the inf bounds (min), the odd lanes the
+    // sup bounds (max). The SIMD width is even, so a mask selects the min or the max in every lane.
+    template <class T>
+    void interval_interpolation_simd(const irange<T>* __restrict A, const irange<T>* __restrict B, std::size_t n,
+                                     irange<T>* __restrict out) noexcept
+    {
+      using simd_t                    = xsimd::simd_type<T>;
+      constexpr std::size_t WARP_SIZE = simd_t::size;
+      static_assert(WARP_SIZE % 2 == 0);
+
+      const T* a = reinterpret_cast<const T*>(A);
+      const T* b = reinterpret_cast<const T*>(B);
+      T*       o = reinterpret_cast<T*>(out);
+
+      T pattern[WARP_SIZE];
+      for (std::size_t i = 0; i < WARP_SIZE; ++i)
+        pattern[i] = (i % 2 == 0) ? static_cast<T>(~T(0)) : T(0);
+      const simd_t inf_mask = xsimd::load_unaligned(pattern);
+
+      const std::size_t count = 2 * n;
+      std::size_t       i     = 0;
+      for (; i + WARP_SIZE <= count; i += WARP_SIZE)
+      {
+        simd_t va = xsimd::load_unaligned(a + i);
+        simd_t vb = xsimd::load_unaligned(b + i);
+        xsimd::store_unaligned(o + i, (xsimd::min(va, vb) & inf_mask) | (xsimd::max(va, vb) & ~inf_mask));
+      }
+      for (; i < count; ++i)
+        o[i] = (i % 2 == 0) ? std::min(a[i], b[i]) : std::max(a[i], b[i]);
+    }
+
     void immersion_image2d(std::byte*                   i_buffer,   //
                            std::byte*                   inf_buffer, //
                            std::byte*                   sup_buffer, //
@@ -48,6 +128,83 @@ namespace mln::morpho::details
 
   } // namespace
 
+  void buffer_interval_immersion(const std::uint8_t* __restrict input, std::size_t n,
+                                 irange<std::uint8_t>* __restrict out)
+  {
+    interval_immersion_simd(input, n, out);
+  }
+
+  void buffer_interval_immersion(const std::uint16_t* __restrict input, std::size_t n,
+                                 irange<std::uint16_t>* __restrict out)
+  {
+    interval_immersion_simd(input, n, out);
+  }
+
+  void buffer_interval_interpolation(const irange<std::uint8_t>* __restrict A, const irange<std::uint8_t>* __restrict B,
+                                     std::size_t n, irange<std::uint8_t>* __restrict out)
+  {
+    interval_interpolation_simd(A, B, n, out);
+  }
+
+  void buffer_interval_interpolation(const irange<std::uint16_t>* __restrict A,
+                                     const irange<std::uint16_t>* __restrict B, std::size_t n,
+                                     irange<std::uint16_t>* __restrict out)
+  {
+    interval_interpolation_simd(A, B, n, out);
+  }
+
+
+  void interval_immersion_ndimage(ndbuffer_image& input, ndbuffer_image& out,
+                                  interval_immersion_impl_table_base_t* impl)
+  {
+    [[maybe_unused]] int pdim = input.pdim();
+    assert(pdim == 2 || pdim == 3);
+    assert(out.pdim() == pdim);
+
+    const int depth  = input.depth();
+    const int height = input.height();
+    const int width  = input.width();
+    if (width == 0 || height == 0 || depth == 0)
+      return;
+
+    const std::ptrdiff_t i_stride       = input.byte_stride(1);
+    const std::ptrdiff_t o_stride       = out.byte_stride(1);
+    const std::ptrdiff_t i_slice_stride = (pdim == 3) ? input.byte_stride(2) : 0;
+    const std::ptrdiff_t o_slice_stride = (pdim == 3) ? out.byte_stride(2) : 0;
+
+    // Rows of the input and of the immersed image
+    auto irow = [&](int z, int y) { return input.buffer() + z * i_slice_stride + y * i_stride; };
+    auto orow = [&](int z, int y) { return out.buffer() + z * o_slice_stride + y * o_stride; };
+
+    const int ow = 2 * width - 1;
+    const int oh = 2 * height - 1;
+
+    auto for_each_row = [](int n, auto f) {
+      tbb::parallel_for(tbb::blocked_range<int>(0, n, kRowGrain), [&f](const tbb::blocked_range<int>& rng) {
+        for (int r = rng.begin(); r < rng.end(); ++r)
+          f(r);
+      });
+    };
+
+    // 1. Even rows of the even slices
+    for_each_row(depth * height, [&](int r) {
+      int z = r / height, y = r % height;
+      impl->immersion(irow(z, y), width, orow(2 * z, 2 * y));
+    });
+
+    // 2. Odd rows of the even slices
+    for_each_row(depth * (height - 1), [&](int r) {
+      int z = r / (height - 1), y = r % (height - 1) + 1;
+      impl->interpolation(orow(2 * z, 2 * y - 2), orow(2 * z, 2 * y), ow, orow(2 * z, 2 * y - 1));
+    });
+
+    // 3. Odd slices
+    for_each_row((depth - 1) * oh, [&](int r) {
+      int z = r / oh + 1, y = r % oh;
+      impl->interpolation(orow(2 * z - 2, y), orow(2 * z, y), ow, orow(2 * z - 1, y));
+    });
+  }
+
   void immersion_ndimage(ndbuffer_image& input,
                          ndbuffer_image& inf,
                          ndbuffer_image& sup,
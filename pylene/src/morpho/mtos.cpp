@@ -1,4 +1,4 @@
-#include <mln/core/image/view/channel.hpp>
+#include <mln/core/algorithm/transform.hpp>
 #include <mln/morpho/mtos.hpp>
 #include <mln/morpho/private/satmaxtree.hpp>
 #include <mln/morpho/private/trees_fusion.hpp>
@@ -14,7 +14,9 @@ namespace mln::morpho
 
     for (int c = 0; c < 3; c++)
     {
-      std::tie(trees[c], nodemaps[c]) = mln::morpho::tos(mln::view::channel(ima, c), pstart);
+      // The channel is copied into a buffer image to use the vectorized immersion
+      image2d<std::uint8_t> channel   = mln::transform(ima, [c](const rgb8& v) -> std::uint8_t { return v[c]; });
+      std::tie(trees[c], nodemaps[c]) = mln::morpho::tos(channel, pstart);
       depths[c]                       = trees[c].compute_depth();
     }
 
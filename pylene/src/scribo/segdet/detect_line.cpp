@@ -1,5 +1,7 @@
 #include "detect_line.hpp"
 
+#include <mln/core/trace.hpp>
+
 namespace scribo::internal
 {
   using namespace mln;
@@ -7,6 +9,10 @@ namespace scribo::internal
   std::tuple<std::vector<Segment>, std::vector<Segment>> detect_line(const image2d<std::uint8_t>& image, int min_len,
                                                                      const SegDetParams& params)
   {
+    mln_entering("scribo::internal::detect_line");
+    mln::trace::annotate("width", image.width());
+    mln::trace::annotate("height", image.height());
+
     // Parameter setting
     const Descriptor& descriptor = Descriptor(params, min_len);
 
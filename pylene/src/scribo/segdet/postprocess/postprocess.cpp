@@ -1,44 +1,160 @@
 #include "../detect_line.hpp"
-#include "../segment_to_X.hpp"
 
-#include <mln/core/algorithm/fill.hpp>
-#include <mln/core/image/view/transform.hpp>
-#include <mln/core/range/foreach.hpp>
+#include <mln/core/trace.hpp>
+
 #include <scribo/segdet.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 namespace scribo::internal
 {
-  /**
-   * Binarize the image
-   * @param img Image to binarize
-   */
-  void binarize_img(image2d<uint16_t> img)
+  namespace
   {
-    mln_foreach (auto p, img.domain())
+    /// A run of pixels [begin, end] of a span on the line `line` (the column of the span of a horizontal segment, the
+    /// row of the span of a vertical segment)
+    struct Run
     {
-      if (img(p) != 0)
-        img(p) = 1;
-      else
-        img(p) = 0;
-    }
-  }
+      int line;
+      int begin;
+      int end;
+      int segment;
+    };
+
+    /**
+     * Index of the pixels covered by runs of the same direction. Each line holds sorted disjoint intervals with the
+     * number of runs covering them (1, or 2 for two or more), so that a pixel is looked up by a binary search.
+     */
+    class RunIndex
+    {
+    public:
+      RunIndex(std::vector<Run> runs, int n_lines)
+        : m_first(n_lines + 1, 0)
+      {
+        std::sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) { return a.line < b.line; });
+
+        std::vector<std::pair<int, int>> events; // (position, +1 at the beginning of a run or -1 after its end)
+        for (std::size_t i = 0, j; i < runs.size(); i = j)
+        {
+          const int line = runs[i].line;
+
+          events.clear();
+          for (j = i; j < runs.size() && runs[j].line == line; j++)
+          {
+            events.emplace_back(runs[j].begin, 1);
+            events.emplace_back(runs[j].end + 1, -1);
+          }
+          std::sort(events.begin(), events.end());
+
+          const std::size_t line_first = m_intervals.size();
+          int               count      = 0;
+          for (std::size_t k = 0; k + 1 < events.size(); k++)
+          {
+            count += events[k].second;
+            const int begin = events[k].first;
+            const int end   = events[k + 1].first - 1;
+            if (count <= 0 || end < begin)
+              continue;
+
+            const int c = std::min(count, 2);
+            if (m_intervals.size() > line_first && m_intervals.back().end + 1 == begin && m_intervals.back().count == c)
+              m_intervals.back().end = end;
+            else
+              m_intervals.push_back({begin, end, c});
+          }
+          m_first[line + 1] = static_cast<int>(m_intervals.size());
+        }
+
+        // Lines without runs
+        for (int l = 1; l <= n_lines; l++)
+          m_first[l] = std::max(m_first[l], m_first[l - 1]);
+      }
 
-  /**
-   * Compute the intersection between two images and store it in out
-   * @param img first image
-   * @param img2 second image
-   * @param out image storing result
-   */
-  void intersect(image2d<std::uint16_t> img, image2d<std::uint16_t> img2, image2d<std::uint16_t> out)
-  {
-    mln_foreach (auto pt, img.domain())
-      out(pt) = img(pt) * img2(pt);
-  }
+      /// The number of runs covering the pixel \p pos of the line \p line (0, 1, or 2 for two or more)
+      int count(int line, int pos) const
+      {
+        auto first = m_intervals.begin() + m_first[line];
+        auto last  = m_intervals.begin() + m_first[line + 1];
+        auto it    = std::upper_bound(first, last, pos, [](int p, const Interval& i) { return p < i.begin; });
+        if (it == first || (--it)->end < pos)
+          return 0;
+        return it->count;
+      }
+
+    private:
+      struct Interval
+      {
+        int begin;
+        int end;
+        int count;
+      };
+
+      std::vector<Interval> m_intervals;
+      std::vector<int>      m_first; // The intervals of the line l are [m_first[l], m_first[l + 1])
+    };
+
+    /**
+     * The pixels drawn by the spans of a set of segments (as segment_to_label does without the spans under other
+     * objects)
+     */
+    class SegmentCoverage
+    {
+    public:
+      SegmentCoverage(const std::vector<Segment>& segments, int width, int height)
+        : m_runs(make_runs(segments, width, height))
+        , m_columns(m_runs.first, width)
+        , m_rows(m_runs.second, height)
+      {
+      }
+
+      /// The runs of the spans of horizontal segments (on columns) and of vertical segments (on rows)
+      const std::pair<std::vector<Run>, std::vector<Run>>& runs() const noexcept { return m_runs; }
+
+      /// The number of spans drawing the pixel (x, y) (0, 1, or 2 for two or more)
+      int count(int x, int y) const { return std::min(m_columns.count(x, y) + m_rows.count(y, x), 2); }
+
+    private:
+      static std::pair<std::vector<Run>, std::vector<Run>> make_runs(const std::vector<Segment>& segments, int width,
+                                                                     int height)
+      {
+        std::pair<std::vector<Run>, std::vector<Run>> runs;
+        for (int i = 0; i < static_cast<int>(segments.size()); i++)
+        {
+          for (const auto& span : segments[i].spans)
+          {
+            float thickness_d2 = static_cast<float>(span.thickness) / 2.0f;
+            if (segments[i].is_horizontal)
+            {
+              int x     = static_cast<int>(span.x);
+              int i_min = std::max(static_cast<int>(std::ceil(span.y - thickness_d2)), 0);
+              int i_max = std::min(static_cast<int>(std::floor(span.y + thickness_d2)), height - 1);
+              if (0 <= x && x < width && i_min <= i_max)
+                runs.first.push_back({x, i_min, i_max, i});
+            }
+            else
+            {
+              int y     = static_cast<int>(span.y);
+              int i_min = std::max(static_cast<int>(std::ceil(span.x - thickness_d2)), 0);
+              int i_max = std::min(static_cast<int>(std::floor(span.x + thickness_d2)), width - 1);
+              if (0 <= y && y < height && i_min <= i_max)
+                runs.second.push_back({y, i_min, i_max, i});
+            }
+          }
+        }
+        return runs;
+      }
+
+      std::pair<std::vector<Run>, std::vector<Run>> m_runs;
+      RunIndex                                      m_columns;
+      RunIndex                                      m_rows;
+    };
+  } // namespace
 
   /**
-   * Remove duplication of segment
+   * Remove duplication of segment: the segments of segments_removable whose own pixels (the pixels drawn by no other
+   * removable segment) are mostly drawn by segments_to_compare are removed. The pixels are looked up in indexes of
+   * the runs of the spans, so the cost depends on the size of the segments and not on the size of the image.
    * @param segments_to_compare
    * @param segments_removable
    * @param width
@@ -47,36 +163,25 @@ namespace scribo::internal
   void remove_dup(const std::vector<Segment>& segments_to_compare, std::vector<Segment>& segments_removable, int width,
                   int height, const Descriptor& descriptor)
   {
-    auto first_output  = std::get<0>(segment_to_label(segments_to_compare, {}, width, height, false));
-    auto second_output = std::get<0>(segment_to_label(segments_removable, {}, width, height, false));
-
-    binarize_img(first_output);
-
-    image2d<std::uint16_t> intersection = image2d<std::uint16_t>(width, height);
-    mln::fill(intersection, 0);
-
-    intersect(first_output, second_output, intersection);
-
-    std::vector<uint16_t> segments(segments_removable.size(), 0);
-
-    mln_foreach (auto v, intersection.values())
-    {
-      if (v >= first_label)
-        segments[v - first_label]++;
-    }
-
-    int k = 0;
-    for (int i = 0; i < (int)segments.size(); i++)
-    {
-      float segments_ratio = 0;
-      if (segments_removable[i - k].nb_pixels != 0)
-        segments_ratio = segments[i] / static_cast<float>(segments_removable[i - k].nb_pixels);
-      if (segments_removable[i - k].nb_pixels == 0 || segments_ratio > descriptor.threshold_intersection)
-      {
-        segments_removable.erase(segments_removable.begin() + i - k);
-        k++;
-      }
-    }
+    const SegmentCoverage compare(segments_to_compare, width, height);
+    const SegmentCoverage removable(segments_removable, width, height);
+
+    // Number of own pixels of each removable segment that are drawn by a compared segment
+    std::vector<int> intersections(segments_removable.size(), 0);
+    for (const auto& r : removable.runs().first)
+      for (int y = r.begin; y <= r.end; y++)
+        if (removable.count(r.line, y) == 1 && compare.count(r.line, y) > 0)
+          intersections[r.segment]++;
+    for (const auto& r : removable.runs().second)
+      for (int x = r.begin; x <= r.end; x++)
+        if (removable.count(x, r.line) == 1 && compare.count(x, r.line) > 0)
+          intersections[r.segment]++;
+
+    int i = 0;
+    std::erase_if(segments_removable, [&](const Segment& s) {
+      const int intersection = intersections[i++];
+      return s.nb_pixels == 0 || intersection / static_cast<float>(s.nb_pixels) > descriptor.threshold_intersection;
+    });
   }
 
   /**
@@ -123,6 +228,9 @@ namespace scribo::internal
   post_process(std::pair<std::vector<Segment>, std::vector<Segment>>& segments_pair, int img_width, int img_height,
                const Descriptor& descriptor)
   {
+    mln_entering("scribo::internal::post_process");
+    mln::trace::annotate("segments", segments_pair.first.size() + segments_pair.second.size());
+
     if (descriptor.remove_duplicates &&
         descriptor.traversal_mode == scribo::e_segdet_process_traversal_mode::HORIZONTAL_VERTICAL)
       remove_duplicates(segments_pair, img_width, img_height, descriptor);
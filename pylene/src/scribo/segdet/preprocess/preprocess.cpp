@@ -1,63 +1,224 @@
 #include <mln/core/algorithm/transform.hpp>
 #include <mln/core/image/ndimage.hpp>
-#include <mln/core/image/view/transform.hpp>
-#include <mln/core/neighborhood/c4.hpp>
 #include <mln/core/se/rect2d.hpp>
-#include <mln/morpho/closing.hpp>
-#include <mln/morpho/reconstruction.hpp>
+#include <mln/core/trace.hpp>
+#include <mln/morpho/dilation.hpp>
 
 #include <scribo/segdet.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
 #include <stdexcept>
 
 #include "../detect_line.hpp"
 
 namespace scribo::internal
 {
+  namespace
+  {
+    /**
+     * @brief Classic reconstruction by dilation (4-connectivity) of \p rec under \p mask, in place (hybrid algorithm:
+     * two raster scans then a propagation with a queue from the pixels that can still grow)
+     *
+     * @param mask The mask image
+     * @param rec The markers (below the mask) as input, the reconstruction as output
+     */
+    void hybrid_reconstruction(const mln::image2d<std::uint8_t>& mask, mln::image2d<std::uint8_t>& rec)
+    {
+      const int            w       = mask.width();
+      const int            h       = mask.height();
+      const std::ptrdiff_t mstride = mask.byte_stride();
+      const std::ptrdiff_t rstride = rec.byte_stride();
+      const std::uint8_t*  M       = mask.buffer();
+      std::uint8_t*        R       = rec.buffer();
+
+      // Forward scan
+      for (int y = 0; y < h; y++)
+      {
+        const std::uint8_t* m  = M + y * mstride;
+        std::uint8_t*       r  = R + y * rstride;
+        const std::uint8_t* up = (y > 0) ? r - rstride : r;
+        for (int x = 0; x < w; x++)
+        {
+          std::uint8_t v = std::max(r[x], up[x]);
+          if (x > 0)
+            v = std::max(v, r[x - 1]);
+          r[x] = std::min(v, m[x]);
+        }
+      }
+
+      // Backward scan, the pixels that can propagate to a neighbor are queued
+      std::queue<int> queue;
+      for (int y = h - 1; y >= 0; y--)
+      {
+        const std::uint8_t* m     = M + y * mstride;
+        std::uint8_t*       r     = R + y * rstride;
+        const std::uint8_t* mdown = (y < h - 1) ? m + mstride : m;
+        const std::uint8_t* down  = (y < h - 1) ? r + rstride : r;
+        for (int x = w - 1; x >= 0; x--)
+        {
+          std::uint8_t v = std::max(r[x], down[x]);
+          if (x < w - 1)
+            v = std::max(v, r[x + 1]);
+          v    = std::min(v, m[x]);
+          r[x] = v;
+
+          if ((x < w - 1 && r[x + 1] < v && r[x + 1] < m[x + 1]) || (down[x] < v && down[x] < mdown[x]))
+            queue.push(y * w + x);
+        }
+      }
+
+      // Propagation
+      auto update = [&](int x, int y, std::uint8_t v) {
+        std::uint8_t&      r = R[y * rstride + x];
+        const std::uint8_t m = M[y * mstride + x];
+        if (r < v && r != m)
+        {
+          r = std::min(v, m);
+          queue.push(y * w + x);
+        }
+      };
+
+      while (!queue.empty())
+      {
+        const int p = queue.front();
+        queue.pop();
+
+        const int          x = p % w;
+        const int          y = p / w;
+        const std::uint8_t v = R[y * rstride + x];
+        if (x > 0)
+          update(x - 1, y, v);
+        if (x < w - 1)
+          update(x + 1, y, v);
+        if (y > 0)
+          update(x, y - 1, v);
+        if (y < h - 1)
+          update(x, y + 1, v);
+      }
+    }
+
+    /**
+     * @brief Reconstruction by dilation (4-connectivity) of \p rec under \p mask, in place, with the same result as the
+     * union-find mln::morpho::opening_by_reconstruction
+     *
+     * The union-find version only outputs the levels of the components of the mask (a pixel gets the level of the
+     * highest component that contains it and reaches a marker). This is the classic reconstruction of the markers
+     * made of the pixels fully reconstructed by the classic reconstruction. If no marker reaches the minimum of the
+     * mask, the result is this minimum.
+     *
+     * @param mask The mask image
+     * @param rec The markers (below the mask) as input, the reconstruction as output
+     */
+    void reconstruction_by_dilation(const mln::image2d<std::uint8_t>& mask, mln::image2d<std::uint8_t>& rec)
+    {
+      mln_entering("scribo::internal::reconstruction_by_dilation");
+
+      const int w = mask.width();
+      const int h = mask.height();
+      if (w == 0 || h == 0)
+        return;
+
+      std::uint8_t mask_min    = 255;
+      std::uint8_t markers_max = 0;
+      for (int y = 0; y < h; y++)
+      {
+        const std::uint8_t* m = mask.buffer() + y * mask.byte_stride();
+        const std::uint8_t* r = rec.buffer() + y * rec.byte_stride();
+        mask_min              = std::min(mask_min, *std::min_element(m, m + w));
+        markers_max           = std::max(markers_max, *std::max_element(r, r + w));
+      }
+
+      if (markers_max < mask_min)
+      {
+        for (int y = 0; y < h; y++)
+          std::fill_n(rec.buffer() + y * rec.byte_stride(), w, mask_min);
+        return;
+      }
+
+      hybrid_reconstruction(mask, rec);
+
+      // Keep the fully reconstructed pixels as markers of the components levels
+      for (int y = 0; y < h; y++)
+      {
+        const std::uint8_t* m = mask.buffer() + y * mask.byte_stride();
+        std::uint8_t*       r = rec.buffer() + y * rec.byte_stride();
+        for (int x = 0; x < w; x++)
+          r[x] = (r[x] == m[x]) ? m[x] : 0;
+      }
+
+      hybrid_reconstruction(mask, rec);
+    }
+  } // namespace
+
   /**
    * @brief Perform a black top hat on the input image
    *
+   * The negation, the seeds, the minimum with the reconstruction and the top hat are computed in fused passes, so that
+   * only three images are allocated (the negated input, the connectivity mask and the output).
+   *
    * @param input The input image
+   * @param negate Say if the input has to be negated first
    * @param descriptor Descriptor containing the parameters of the preprocessing
    * @return mln::image2d<std::uint8_t>
    */
-  mln::image2d<std::uint8_t> black_top_hat(const mln::image2d<std::uint8_t>& input, const Descriptor& descriptor)
+  mln::image2d<std::uint8_t> black_top_hat(const mln::image2d<std::uint8_t>& input, bool negate,
+                                           const Descriptor& descriptor)
   {
-    // 1. Negate
-    auto neg = mln::view::transform(input, [](std::uint8_t p) -> std::uint8_t { return 255 - p; });
+    mln_entering("scribo::internal::black_top_hat");
 
-    // 2. Get seeds
-    auto seeds = mln::view::transform(neg, [descriptor](std::uint8_t p) -> std::uint8_t {
-      return std::max(static_cast<int>(p - static_cast<int>(descriptor.dyn * 255)), 0);
-    });
+    const int w    = input.width();
+    const int h    = input.height();
+    const int dyn  = static_cast<int>(descriptor.dyn * 255);
+    const int flip = negate ? 0 : 255; // neg = |flip - input|
 
-    // 3. Create connectivity mask
-    auto connectivity_mask = mln::morpho::dilation(neg, mln::se::rect2d{descriptor.size_mask, descriptor.size_mask});
+    // 1. Negate and get seeds
+    mln::image2d<std::uint8_t> neg(input.domain());
+    mln::image2d<std::uint8_t> out(input.domain());
+    for (int y = 0; y < h; y++)
+    {
+      const std::uint8_t* in = input.buffer() + y * input.byte_stride();
+      std::uint8_t*       n  = neg.buffer() + y * neg.byte_stride();
+      std::uint8_t*       s  = out.buffer() + y * out.byte_stride();
+      for (int x = 0; x < w; x++)
+      {
+        n[x] = static_cast<std::uint8_t>(std::abs(flip - in[x]));
+        s[x] = static_cast<std::uint8_t>(std::max(n[x] - dyn, 0));
+      }
+    }
+
+    // 2. Create connectivity mask
+    auto connectivity_mask =
+        mln::morpho::parallel::dilation(neg, mln::se::rect2d{descriptor.size_mask, descriptor.size_mask});
 
-    // 4. Reconstruction to get the background
-    auto out = mln::morpho::opening_by_reconstruction(connectivity_mask, seeds, mln::c4);
-    out      = mln::transform(neg, out, [](std::uint8_t a, std::uint8_t b) -> std::uint8_t { return std::min(a, b); });
+    // 3. Reconstruction to get the background
+    reconstruction_by_dilation(connectivity_mask, out);
 
-    // 5. Top hat
-    mln::transform(neg, out, out, [](std::uint8_t a, std::uint8_t b) -> std::uint8_t { return 255 - (a - b); });
+    // 4. Top hat
+    for (int y = 0; y < h; y++)
+    {
+      const std::uint8_t* n = neg.buffer() + y * neg.byte_stride();
+      std::uint8_t*       o = out.buffer() + y * out.byte_stride();
+      for (int x = 0; x < w; x++)
+        o[x] = static_cast<std::uint8_t>(255 - (n[x] - std::min(n[x], o[x])));
+    }
 
     return out;
   }
 
   mln::image2d<std::uint8_t> preprocess(const mln::image2d<std::uint8_t>& input, const Descriptor& descriptor)
   {
-    auto input_copy = input;
-    if (descriptor.negate_image)
-      input_copy = mln::transform(input, [](std::uint8_t p) -> std::uint8_t { return 255 - p; });
-
     switch (descriptor.preprocess)
     {
     case e_segdet_preprocess::NONE:
-      return input_copy;
+      if (descriptor.negate_image)
+        return mln::transform(input, [](std::uint8_t p) -> std::uint8_t { return 255 - p; });
+      return input;
     case e_segdet_preprocess::BLACK_TOP_HAT:
-      return black_top_hat(input_copy, descriptor);
+      return black_top_hat(input, descriptor.negate_image, descriptor);
     default:
       throw std::runtime_error("Bad preprocess choice. Possible are NONE(0), BLACK_TOP_HAT(1)");
     }
   }
-} // namespace scribo::internal
\ No newline at end of file
+} // namespace scribo::internal
@@ -1,11 +1,14 @@
 #include "bucket.hpp"
 
+#include <algorithm>
+
 namespace scribo::internal
 {
   Buckets::Buckets(size_t n_max, size_t bs)
     : m_bucket_size(std::min(bs, n_max))
     , m_bucket_count((n_max + m_bucket_size - 1) / m_bucket_size)
-    , m_container(m_bucket_count)
+    , m_begin(m_bucket_count + 1, 0)
+    , m_end(m_bucket_count, 0)
   {
   }
 
@@ -21,39 +24,44 @@ namespace scribo::internal
   void Buckets::insert(Tracker&& tracker)
   {
     auto k = get_bucket_number(tracker);
-    m_container[k].push_back(std::move(tracker));
+    assert(m_end[k] < m_begin[k + 1]);
+    m_trackers[m_end[k]++] = std::move(tracker);
   }
 
   void Buckets::acquire(std::vector<Tracker>& trackers)
   {
-    for (auto& tracker : trackers)
-      insert(std::move(tracker));
-    trackers.clear();
-  }
+    assert(m_trackers.empty());
 
-  void Buckets::release(std::vector<Tracker>& trackers)
-  {
-    for (auto& c : m_container)
+    // Counting sort of the trackers by bucket (stable)
+    m_bucket_of.resize(trackers.size());
+    std::fill(m_end.begin(), m_end.end(), 0);
+    for (size_t i = 0; i < trackers.size(); i++)
     {
-      std::move(c.begin(), c.end(), std::back_inserter(trackers));
-      c.clear();
+      m_bucket_of[i] = get_bucket_number(trackers[i]);
+      m_end[m_bucket_of[i]]++;
     }
-  }
 
-  void Buckets::remove_if(size_t i, std::function<bool(const Tracker&)> pred, std::vector<Tracker>& out)
-  {
-    assert(i < m_bucket_count);
-    auto& c           = m_container[i];
-    auto [end1, end2] = std::partition_copy(std::move_iterator(c.begin()), std::move_iterator(c.end()),
-                                            std::back_inserter(out), c.begin(), pred);
-    c.erase(end2, c.end());
+    m_begin[0] = 0;
+    for (size_t k = 0; k < m_bucket_count; k++)
+    {
+      m_begin[k + 1] = m_begin[k] + m_end[k];
+      m_end[k]       = m_begin[k];
+    }
+
+    m_trackers.resize(trackers.size());
+    for (size_t i = 0; i < trackers.size(); i++)
+      m_trackers[m_end[m_bucket_of[i]]++] = std::move(trackers[i]);
+    trackers.clear();
   }
 
-  void Buckets::for_each_tracker(size_t i, std::function<void(Tracker&)> action)
+  void Buckets::release(std::vector<Tracker>& trackers)
   {
-    assert(i < m_bucket_count);
-    auto& c = m_container[i];
-    std::for_each(c.begin(), c.end(), action);
+    for (size_t k = 0; k < m_bucket_count; k++)
+    {
+      std::move(m_trackers.begin() + m_begin[k], m_trackers.begin() + m_end[k], std::back_inserter(trackers));
+      m_end[k] = m_begin[k];
+    }
+    m_trackers.clear();
   }
 
-} // namespace scribo::internal
\ No newline at end of file
+} // namespace scribo::internal
@@ -1,16 +1,28 @@
 #pragma once
 
 #include "tracker.hpp"
+
+#include <cassert>
 #include <vector>
 
 namespace scribo::internal
 {
+  /**
+   * The Buckets structure stores the trackers of a traversal step sorted by position bucket in a single array. The
+   * bucket i occupies the slots [m_begin[i], m_begin[i + 1]) of the array, its m_end[i] - m_begin[i] first slots being
+   * used. The storage is kept from one step to another, so a traversal step does not allocate once the number of
+   * trackers is stable.
+   */
   struct Buckets
   {
   private:
-    const size_t                      m_bucket_size;
-    const size_t                      m_bucket_count;
-    std::vector<std::vector<Tracker>> m_container;
+    const size_t m_bucket_size;
+    const size_t m_bucket_count;
+
+    std::vector<Tracker> m_trackers;  // The trackers, sorted by bucket
+    std::vector<size_t>  m_begin;     // First slot of each bucket (m_bucket_count + 1 values)
+    std::vector<size_t>  m_end;       // End of the used slots of each bucket
+    std::vector<size_t>  m_bucket_of; // Bucket of each tracker during the acquisition
 
 
   public:
@@ -19,9 +31,22 @@ namespace scribo::internal
     size_t get_bucket_size() const { return m_bucket_size; }
     size_t get_bucket_number(int n) const noexcept;
     size_t get_bucket_number(const Tracker& f) const noexcept;
-    void   insert(Tracker&& tracker);
-    void   acquire(std::vector<Tracker>& trackers);
-    void   release(std::vector<Tracker>& trackers);
+
+    ///
+    /// @brief Put back a tracker removed by remove_if since the last acquisition. The position of the tracker must not
+    /// have changed: it goes back to the end of its bucket.
+    ///
+    void insert(Tracker&& tracker);
+
+    ///
+    /// @brief Move the trackers into the (empty) buckets, keeping their relative order within each bucket.
+    ///
+    void acquire(std::vector<Tracker>& trackers);
+
+    ///
+    /// @brief Move all the trackers to the end of \p trackers bucket by bucket and empty the buckets.
+    ///
+    void release(std::vector<Tracker>& trackers);
 
     ///
     /// @brief Move the elements that verifies a given predicate from the i-th bucket to the end of the list \p out.
@@ -30,7 +55,8 @@ namespace scribo::internal
     /// @param pred
     /// @param out
     ///
-    void remove_if(size_t i, std::function<bool(const Tracker&)> pred, std::vector<Tracker>& out);
+    template <class Predicate>
+    void remove_if(size_t i, Predicate pred, std::vector<Tracker>& out);
 
     ///
     /// @brief Applies the callback \p action on each item of the i-th bucket
@@ -38,8 +64,33 @@ namespace scribo::internal
     /// @param i
     /// @param action
     ///
-    void for_each_tracker(size_t i, std::function<void(Tracker&)> action);
-
-    // std::vector<Tracker>& get_bucket(size_t i);
+    template <class Function>
+    void for_each_tracker(size_t i, Function action);
   };
-} // namespace scribo::internal
\ No newline at end of file
+
+
+  template <class Predicate>
+  void Buckets::remove_if(size_t i, Predicate pred, std::vector<Tracker>& out)
+  {
+    assert(i < m_bucket_count);
+
+    // Stable partition: the kept trackers are compacted at the beginning of the bucket
+    size_t w = m_begin[i];
+    for (size_t r = m_begin[i]; r < m_end[i]; r++)
+    {
+      if (pred(static_cast<const Tracker&>(m_trackers[r])))
+        out.push_back(std::move(m_trackers[r]));
+      else if (w++ != r)
+        m_trackers[w - 1] = std::move(m_trackers[r]);
+    }
+    m_end[i] = w;
+  }
+
+  template <class Function>
+  void Buckets::for_each_tracker(size_t i, Function action)
+  {
+    assert(i < m_bucket_count);
+    for (size_t k = m_begin[i]; k < m_end[i]; k++)
+      action(m_trackers[k]);
+  }
+} // namespace scribo::internal
@@ -1,118 +1,228 @@
 #include "extract_observation.hpp"
 
-#include <iostream>
-#include <numeric>
+#include <mln/bp/transpose.hpp>
+
+#include <xsimd/xsimd.hpp>
+
+#include <algorithm>
+#include <cstdlib>
 
 namespace scribo::internal
 {
-  /**
-   * Determine the observation Matrix
-   * @param image
-   * @param n
-   * @param t
-   * @param n_max
-   * @param is_horizontal
-   * @return Observation Eigen matrix
-   */
-  Eigen::Matrix<float, 3, 1> determine_observation_binary(const mln::image2d<uint8_t>& image, int& n, int t, int n_max,
-                                                          const Descriptor& descriptor)
+  namespace
   {
-    int ithickness = 0;
-
-    std::vector<float> luminosities_list;
-    int                mlumi           = 255;
-    int                sum_iluminosity = 0;
-    while (n + ithickness < n_max)
+    using simd_t            = xsimd::simd_type<std::uint8_t>;
+    constexpr int WARP_SIZE = simd_t::size;
+
+    /**
+     * Return the first position n in [n, n_max) such that column[n] < threshold (or n_max if there is none). The whole
+     * batches without such a value are skipped with simd comparisons.
+     */
+    int find_below(const std::uint8_t* column, int n, int n_max, int threshold) noexcept
     {
-      int iluminosity = static_cast<int>(image({t, n + ithickness}));
-      if (iluminosity > descriptor.blumi)
-        break;
+      if (threshold <= 0)
+        return n_max;
+      if (threshold > 255)
+        return n;
+
+      // v < threshold <=> min(v, threshold - 1) == v
+      const simd_t t(static_cast<std::uint8_t>(threshold - 1));
+      for (; n + WARP_SIZE <= n_max; n += WARP_SIZE)
+      {
+        simd_t v = xsimd::load_unaligned(column + n);
+        if (xsimd::any(xsimd::min(v, t) == v))
+          break;
+      }
+
+      for (; n < n_max; ++n)
+        if (column[n] < threshold)
+          return n;
+      return n_max;
+    }
 
-      if (iluminosity < mlumi)
-        mlumi = iluminosity;
+    /**
+     * Return the first position n in [n, n_max) such that column[n] > threshold (or n_max if there is none)
+     */
+    int find_above(const std::uint8_t* column, int n, int n_max, int threshold) noexcept
+    {
+      if (threshold >= 255)
+        return n_max;
+      if (threshold < 0)
+        return n;
+
+      // v > threshold <=> max(v, threshold + 1) == v
+      const simd_t t(static_cast<std::uint8_t>(threshold + 1));
+      for (; n + WARP_SIZE <= n_max; n += WARP_SIZE)
+      {
+        simd_t v = xsimd::load_unaligned(column + n);
+        if (xsimd::any(xsimd::max(v, t) == v))
+          break;
+      }
 
-      luminosities_list.push_back(iluminosity);
-      sum_iluminosity += iluminosity;
-      ithickness++;
+      for (; n < n_max; ++n)
+        if (column[n] > threshold)
+          return n;
+      return n_max;
     }
 
-    float slumi = mlumi + (descriptor.blumi - mlumi) * descriptor.ratio_lum; // lstab
-    int   ni    = n;
-    while (luminosities_list[ni - n] > slumi)
-      sum_iluminosity -= luminosities_list[ni++ - n];
+    /**
+     * Return the first position n in [n, n_max - 1) such that |column[n - 1] - column[n + 1]| > threshold (or n_max - 1
+     * if there is none)
+     */
+    int find_gradient(const std::uint8_t* column, int n, int n_max, int threshold) noexcept
+    {
+      if (threshold >= 255)
+        return n_max - 1;
+      if (threshold < 0)
+        return n;
 
-    int nf = n + ithickness;
-    while (luminosities_list[--nf - n] > slumi)
-      sum_iluminosity -= luminosities_list[nf - n];
+      const simd_t t(static_cast<std::uint8_t>(threshold + 1));
+      for (; n + 1 + WARP_SIZE <= n_max; n += WARP_SIZE)
+      {
+        simd_t a = xsimd::load_unaligned(column + n - 1);
+        simd_t b = xsimd::load_unaligned(column + n + 1);
+        simd_t d = xsimd::max(a, b) - xsimd::min(a, b);
+        if (xsimd::any(xsimd::max(d, t) == d))
+          break;
+      }
 
-    float position   = (nf + ni) / 2.0f;
-    float thickness  = nf - ni + 1.0f;
-    float luminosity = sum_iluminosity / thickness;
+      for (; n < n_max - 1; ++n)
+        if (std::abs(static_cast<int>(column[n - 1]) - static_cast<int>(column[n + 1])) > threshold)
+          return n;
+      return n_max - 1;
+    }
 
-    auto ret = Eigen::Matrix<float, 3, 1>(position, thickness, luminosity);
 
-    n += ithickness;
+    /**
+     * Determine the observation Matrix of the dark run [n, e) (all the values are <= blumi). The ends of the run
+     * brighter than the luminosity threshold are trimmed.
+     * @param column
+     * @param n
+     * @param e
+     * @return Observation Eigen matrix
+     */
+    Eigen::Matrix<float, 3, 1> determine_observation_binary(const std::uint8_t* column, int n, int e,
+                                                            const Descriptor& descriptor)
+    {
+      int mlumi           = 255;
+      int sum_iluminosity = 0;
+      for (int i = n; i < e; i++)
+      {
+        mlumi = std::min(mlumi, static_cast<int>(column[i]));
+        sum_iluminosity += column[i];
+      }
 
-    return ret;
-  }
+      float slumi = mlumi + (descriptor.blumi - mlumi) * descriptor.ratio_lum; // lstab
+      int   ni    = n;
+      while (column[ni] > slumi)
+        sum_iluminosity -= column[ni++];
 
-  Eigen::Matrix<float, 3, 1> determine_observation_gradient(const mln::image2d<uint8_t>& image, int& n, int t,
-                                                            int n_max, const Descriptor& descriptor)
-  {
-    int gradient_sign = static_cast<int>(image({t, n + 1})) - static_cast<int>(image({t, n - 1})) < 0 ? -1 : 1;
+      int nf = e;
+      while (column[--nf] > slumi)
+        sum_iluminosity -= column[nf];
 
-    int ithickness = 1;
-    while (n + ithickness + 1 < n_max)
-    {
-      int gradient =
-          static_cast<int>(image({t, (n + ithickness) + 1})) - static_cast<int>(image({t, (n + ithickness) - 1}));
-      if (gradient * gradient_sign < descriptor.gradient_threshold)
-        break;
+      float position   = (nf + ni) / 2.0f;
+      float thickness  = nf - ni + 1.0f;
+      float luminosity = sum_iluminosity / thickness;
 
-      ithickness++;
+      return Eigen::Matrix<float, 3, 1>(position, thickness, luminosity);
     }
 
-    int grad = static_cast<int>(image({t, n + ithickness})) - static_cast<int>(image({t, n - 1}));
+    /**
+     * Determine the observation Matrix of the gradient starting at n and return the end of the gradient
+     * @param column
+     * @param n
+     * @param n_max
+     * @param obs Output observation
+     * @return The position of the end of the gradient
+     */
+    int determine_observation_gradient(const std::uint8_t* column, int n, int n_max, const Descriptor& descriptor,
+                                       Eigen::Matrix<float, 3, 1>& obs)
+    {
+      int gradient_sign = static_cast<int>(column[n + 1]) - static_cast<int>(column[n - 1]) < 0 ? -1 : 1;
 
-    float position   = (n - 1 + n + ithickness) / 2.0f;
-    float thickness  = ithickness;
-    float luminosity = grad;
+      int ithickness = 1;
+      while (n + ithickness + 1 < n_max)
+      {
+        int gradient = static_cast<int>(column[n + ithickness + 1]) - static_cast<int>(column[n + ithickness - 1]);
+        if (gradient * gradient_sign < descriptor.gradient_threshold)
+          break;
 
-    auto ret = Eigen::Matrix<float, 3, 1>(position, thickness, luminosity);
+        ithickness++;
+      }
 
-    n += ithickness;
+      int grad = static_cast<int>(column[n + ithickness]) - static_cast<int>(column[n - 1]);
 
-    return ret;
-  }
+      float position   = (n - 1 + n + ithickness) / 2.0f;
+      float thickness  = ithickness;
+      float luminosity = grad;
+
+      obs = Eigen::Matrix<float, 3, 1>(position, thickness, luminosity);
+      return n + ithickness;
+    }
+  } // namespace
 
-  std::vector<Eigen::Matrix<float, 3, 1>> extract_observations(const mln::image2d<uint8_t>& image, int t, int n_max,
-                                                               const Descriptor& descriptor)
-  {
-    std::vector<Eigen::Matrix<float, 3, 1>> observations;
 
+  void extract_column_observations(const std::uint8_t* column, int n_max, const Descriptor& descriptor,
+                                   std::vector<Eigen::Matrix<float, 3, 1>>& observations)
+  {
     switch (descriptor.extraction_type)
     {
     case e_segdet_process_extraction::BINARY:
-      for (int n = 0; n < n_max; n++)
+      for (int n = find_below(column, 0, n_max, descriptor.llumi); n < n_max;)
       {
-        if (image({t, n}) < descriptor.llumi)
-        {
-          observations.push_back(determine_observation_binary(image, n, t, n_max, descriptor));
-        }
+        // The dark run [n, e) ends before the first value brighter than blumi
+        int e = find_above(column, n, n_max, descriptor.blumi);
+        if (e > n)
+          observations.push_back(determine_observation_binary(column, n, e, descriptor));
+        n = find_below(column, e + 1, n_max, descriptor.llumi);
       }
       break;
     case e_segdet_process_extraction::GRADIENT:
-      for (int n = 1; n < (n_max - 1); n++)
+      for (int n = find_gradient(column, 1, n_max, descriptor.gradient_threshold); n < n_max - 1;)
       {
-        if (std::abs(static_cast<int>(image({t, n - 1})) - static_cast<int>(image({t, n + 1}))) >
-            descriptor.gradient_threshold)
-        {
-          observations.push_back(determine_observation_gradient(image, n, t, n_max, descriptor));
-        }
+        Eigen::Matrix<float, 3, 1> obs;
+        n = determine_observation_gradient(column, n, n_max, descriptor, obs);
+        observations.push_back(obs);
+        n = find_gradient(column, n + 1, n_max, descriptor.gradient_threshold);
       }
       break;
     }
+  }
+
+  std::vector<Eigen::Matrix<float, 3, 1>> extract_observations(const mln::image2d<uint8_t>& image, int t, int n_max,
+                                                               const Descriptor& descriptor)
+  {
+    std::vector<std::uint8_t> column(n_max);
+    for (int n = 0; n < n_max; n++)
+      column[n] = image({t, n});
 
+    std::vector<Eigen::Matrix<float, 3, 1>> observations;
+    extract_column_observations(column.data(), n_max, descriptor, observations);
     return observations;
   }
-} // namespace scribo::internal
\ No newline at end of file
+
+
+  ObservationExtractor::ObservationExtractor(const mln::image2d<uint8_t>& image, const Descriptor& descriptor)
+    : m_image(image)
+    , m_descriptor(descriptor)
+    , m_block(static_cast<std::size_t>(kBlockSize) * image.height())
+  {
+  }
+
+  void ObservationExtractor::extract(int t, std::vector<Eigen::Matrix<float, 3, 1>>& observations)
+  {
+    const int n_max = m_image.height();
+
+    if (m_t0 < 0 || t < m_t0 || t >= m_t0 + kBlockSize)
+    {
+      m_t0         = t - t % kBlockSize;
+      const int bw = std::min(kBlockSize, m_image.width() - m_t0);
+      mln::bp::transpose(m_image.buffer() + m_t0, m_block.data(), n_max, bw, m_image.byte_stride(), n_max);
+    }
+
+    observations.clear();
+    extract_column_observations(m_block.data() + static_cast<std::ptrdiff_t>(t - m_t0) * n_max, n_max, m_descriptor,
+                                observations);
+  }
+} // namespace scribo::internal
@@ -12,4 +12,40 @@ namespace scribo::internal
 {
   std::vector<Eigen::Matrix<float, 3, 1>> extract_observations(const mln::image2d<uint8_t>& image, int t, int n_max,
                                                                const Descriptor& descriptor);
-}
\ No newline at end of file
+
+  /**
+   * Extract the observations of a contiguous column
+   * @param column The values of the column
+   * @param n_max The size of the column
+   * @param descriptor Parameters (extraction type and thresholds)
+   * @param observations The observations are appended to this list
+   */
+  void extract_column_observations(const std::uint8_t* column, int n_max, const Descriptor& descriptor,
+                                   std::vector<Eigen::Matrix<float, 3, 1>>& observations);
+
+  /**
+   * The ObservationExtractor class extracts the observations of the successive columns of an image. The columns are
+   * transposed by blocks into a contiguous buffer, so that the runs of a column are found with simd comparisons
+   * instead of strided pixel accesses.
+   */
+  class ObservationExtractor
+  {
+  public:
+    ObservationExtractor(const mln::image2d<uint8_t>& image, const Descriptor& descriptor);
+
+    /**
+     * Extract the observations of the column t
+     * @param t The column
+     * @param observations Output list of observations (cleared first)
+     */
+    void extract(int t, std::vector<Eigen::Matrix<float, 3, 1>>& observations);
+
+  private:
+    static constexpr int kBlockSize = 64; // Number of columns transposed at once
+
+    const mln::image2d<uint8_t>& m_image;
+    const Descriptor&            m_descriptor;
+    std::vector<std::uint8_t>    m_block; // The columns [m_t0, m_t0 + kBlockSize) of the image
+    int                          m_t0 = -1;
+  };
+} // namespace scribo::internal
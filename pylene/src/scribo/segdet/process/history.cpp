@@ -0,0 +1,58 @@
+#include "history.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace scribo::internal
+{
+  namespace
+  {
+    // Free blocks of the histories of the current thread (all the trackers of a traversal have the same capacity)
+    struct history_pool
+    {
+      static constexpr std::size_t max_blocks = 4096;
+
+      int                                   capacity = 0;
+      std::vector<std::unique_ptr<float[]>> blocks;
+
+      float* acquire(int cap)
+      {
+        if (cap != capacity)
+        {
+          blocks.clear();
+          blocks.reserve(max_blocks); // No allocation when the blocks are released
+          capacity = cap;
+        }
+        if (blocks.empty())
+          return new float[2 * cap];
+
+        float* p = blocks.back().release();
+        blocks.pop_back();
+        return p;
+      }
+
+      void release(float* p, int cap)
+      {
+        if (cap != capacity || blocks.size() >= max_blocks)
+        {
+          delete[] p;
+          return;
+        }
+        blocks.emplace_back(p);
+      }
+    };
+
+    thread_local history_pool t_pool;
+  } // namespace
+
+  History::History(int capacity)
+    : m_data(t_pool.acquire(capacity))
+    , m_capacity(capacity)
+  {
+  }
+
+  History::~History()
+  {
+    t_pool.release(m_data, m_capacity);
+  }
+} // namespace scribo::internal
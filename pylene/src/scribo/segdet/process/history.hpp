@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+namespace scribo::internal
+{
+  /**
+   * The History class is a fixed-capacity FIFO of the last values integrated by a tracker. The values are stored twice
+   * in a ring of size 2 × capacity so that the content is always contiguous in memory (no shift when the oldest value
+   * is removed). The storage blocks are recycled through a per-thread pool.
+   */
+  class History
+  {
+  public:
+    /**
+     * Constructor
+     * @param capacity The maximum number of values in the history
+     */
+    explicit History(int capacity);
+    ~History();
+
+    History(const History&)            = delete;
+    History& operator=(const History&) = delete;
+
+    void push_back(float v) noexcept
+    {
+      assert(m_size < m_capacity);
+      int i                  = m_head + m_size++;
+      i                      = i < m_capacity ? i : i - m_capacity;
+      m_data[i]              = v;
+      m_data[i + m_capacity] = v;
+    }
+
+    void pop_front() noexcept
+    {
+      assert(m_size > 0);
+      m_size--;
+      if (++m_head == m_capacity)
+        m_head = 0;
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    bool        empty() const noexcept { return m_size == 0; }
+
+    const float* begin() const noexcept { return m_data + m_head; }
+    const float* end() const noexcept { return m_data + m_head + m_size; }
+
+    float operator[](std::size_t i) const noexcept { return begin()[i]; }
+    float front() const noexcept { return begin()[0]; }
+    float back() const noexcept { return begin()[m_size - 1]; }
+
+  private:
+    float* m_data;
+    int    m_capacity;
+    int    m_head = 0;
+    int    m_size = 0;
+  };
+} // namespace scribo::internal
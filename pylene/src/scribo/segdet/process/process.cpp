@@ -3,6 +3,7 @@
 #include <mln/core/algorithm/fill.hpp>
 #include <mln/core/image/ndbuffer_image.hpp>
 #include <mln/core/image/ndimage.hpp>
+#include <mln/core/trace.hpp>
 
 #include <Eigen/Dense>
 #include <algorithm>
@@ -10,6 +11,7 @@
 
 #include "bucket.hpp"
 #include "extractors/extract_observation.hpp"
+#include "traversal.hpp"
 #include <mln/bp/transpose.hpp>
 
 namespace scribo::internal
@@ -88,9 +90,10 @@ namespace scribo::internal
    * @param trackers Current
    * @param obs Observation to match
    * @param t Current t
+   * @param accepted Output list of trackers (cleared first)
    */
-  std::vector<Tracker> find_match(Buckets& buckets, const Eigen::Matrix<float, 3, 1>& obs, const int& t,
-                                  float max_sigma_pos, const Descriptor& descriptor)
+  void find_match(Buckets& buckets, const Eigen::Matrix<float, 3, 1>& obs, const int& t, float max_sigma_pos,
+                  const Descriptor& descriptor, std::vector<Tracker>& accepted)
   {
     float max_sigma_thickD2 = std::max(max_sigma_pos, obs(1, 0) / 2.f);
 
@@ -108,11 +111,9 @@ namespace scribo::internal
     int   obs_n_min    = std::floor(obs(0, 0) - obs_thick_d2);
     int   obs_n_max    = std::ceil(obs(0, 0) + obs_thick_d2);
 
-    std::vector<Tracker> accepted;
+    accepted.clear();
     for (size_t b = obs_bucket_min; b <= obs_bucket_max; b++)
       find_match_bucket(buckets, b, accepted, obs, t, obs_thick, obs_n_min, obs_n_max, descriptor);
-
-    return accepted;
   }
 
   /**
@@ -343,11 +344,12 @@ namespace scribo::internal
                                                          const Descriptor& descriptor)
   {
     std::vector<Tracker> new_trackers;
+    std::vector<Tracker> accepted;
 
     size_t id = 0;
     for (const auto& obs : observations)
     {
-      std::vector<Tracker> accepted = find_match(buckets, obs, t, max_sigma_pos, descriptor);
+      find_match(buckets, obs, t, max_sigma_pos, descriptor, accepted);
       if (accepted.empty() && obs(1, 0) < descriptor.max_thickness)
         new_trackers.emplace_back(t, obs, descriptor);
       else
@@ -357,44 +359,49 @@ namespace scribo::internal
     return new_trackers;
   }
 
-  /**
-   *
-   * @param image
-   * @param discontinuity
-   * @param descriptor
-   * @return
-   */
+  Traversal::Traversal(int n_max, const Descriptor& descriptor)
+    : m_descriptor(descriptor)
+    , m_buckets(n_max, descriptor.bucket_size)
+  {
+  }
+
+  void Traversal::step(int t, std::vector<Eigen::Matrix<float, 3, 1>>& observations)
+  {
+    float max_dist = make_predictions(m_trackers);
+
+    m_buckets.acquire(m_trackers);
+    m_new_trackers = match_observations_to_predictions(observations, m_buckets, t, max_dist, m_descriptor);
+    m_buckets.release(m_trackers);
+
+    m_tracker_kept = tracker_selection(m_trackers, m_segments, t, m_descriptor);
+
+    get_active_trackers(m_trackers, m_tracker_kept, m_new_trackers);
+  }
+
+  void Traversal::finish()
+  {
+    finish_traversal(m_trackers, m_segments, m_descriptor);
+    m_trackers.clear();
+  }
+
   std::vector<Segment> traversal(const image2d<uint8_t>& image, const Descriptor& descriptor)
   {
     int n_max = image.size(1), t_max = image.size(0);
 
-    Buckets buckets(n_max, descriptor.bucket_size);
+    Traversal            tr(n_max, descriptor);
+    ObservationExtractor extractor(image, descriptor);
 
-    std::vector<Segment>                    segments; // List of current segments
-    std::vector<Tracker>                    trackers;
-    std::vector<Tracker>                    new_trackers;
-    std::vector<Tracker>                    tracker_kept;
     std::vector<Eigen::Matrix<float, 3, 1>> observations;
 
     for (int t = 0; t < t_max; t++)
     {
-      float max_dist = make_predictions(trackers);
-
-      observations = extract_observations(image, t, n_max, descriptor);
-
-      buckets.acquire(trackers);
-      new_trackers = match_observations_to_predictions(observations, buckets, t, max_dist, descriptor);
-      buckets.release(trackers);
-
-      tracker_kept = tracker_selection(trackers, segments, t, descriptor);
-
-      // i_f = 0;
-      get_active_trackers(trackers, tracker_kept, new_trackers);
+      extractor.extract(t, observations);
+      tr.step(t, observations);
     }
 
-    finish_traversal(trackers, segments, descriptor);
+    tr.finish();
 
-    return segments;
+    return std::move(tr.segments());
   }
 
   image2d<std::uint8_t> transpose(image2d<std::uint8_t> img)
@@ -427,6 +434,8 @@ namespace scribo::internal
   std::pair<std::vector<Segment>, std::vector<Segment>> process(const image2d<std::uint8_t>& image,
                                                                 const Descriptor&            descriptor)
   {
+    mln_entering("scribo::internal::process");
+
     // Horizontal traversal
     std::vector<Segment> horizontal_segments;
     if (descriptor.traversal_mode != e_segdet_process_traversal_mode::VERTICAL)
@@ -11,6 +11,7 @@ namespace scribo::internal
   {
     std::unique_ptr<Tracker_impl> impl;
 
+    Tracker() = default; // Empty tracker (unused slot of the buckets)
     Tracker(int t_integration, Eigen::Matrix<float, 3, 1> observation, const Descriptor& descriptor);
     ~Tracker() = default;
 
@@ -8,13 +8,11 @@ namespace scribo::internal
   struct Descriptor;
 
   /**
-   * Compute the standard deviation of the diven vector
-   * @tparam T The type of a vector
-   * @param vec The given vector
+   * Compute the standard deviation of the diven history
+   * @param vec The given history
    * @return A float that is the standard deviation of the series
    */
-  template <typename T>
-  float std(const std::vector<T>& vec)
+  float std(const History& vec)
   {
     const size_t sz = vec.size();
     if (sz == 1)
@@ -38,22 +36,20 @@ namespace scribo::internal
   }
 
   Tracker_impl::Tracker_impl(int t_integration, Eigen::Matrix<float, 3, 1> obs, const Descriptor& descriptor)
-    : observation(std::nullopt)
+    : t_values(std::max(descriptor.nb_values_to_keep, 1) + 1)
+    , n_values(std::max(descriptor.nb_values_to_keep, 1) + 1)
+    , thicknesses(std::max(descriptor.nb_values_to_keep, 1) + 1)
+    , luminosities(std::max(descriptor.nb_values_to_keep, 1) + 1)
+    , observation(std::nullopt)
     , observation_distance(0)
     , last_integration(t_integration)
     , reg(t_integration, obs(0, 0))
   {
-    first    = t_integration;
-    t_values = std::vector<float>({static_cast<float>(t_integration)});
-    n_values = std::vector<float>({obs(0, 0)});
-
-    thicknesses  = std::vector<float>({obs(1, 0)});
-    luminosities = std::vector<float>({obs(2, 0)});
-
-    t_values.reserve(descriptor.nb_values_to_keep);
-    n_values.reserve(descriptor.nb_values_to_keep);
-    thicknesses.reserve(descriptor.nb_values_to_keep);
-    luminosities.reserve(descriptor.nb_values_to_keep);
+    first = t_integration;
+    t_values.push_back(static_cast<float>(t_integration));
+    n_values.push_back(obs(0, 0));
+    thicknesses.push_back(obs(1, 0));
+    luminosities.push_back(obs(2, 0));
 
     current_slope = 0;
 
@@ -177,14 +173,14 @@ namespace scribo::internal
 
     if (static_cast<int>(n_values.size()) > descriptor.nb_values_to_keep)
     {
-      auto thick = thicknesses[0];
-      auto nn    = n_values[0];
-      auto tt    = t_values[0];
-
-      n_values.erase(n_values.begin());
-      t_values.erase(t_values.begin());
-      thicknesses.erase(thicknesses.begin());
-      luminosities.erase(luminosities.begin());
+      auto thick = thicknesses.front();
+      auto nn    = n_values.front();
+      auto tt    = t_values.front();
+
+      n_values.pop_front();
+      t_values.pop_front();
+      thicknesses.pop_front();
+      luminosities.pop_front();
 
       Span span{};
       span.x         = tt;
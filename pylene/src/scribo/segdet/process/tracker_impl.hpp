@@ -1,5 +1,6 @@
 #pragma once
 
+#include "history.hpp"
 #include "linearregression.hpp"
 
 #include "../descriptor.hpp"
@@ -32,10 +33,10 @@ namespace scribo::internal
   {
     int first; // t value of first integration
 
-    std::vector<float> t_values; // t values of SEGDET_NB_VALUES_TO_KEEP last integrations
-    std::vector<float> n_values;
-    std::vector<float> thicknesses;
-    std::vector<float> luminosities;
+    History t_values; // t values of SEGDET_NB_VALUES_TO_KEEP last integrations
+    History n_values;
+    History thicknesses;
+    History luminosities;
 
     float current_slope; // Allowed the handling of early stop of tracker
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/image/ndimage_fwd.hpp>
+
+#include "../descriptor.hpp"
+#include "../segment.hpp"
+#include "bucket.hpp"
+
+namespace scribo::internal
+{
+  /**
+   * The Traversal class performs the tracking of a traversal one position t at a time. The observations of the
+   * successive positions are given step by step, so the whole image does not have to be available at once, and the
+   * segments are produced as soon as their trackers end.
+   */
+  class Traversal
+  {
+  public:
+    /**
+     * @param n_max The size of the observed columns
+     * @param descriptor Parameters of the line detection
+     */
+    Traversal(int n_max, const Descriptor& descriptor);
+
+    /**
+     * Match the observations of the position t with the trackers (t must be greater than the previous positions)
+     * @param t The position
+     * @param observations The observations of the column t
+     */
+    void step(int t, std::vector<Eigen::Matrix<float, 3, 1>>& observations);
+
+    /**
+     * End the trackers still alive, producing their segments
+     */
+    void finish();
+
+    /**
+     * The segments ended so far (they may be moved out between two steps)
+     */
+    std::vector<Segment>& segments() noexcept { return m_segments; }
+
+  private:
+    const Descriptor&    m_descriptor;
+    Buckets              m_buckets;
+    std::vector<Segment> m_segments;
+    std::vector<Tracker> m_trackers;
+    std::vector<Tracker> m_new_trackers;
+    std::vector<Tracker> m_tracker_kept;
+  };
+
+  /**
+   * Perform a whole traversal of the image (t along the width, n along the height)
+   * @param image The image to traverse
+   * @param descriptor Parameters of the line detection
+   * @return The segments detected
+   */
+  std::vector<Segment> traversal(const image2d<uint8_t>& image, const Descriptor& descriptor);
+
+  /**
+   * Swap the coordinates of segments detected on a transposed image
+   * @param segments The segments, marked as vertical
+   */
+  void transpose_segments(std::vector<Segment>& segments);
+} // namespace scribo::internal
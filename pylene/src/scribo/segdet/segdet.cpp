@@ -3,6 +3,9 @@
 
 #include <scribo/segdet.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
 namespace scribo
 {
   using namespace internal;
@@ -35,4 +38,25 @@ namespace scribo
     auto ret = std::make_tuple(std::get<0>(labels), std::get<1>(labels), vsegs);
     return ret;
   }
-} // namespace scribo
\ No newline at end of file
+
+  std::vector<std::vector<VSegment>> detect_line_batch(std::span<const mln::image2d<std::uint8_t>> images, int min_len,
+                                                       const SegDetParams& params, int nthreads)
+  {
+    std::vector<std::vector<VSegment>> ret(images.size());
+
+    auto run = [&] {
+      tbb::parallel_for(std::size_t(0), images.size(),
+                        [&](std::size_t i) { ret[i] = detect_line_vector(images[i], min_len, params); });
+    };
+
+    if (nthreads > 0)
+    {
+      tbb::task_arena arena(nthreads);
+      arena.execute(run);
+    }
+    else
+      run();
+
+    return ret;
+  }
+} // namespace scribo
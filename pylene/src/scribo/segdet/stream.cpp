@@ -0,0 +1,219 @@
+#include "detect_line.hpp"
+#include "process/extractors/extract_observation.hpp"
+#include "process/traversal.hpp"
+#include "segment_to_X.hpp"
+
+#include <scribo/segdet.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace scribo
+{
+  using namespace internal;
+
+  /*
+   * The rows of the image are kept in a buffer from m_y0 to the last row pushed. The rows before m_done have been
+   * traversed by the vertical traversal. The horizontal segments whose top is above m_cut have been returned; the next
+   * horizontal window starts overlap / 2 rows above m_cut so that the segments crossing m_cut are not truncated. The
+   * buffered rows are already preprocessed: each row is preprocessed once, when it is pushed.
+   */
+  struct StreamingLineDetector::impl_t
+  {
+    impl_t(int width, int min_len, const SegDetParams& params, int overlap)
+      : m_descriptor(checked_params(params), min_len)
+      , m_width(checked_width(width))
+      , m_overlap(overlap < 0 ? 2 * params.max_thickness : overlap)
+      , m_vertical(m_width, m_descriptor)
+    {
+    }
+
+    std::vector<VSegment> push(const mln::image2d<std::uint8_t>& band)
+    {
+      if (m_finished)
+        throw std::runtime_error("The detector has already finished");
+      if (band.width() != m_width)
+        throw std::runtime_error("The band width does not match the width of the detector");
+
+      // Preprocess the new rows only (the preprocessing is pointwise)
+      const int h = band.height();
+      m_rows.resize(m_rows.size() + static_cast<std::size_t>(h) * m_width);
+      std::uint8_t* dst = m_rows.data() + m_rows.size() - static_cast<std::size_t>(h) * m_width;
+      for (int y = 0; y < h; y++)
+      {
+        const std::uint8_t* src = band.buffer() + y * band.byte_stride();
+        std::uint8_t*       row = dst + static_cast<std::ptrdiff_t>(y) * m_width;
+        if (m_descriptor.negate_image)
+          std::transform(src, src + m_width, row, [](std::uint8_t v) -> std::uint8_t { return 255 - v; });
+        else
+          std::memcpy(row, src, m_width);
+      }
+
+      return process(false);
+    }
+
+    std::vector<VSegment> finish()
+    {
+      if (m_finished)
+        throw std::runtime_error("The detector has already finished");
+
+      auto ret   = process(true);
+      m_finished = true;
+      m_rows     = {};
+      return ret;
+    }
+
+  private:
+    static const SegDetParams& checked_params(const SegDetParams& params)
+    {
+      if (params.preprocess == e_segdet_preprocess::BLACK_TOP_HAT)
+        throw std::runtime_error("The BLACK_TOP_HAT preprocessing is not supported by the streaming line detector");
+      return params;
+    }
+
+    static int checked_width(int width)
+    {
+      if (width <= 0)
+        throw std::runtime_error("The width of the image must be positive");
+      return width;
+    }
+
+    int row_count() const noexcept { return static_cast<int>(m_rows.size() / m_width); }
+
+    // View (without copy) of the rows [y0, y1) of the image img whose first row is m_y0
+    image2d<std::uint8_t> view_rows(image2d<std::uint8_t>& img, int y0, int y1) const
+    {
+      int            sizes[2]   = {m_width, y1 - y0};
+      std::ptrdiff_t strides[2] = {1, img.byte_stride()};
+      return image2d<std::uint8_t>::from_buffer(img.buffer() + (y0 - m_y0) * img.byte_stride(), sizes, strides);
+    }
+
+    void emit(std::vector<Segment>& segments, int y_offset, std::vector<VSegment>& out)
+    {
+      for (const auto& vseg : segment_to_vsegment(segments))
+      {
+        VSegment s = vseg;
+        s.label    = m_label++;
+        s.y0 += y_offset;
+        s.y1 += y_offset;
+        out.push_back(s);
+      }
+    }
+
+    std::vector<VSegment> process(bool final)
+    {
+      std::vector<VSegment> out;
+
+      const int y1 = m_y0 + row_count();
+      if (y1 <= m_done && !final)
+        return out;
+
+      // View of the buffered rows (without copy)
+      image2d<std::uint8_t> img;
+      if (y1 > m_y0)
+      {
+        int sizes[2] = {m_width, y1 - m_y0};
+        img          = image2d<std::uint8_t>::from_buffer(m_rows.data(), sizes);
+      }
+
+      // Vertical segments: each row is a column of the transposed image
+      if (m_descriptor.traversal_mode != e_segdet_process_traversal_mode::HORIZONTAL)
+      {
+        for (int y = m_done; y < y1; y++)
+        {
+          m_observations.clear();
+          extract_column_observations(img.buffer() + (y - m_y0) * img.byte_stride(), m_width, m_descriptor,
+                                      m_observations);
+          m_vertical.step(y, m_observations);
+        }
+        if (final)
+          m_vertical.finish();
+
+        auto& segments = m_vertical.segments();
+        transpose_segments(segments);
+        keep_long_segments(segments);
+        emit(segments, 0, out);
+        segments.clear();
+      }
+      m_done = y1;
+
+      // Horizontal segments whose top is in [m_cut, cut), detected on the window [h0, y1). The windows are processed
+      // once they advance by half of the overlap at least, to bound the cost of the rows traversed twice.
+      const int half = m_overlap / 2;
+      const int cut  = final ? y1 : y1 - half;
+      if (m_descriptor.traversal_mode != e_segdet_process_traversal_mode::VERTICAL && cut > m_cut &&
+          (final || cut - m_cut >= half))
+      {
+        const int h0       = std::max(0, m_cut - half);
+        auto      segments = traversal(view_rows(img, h0, y1), m_descriptor);
+
+        std::erase_if(segments, [&](const Segment& s) {
+          const float y = top(s) + h0;
+          return y < m_cut || y >= cut;
+        });
+        keep_long_segments(segments);
+        emit(segments, h0, out);
+        m_cut = cut;
+      }
+
+      // Keep the rows of the next window
+      int first_needed = m_done;
+      if (m_descriptor.traversal_mode != e_segdet_process_traversal_mode::VERTICAL)
+        first_needed = std::min(first_needed, m_cut - half);
+      const int keep_from = std::clamp(first_needed, m_y0, y1);
+      m_rows.erase(m_rows.begin(), m_rows.begin() + static_cast<std::ptrdiff_t>(keep_from - m_y0) * m_width);
+      m_y0 = keep_from;
+
+      return out;
+    }
+
+    // First row reached by a segment
+    static float top(const Segment& s)
+    {
+      float t = std::numeric_limits<float>::max();
+      for (const auto* spans : {&s.spans, &s.under_other_object})
+        for (const auto& span : *spans)
+          t = std::min(t, span.y - span.thickness / 2.f);
+      return t;
+    }
+
+    void keep_long_segments(std::vector<Segment>& segments) const
+    {
+      std::erase_if(segments, [this](const Segment& s) { return s.length < m_descriptor.min_length; });
+    }
+
+    Descriptor                              m_descriptor;
+    int                                     m_width;
+    int                                     m_overlap;
+    Traversal                               m_vertical;
+    std::vector<Eigen::Matrix<float, 3, 1>> m_observations;
+    std::vector<std::uint8_t>               m_rows;      // The buffered rows
+    int                                     m_y0    = 0; // Index of the first buffered row
+    int                                     m_done  = 0; // Rows before m_done are traversed vertically
+    int                                     m_cut   = 0; // The horizontal segments above m_cut are returned
+    int                                     m_label = first_label;
+    bool                                    m_finished = false;
+  };
+
+
+  StreamingLineDetector::StreamingLineDetector(int width, int min_len, const SegDetParams& params, int overlap)
+    : m_impl(std::make_unique<impl_t>(width, min_len, params, overlap))
+  {
+  }
+
+  StreamingLineDetector::~StreamingLineDetector()                                       = default;
+  StreamingLineDetector::StreamingLineDetector(StreamingLineDetector&&) noexcept            = default;
+  StreamingLineDetector& StreamingLineDetector::operator=(StreamingLineDetector&&) noexcept = default;
+
+  std::vector<VSegment> StreamingLineDetector::push(const mln::image2d<std::uint8_t>& band)
+  {
+    return m_impl->push(band);
+  }
+
+  std::vector<VSegment> StreamingLineDetector::finish()
+  {
+    return m_impl->finish();
+  }
+} // namespace scribo
@@ -4,9 +4,17 @@
 #include <mln/core/algorithm/accumulate.hpp>
 #include <mln/filters/nms.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/spin_mutex.h>
+#include <xsimd/xsimd.hpp>
+
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <version>
 
@@ -16,12 +24,31 @@
 
 namespace mln::transforms
 {
+  namespace
+  {
+    using simd_float_t = xsimd::simd_type<float>;
+    using simd_int_t   = xsimd::batch<std::int32_t, simd_float_t::size>;
+
+    // Number of points gathered before casting their votes
+    constexpr std::size_t kPointBatchSize = 1024;
+
+
+    template <class T, class W>
+    void cast_votes(T* __restrict acc, const int* __restrict indexes, std::size_t n, W w) noexcept
+    {
+      for (std::size_t i = 0; i < n; ++i)
+        acc[indexes[i]] += w;
+    }
+  } // namespace
 
   void HoughLineAccumulator::_init(std::span<float> angles, float max_distance)
   {
-    m_count = angles.size();
-    m_sin_angles = std::unique_ptr<float[]>(new float[m_count]);
-    m_cos_angles = std::unique_ptr<float[]>(new float[m_count]);
+    constexpr std::size_t WARP_SIZE = simd_float_t::size;
+
+    m_count        = angles.size();
+    m_padded_count = (m_count + WARP_SIZE - 1) / WARP_SIZE * WARP_SIZE;
+    m_sin_angles   = std::unique_ptr<float[]>(new float[m_padded_count]());
+    m_cos_angles   = std::unique_ptr<float[]>(new float[m_padded_count]());
 
     std::transform(angles.begin(), angles.end(), m_sin_angles.get(), [](float x) { return std::sin(x); });
     std::transform(angles.begin(), angles.end(), m_cos_angles.get(), [](float x) { return std::cos(x); });
@@ -29,6 +56,45 @@ namespace mln::transforms
     m_max_distance = static_cast<int>(std::ceil(max_distance));
   }
 
+  void HoughLineAccumulator::_init_indexes()
+  {
+    m_base_indexes = std::unique_ptr<int[]>(new int[m_padded_count]);
+    m_indexes      = std::unique_ptr<int[]>(new int[m_padded_count]);
+
+    const int offset = m_max_distance * static_cast<int>(m_acc.stride(1));
+    for (std::size_t i = 0; i < m_padded_count; ++i)
+      m_base_indexes[i] = offset + static_cast<int>(i);
+  }
+
+  // Compute the index in the accumulator of the vote of p for each angle:
+  // (m_max_distance + round(sin(α) * x + cos(α) * y)) * stride + i
+  const int* HoughLineAccumulator::_compute_indexes(point2d p) noexcept
+  {
+    constexpr std::size_t WARP_SIZE = simd_float_t::size;
+
+    const simd_float_t x(static_cast<float>(p.x()));
+    const simd_float_t y(static_cast<float>(p.y()));
+    const simd_int_t   stride(static_cast<std::int32_t>(m_acc.stride(1)));
+
+    for (std::size_t i = 0; i < m_padded_count; i += WARP_SIZE)
+    {
+      simd_float_t s      = xsimd::load_unaligned(m_sin_angles.get() + i);
+      simd_float_t c      = xsimd::load_unaligned(m_cos_angles.get() + i);
+      simd_int_t   radius = xsimd::to_int(xsimd::round(s * x + c * y));
+      simd_int_t   base   = xsimd::load_unaligned(m_base_indexes.get() + i);
+      xsimd::store_unaligned(m_indexes.get() + i, base + radius * stride);
+    }
+
+#ifndef NDEBUG
+    for (std::size_t i = 0; i < m_count; ++i)
+    {
+      [[maybe_unused]] int radius = static_cast<int>(m_indexes[i] - m_base_indexes[i]) / static_cast<int>(m_acc.stride(1));
+      assert(-m_max_distance <= radius && radius <= m_max_distance);
+    }
+#endif
+    return m_indexes.get();
+  }
+
   HoughLineAccumulator::HoughLineAccumulator(std::span<float> angles, float max_distance, mln::ndbuffer_image* acc)
   {
     this->_init(angles, max_distance);
@@ -41,6 +107,12 @@ namespace mln::transforms
         m_acc.width(), m_acc.height());
       throw std::runtime_error(msg);
     }
+
+    auto st = m_acc.sample_type();
+    if (m_acc.pdim() != 2 || (st != sample_type_id::INT32 && st != sample_type_id::UINT16 && st != sample_type_id::FLOAT))
+      throw std::runtime_error("Invalid accumulator image (the value type must be int, uint16 or float)");
+
+    this->_init_indexes();
   }
 
   HoughLineAccumulator::HoughLineAccumulator(std::span<float> angles, float max_distance, bool weighted)
@@ -58,41 +130,69 @@ namespace mln::transforms
       m_acc = mln::image2d<float>(w, h, bparams);
     else
       m_acc = mln::image2d<int>(w, h, bparams);
+
+    this->_init_indexes();
   }
 
   void HoughLineAccumulator::take(point2d p) noexcept
   {
-    int offset = m_max_distance;
-    auto& acc = m_acc.__cast<int, 2>();
-    for (std::size_t i = 0; i < m_count; ++i)
-    {
-      int radius = std::round(m_sin_angles[i] * p.x() + m_cos_angles[i] * p.y());
-      assert(-m_max_distance <= radius && radius <= m_max_distance);
-      acc({(int)i, offset + radius}) += 1;
-    }
+    this->take(std::span<const point2d>(&p, 1));
   }
 
   void HoughLineAccumulator::take(point2d p, float w) noexcept
   {
-    int offset = m_max_distance;
-    auto& acc = m_acc.__cast<float, 2>();
-    for (std::size_t i = 0; i < m_count; ++i)
+    this->take(std::span<const point2d>(&p, 1), std::span<const float>(&w, 1));
+  }
+
+  void HoughLineAccumulator::take(std::span<const point2d> points) noexcept
+  {
+    std::byte* acc = m_acc.buffer();
+    switch (m_acc.sample_type())
     {
-      int radius = std::round(m_sin_angles[i] * p.x() + m_cos_angles[i] * p.y());
-      assert(-m_max_distance <= radius && radius <= m_max_distance);
-      acc({(int)i, offset + radius}) += w;
+    case sample_type_id::INT32:
+      for (auto p : points)
+        cast_votes(reinterpret_cast<int*>(acc), this->_compute_indexes(p), m_count, 1);
+      break;
+    case sample_type_id::UINT16:
+      for (auto p : points)
+        cast_votes(reinterpret_cast<std::uint16_t*>(acc), this->_compute_indexes(p), m_count, 1);
+      break;
+    default:
+      assert(false && "Unweighted votes require an integral accumulator.");
     }
   }
 
+  void HoughLineAccumulator::take(std::span<const point2d> points, std::span<const float> weights) noexcept
+  {
+    assert(points.size() == weights.size());
+    assert(m_acc.sample_type() == sample_type_id::FLOAT);
+
+    float* acc = reinterpret_cast<float*>(m_acc.buffer());
+    for (std::size_t i = 0; i < points.size(); ++i)
+      cast_votes(acc, this->_compute_indexes(points[i]), m_count, weights[i]);
+  }
+
 
   mln::image2d<int> hough_lines(const image2d<bool>& input, std::span<float> angles, image2d<int>* out)
   {
     float max_distance = std::hypot(input.width(), input.height());
     auto hl = out ? HoughLineAccumulator{angles, max_distance, out} : HoughLineAccumulator{angles, max_distance, false};
 
+    std::vector<point2d> points;
+    points.reserve(kPointBatchSize);
+
     mln_foreach(auto px, input.pixels())
-      if (px.val())
-        hl.take(px.point());
+    {
+      if (!px.val())
+        continue;
+      points.push_back(px.point());
+      if (points.size() == kPointBatchSize)
+      {
+        hl.take(points);
+        points.clear();
+      }
+    }
+    hl.take(points);
 
     return hl.get_accumulator_image();
   }
@@ -103,13 +203,149 @@ namespace mln::transforms
     float max_distance = std::hypot(input.width(), input.height());
     auto hl = out ? HoughLineAccumulator{angles, max_distance, out} : HoughLineAccumulator{angles, max_distance, true};
 
+    std::vector<point2d> points;
+    std::vector<float>   weights;
+    points.reserve(kPointBatchSize);
+    weights.reserve(kPointBatchSize);
+
     mln_foreach(auto px, input.pixels())
-      if (px.val() > 0)
-        hl.take(px.point(), px.val());
+    {
+      if (!(px.val() > 0))
+        continue;
+      points.push_back(px.point());
+      weights.push_back(px.val());
+      if (points.size() == kPointBatchSize)
+      {
+        hl.take(points, weights);
+        points.clear();
+        weights.clear();
+      }
+    }
+    hl.take(points, weights);
 
     return hl.get_waccumulator_image();
   }
 
+  namespace parallel
+  {
+    namespace
+    {
+      // Grain size (in points) of the parallel vote
+      constexpr std::size_t kGrainSize = 4096;
+
+      template <class T>
+      std::vector<point2d> foreground_points(const image2d<T>& input, std::vector<float>* weights)
+      {
+        std::vector<point2d> points;
+        mln_foreach(auto px, input.pixels())
+        {
+          if (px.val() > 0)
+          {
+            points.push_back(px.point());
+            if (weights)
+              weights->push_back(static_cast<float>(px.val()));
+          }
+        }
+        return points;
+      }
+
+      /// Vote with per-thread accumulators of type Acc, merged in the output
+      /// If Acc is 16-bit, the private accumulator of a thread is flushed in the output before it may overflow.
+      template <class Acc, class O>
+      image2d<O> hough_lines_T(image2d<O> output, std::span<float> angles, float max_distance,
+                               std::span<const point2d> points, std::span<const float> weights)
+      {
+        constexpr bool    weighted  = std::is_floating_point_v<Acc>;
+        const std::size_t max_votes = std::is_same_v<Acc, std::uint16_t> ? std::numeric_limits<std::uint16_t>::max()
+                                                                         : std::numeric_limits<std::size_t>::max();
+
+        struct local_t
+        {
+          image2d<Acc>         acc;
+          HoughLineAccumulator hl;
+          std::size_t          count = 0; // Number of points since the last flush
+        };
+
+        auto make_local = [&]() {
+          image2d<Acc> acc(output.width(), output.height(), image_build_params{.border = 0, .init_value = Acc(0)});
+          HoughLineAccumulator hl(angles, max_distance, &acc);
+          return local_t{std::move(acc), std::move(hl)};
+        };
+
+        tbb::enumerable_thread_specific<local_t> locals(make_local);
+        tbb::spin_mutex                           mutex;
+
+        // Add the votes of a private accumulator to the output
+        auto merge = [&output](const image2d<Acc>& acc, int y0, int y1) {
+          for (int y = y0; y < y1; ++y)
+          {
+            const Acc* in  = acc.buffer() + y * acc.stride(1);
+            O*         out = output.buffer() + y * output.stride(1);
+            for (int x = 0; x < output.width(); ++x)
+              out[x] += static_cast<O>(in[x]);
+          }
+        };
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, points.size(), kGrainSize),
+                          [&](const tbb::blocked_range<std::size_t>& rng) {
+                            local_t& local = locals.local();
+                            for (std::size_t i = rng.begin(); i < rng.end();)
+                            {
+                              if (local.count == max_votes)
+                              {
+                                {
+                                  tbb::spin_mutex::scoped_lock lock(mutex);
+                                  merge(local.acc, 0, output.height());
+                                }
+                                std::fill_n(local.acc.buffer(), local.acc.stride(1) * local.acc.height(), Acc(0));
+                                local.count = 0;
+                              }
+
+                              std::size_t n = std::min(rng.end() - i, max_votes - local.count);
+                              if constexpr (weighted)
+                                local.hl.take(points.subspan(i, n), weights.subspan(i, n));
+                              else
+                                local.hl.take(points.subspan(i, n));
+                              local.count += n;
+                              i += n;
+                            }
+                          });
+
+        tbb::parallel_for(tbb::blocked_range<int>(0, output.height()), [&](const tbb::blocked_range<int>& rng) {
+          for (const auto& local : locals)
+            merge(local.acc, rng.begin(), rng.end());
+        });
+
+        return output;
+      }
+    } // namespace
+
+    mln::image2d<int> hough_lines(const image2d<bool>& input, std::span<float> angles, image2d<int>* out,
+                                  bool use_16bit_accumulators)
+    {
+      float max_distance = std::hypot(input.width(), input.height());
+      auto  hl = out ? HoughLineAccumulator{angles, max_distance, out} : HoughLineAccumulator{angles, max_distance, false};
+      auto  output = hl.get_accumulator_image();
+
+      auto points = foreground_points(input, nullptr);
+      if (use_16bit_accumulators)
+        return hough_lines_T<std::uint16_t>(output, angles, max_distance, points, {});
+      else
+        return hough_lines_T<int>(output, angles, max_distance, points, {});
+    }
+
+    mln::image2d<float> hough_lines(const image2d<float>& input, std::span<float> angles, image2d<float>* out)
+    {
+      float max_distance = std::hypot(input.width(), input.height());
+      auto  hl = out ? HoughLineAccumulator{angles, max_distance, out} : HoughLineAccumulator{angles, max_distance, true};
+      auto  output = hl.get_waccumulator_image();
+
+      std::vector<float> weights;
+      auto               points = foreground_points(input, &weights);
+      return hough_lines_T<float>(output, angles, max_distance, points, weights);
+    }
+  } // namespace parallel
+
   namespace
   {
 
@@ -118,17 +354,16 @@ namespace mln::transforms
     hough_lines_detect_peaks_T(const image2d<T>& acc, std::span<float> angles, float reject, int min_sep_distance,
                                int min_sep_angle, int num_peaks)
     {
-      image2d<T> nms_image;
-
       T    minv = static_cast<T>(reject * mln::accumulate(acc, accu::accumulators::max<T>()));
-      auto res  = mln::filters::nms(acc, min_sep_angle, min_sep_distance, minv, num_peaks, &nms_image);
+      auto res  = mln::filters::nms(acc, min_sep_angle, min_sep_distance, minv, num_peaks);
 
+      // A peak is the max of its NMS window, so its count is the value of the accumulator
       float                  offset = acc.height() / 2;
       std::vector<HoughLine> out(res.size());
       std::transform(res.begin(), res.end(), out.begin(), [&, offset](point2d p) {
         return HoughLine{.angle  = angles[p.x()],  //
                          .radius = p.y() - offset, //
-                         .count  = float(nms_image(p))};
+                         .count  = float(acc(p))};
       });
 
       std::sort(out.begin(), out.end(), [](auto a, auto b) { return a.count > b.count; });
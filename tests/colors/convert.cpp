@@ -0,0 +1,70 @@
+#include <mln/colors/convert.hpp>
+
+#include <mln/core/range/foreach.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+
+namespace
+{
+  // All the channel values appear in a small image
+  mln::image2d<mln::rgb8> make_input()
+  {
+    mln::image2d<mln::rgb8> f(257, 31);
+
+    std::uint32_t s = 42;
+    mln_foreach (auto px, f.pixels())
+    {
+      s        = s * 1664525u + 1013904223u;
+      auto x    = static_cast<std::uint8_t>(px.point().x());
+      px.val() = mln::rgb8{x, static_cast<std::uint8_t>(s >> 24), static_cast<std::uint8_t>(s >> 16)};
+    }
+    return f;
+  }
+
+  template <class I, class F>
+  void check(const mln::image2d<mln::rgb8>& f, const I& out, F ref, float tolerance)
+  {
+    ASSERT_EQ(f.domain(), out.domain());
+    mln_foreach (auto p, f.domain())
+    {
+      auto expected = ref(f(p));
+      for (int c = 0; c < 3; ++c)
+        ASSERT_LE(std::abs(static_cast<float>(out(p)[c]) - static_cast<float>(expected[c])), tolerance)
+            << "at (" << p.x() << ", " << p.y() << ") channel " << c;
+    }
+  }
+} // namespace
+
+
+TEST(Colors, convert_xyz)
+{
+  auto f = make_input();
+  check(f, mln::colors::convert(f, mln::xyz_tag{}), [](auto v) { return mln::rgb2xyz(v); }, 1e-3f);
+  check(f, mln::colors::parallel::convert(f, mln::xyz_tag{}), [](auto v) { return mln::rgb2xyz(v); }, 1e-3f);
+}
+
+TEST(Colors, convert_lab)
+{
+  auto f = make_input();
+  check(f, mln::colors::convert(f, mln::lab_tag{}), [](auto v) { return mln::rgb2lab(v); }, 1e-3f);
+  check(f, mln::colors::parallel::convert(f, mln::lab_tag{}), [](auto v) { return mln::rgb2lab(v); }, 1e-3f);
+}
+
+TEST(Colors, convert_lsh)
+{
+  auto f = make_input();
+  check(f, mln::colors::convert(f, mln::lsh_tag{}), [](auto v) { return mln::rgb2lsh(v); }, 0);
+  check(f, mln::colors::parallel::convert(f, mln::lsh_tag{}), [](auto v) { return mln::rgb2lsh(v); }, 0);
+}
+
+TEST(Colors, convert_ycbcr)
+{
+  // The lookup tables give the same products; allow a rounding difference if the compiler contracts the scalar version
+  auto f = make_input();
+  check(f, mln::colors::convert(f, mln::ycbcr_tag{}), [](auto v) { return mln::rgb2ycbcr(v); }, 1);
+  check(f, mln::colors::parallel::convert(f, mln::ycbcr_tag{}), [](auto v) { return mln::rgb2ycbcr(v); }, 1);
+}
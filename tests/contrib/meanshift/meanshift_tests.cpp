@@ -0,0 +1,120 @@
+#include <mln/contrib/meanshift/meanshift.hpp>
+
+#include <mln/core/algorithm/fill.hpp>
+#include <mln/core/algorithm/generate.hpp>
+#include <mln/core/colors.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/range/foreach.hpp>
+
+#include <fixtures/ImageCompare/image_compare.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+
+namespace
+{
+  // Reference implementation in double precision
+  mln::image2d<mln::rgb8> meanshift_ref(const mln::image2d<mln::rgb8>& f, float hs, float hr, int radius, int niter)
+  {
+    const double hs2  = hs * hs;
+    const double hr2  = hr * hr;
+    const double eps2 = 0.1 * 0.1;
+
+    mln::image2d<mln::rgb8> out;
+    mln::resize(out, f);
+
+    mln_foreach (auto p, f.domain())
+    {
+      double px = p.x(), py = p.y(), v[3];
+      for (int c = 0; c < 3; ++c)
+        v[c] = f(p)[c];
+
+      bool stop = false;
+      for (int i = 0; i <= niter && !stop; ++i)
+      {
+        double sx = 0, sy = 0, sv[3] = {0, 0, 0}, s = 0;
+        for (int qy = p.y() - radius; qy <= p.y() + radius; ++qy)
+          for (int qx = p.x() - radius; qx <= p.x() + radius; ++qx)
+          {
+            if (!f.domain().has({qx, qy}))
+              continue;
+
+            auto   fq = f({qx, qy});
+            double d0 = ((px - qx) * (px - qx) + (py - qy) * (py - qy)) / hs2;
+            double d1 = 0;
+            for (int c = 0; c < 3; ++c)
+              d1 += (v[c] - fq[c]) * (v[c] - fq[c]);
+            double w = std::exp(-(d0 + d1 / hr2));
+            sx += w * qx;
+            sy += w * qy;
+            for (int c = 0; c < 3; ++c)
+              sv[c] += w * fq[c];
+            s += w;
+          }
+
+        double nx = sx / s, ny = sy / s, nv[3];
+        for (int c = 0; c < 3; ++c)
+          nv[c] = sv[c] / s;
+
+        stop = (nx == px && ny == py);
+        if (!stop)
+        {
+          double d = (px - nx) * (px - nx) + (py - ny) * (py - ny);
+          for (int c = 0; c < 3; ++c)
+            d += (v[c] - nv[c]) * (v[c] - nv[c]);
+          stop = d < eps2;
+        }
+        px = nx;
+        py = ny;
+        for (int c = 0; c < 3; ++c)
+          v[c] = nv[c];
+      }
+
+      for (int c = 0; c < 3; ++c)
+        out(p)[c] = static_cast<uint8_t>(v[c]);
+    }
+    return out;
+  }
+} // namespace
+
+
+TEST(Contrib, meanshift_same_as_reference)
+{
+  std::mt19937 gen(42);
+
+  mln::image2d<mln::rgb8> f(37, 23);
+  mln::generate(f, [&]() { return mln::rgb8{uint8_t(gen()), uint8_t(gen()), uint8_t(gen())}; });
+
+  auto ref = meanshift_ref(f, 5, 15, 3, 10);
+  auto res = mln::contrib::meanshift(f, 5, 15, {.radius = 3, .max_iterations = 10});
+
+  // The float kernel may round the converged values differently
+  mln_foreach (auto p, f.domain())
+    for (int c = 0; c < 3; ++c)
+      ASSERT_LE(std::abs(ref(p)[c] - res(p)[c]), 1) << p;
+}
+
+TEST(Contrib, meanshift_parallel_same_as_sequential)
+{
+  std::mt19937 gen(42);
+
+  mln::image2d<mln::rgb8> f(71, 43);
+  mln::generate(f, [&]() { return mln::rgb8{uint8_t(gen()), uint8_t(gen()), uint8_t(gen())}; });
+
+  auto ref = mln::contrib::meanshift(f, 5, 15);
+  auto res = mln::contrib::parallel::meanshift(f, 5, 15);
+  ASSERT_IMAGES_EQ_EXP(ref, res);
+}
+
+TEST(Contrib, meanshift_flat_image)
+{
+  mln::image2d<uint8_t> f(13, 7);
+  mln::fill(f, uint8_t(42));
+
+  auto res = mln::contrib::meanshift(f, 5, 15);
+  ASSERT_IMAGES_EQ_EXP(f, res);
+}
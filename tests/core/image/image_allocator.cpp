@@ -0,0 +1,120 @@
+#include <mln/core/image/image_allocator.hpp>
+
+#include <mln/bp/alloc.hpp>
+#include <mln/core/image/ndimage.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+
+TEST(Core, ImageAllocator_PooledReuse)
+{
+  mln::pooled_image_allocator pool;
+
+  void* a = pool.allocate(1000);
+  pool.deallocate(a, 1000);
+  void* b = pool.allocate(990); // Same size class
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % mln::image_allocator::alignment, 0u);
+  pool.deallocate(b, 990);
+
+  auto s = pool.stats();
+  EXPECT_EQ(s.hits, 1u);
+  EXPECT_EQ(s.misses, 1u);
+  EXPECT_GE(s.cached_bytes, 1000u);
+
+  pool.release();
+  EXPECT_EQ(pool.stats().cached_bytes, 0u);
+}
+
+TEST(Core, ImageAllocator_PooledEviction)
+{
+  mln::pooled_image_allocator pool(4096);
+
+  void* a = pool.allocate(3000);
+  void* b = pool.allocate(3000);
+  pool.deallocate(a, 3000);
+  pool.deallocate(b, 3000);
+
+  auto s = pool.stats();
+  EXPECT_EQ(s.evictions, 1u);
+  EXPECT_LE(s.cached_bytes, 4096u);
+}
+
+TEST(Core, ImageAllocator_ScopedImages)
+{
+  auto pool = std::make_shared<mln::pooled_image_allocator>();
+  {
+    mln::scoped_image_allocator guard(pool);
+    mln::image_build_params params;
+    params.init_value = 1;
+    for (int i = 0; i < 4; ++i)
+    {
+      mln::image2d<std::uint8_t> f(640, 480);
+      mln::image2d<int>          g(640, 480, params);
+      ASSERT_EQ(g({10, 10}), 1);
+    }
+  }
+  auto s = pool->stats();
+  EXPECT_EQ(s.misses, 2u);
+  EXPECT_EQ(s.hits, 6u);
+
+  // Out of the scope, the images use the global allocator but the pooled blocks are still released to the pool
+  auto before = pool->stats().cached_bytes;
+  {
+    mln::image2d<std::uint8_t> f(640, 480);
+  }
+  EXPECT_EQ(pool->stats().cached_bytes, before);
+  EXPECT_EQ(pool->stats().misses, 2u);
+}
+
+TEST(Core, ImageAllocator_Buffer2D)
+{
+  auto pool = std::make_shared<mln::pooled_image_allocator>();
+
+  std::ptrdiff_t pitch;
+  void*          buf;
+  {
+    mln::scoped_image_allocator guard(pool);
+    buf = mln::bp::aligned_alloc_2d<float>(100, 50, pitch);
+  }
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buf) % 32, 0u);
+  EXPECT_EQ(pool->stats().misses, 1u);
+
+  // Released to the pool even out of the scope
+  mln::bp::aligned_free_2d(buf);
+  EXPECT_GT(pool->stats().cached_bytes, 0u);
+}
+
+TEST(Core, ImageAllocator_GlobalSeenByAllThreads)
+{
+  auto pool = std::make_shared<mln::pooled_image_allocator>();
+
+  // The worker has cached the default allocator before the global one is replaced
+  std::atomic<int> step = 0;
+  std::thread      worker([&] {
+    mln::image2d<std::uint8_t> f(64, 64);
+    step = 1;
+    while (step != 2)
+      std::this_thread::yield();
+    for (int i = 0; i < 3; ++i)
+      mln::image2d<std::uint8_t> g(640, 480);
+  });
+
+  while (step != 1)
+    std::this_thread::yield();
+  mln::set_image_allocator(pool);
+  step = 2;
+  worker.join();
+
+  EXPECT_EQ(mln::get_image_allocator(), pool);
+  mln::set_image_allocator(nullptr);
+  EXPECT_NE(mln::get_image_allocator(), pool);
+
+  auto s = pool->stats();
+  EXPECT_EQ(s.misses, 1u);
+  EXPECT_EQ(s.hits, 2u);
+}
@@ -0,0 +1,178 @@
+#include <mln/core/trace.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+class Trace : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_recording = mln::trace::recording;
+    mln::trace::set_recording(true);
+    mln::trace::clear();
+  }
+
+  void TearDown() override
+  {
+    mln::trace::set_recording(m_recording);
+    mln::trace::clear();
+  }
+
+  static std::string dump()
+  {
+    std::ostringstream os;
+    mln::trace::dump(os);
+    return os.str();
+  }
+
+private:
+  bool m_recording;
+};
+
+
+TEST_F(Trace, scopes_are_recorded_as_complete_events)
+{
+  {
+    mln_entering("outer");
+    mln::trace::annotate("pixels", 42);
+    {
+      mln_entering("inner");
+    }
+  }
+
+  auto s = dump();
+  ASSERT_EQ(s.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+  auto inner = s.find("{\"name\":\"inner\",\"cat\":\"mln\"");
+  auto outer = s.find("{\"name\":\"outer\",\"cat\":\"mln\"");
+  ASSERT_NE(inner, std::string::npos);
+  ASSERT_NE(outer, std::string::npos);
+  EXPECT_LT(inner, outer); // Events are written in the order they end
+  EXPECT_NE(s.find("\"ph\":\"X\"", outer), std::string::npos);
+  EXPECT_NE(s.find("\"args\":{\"pixels\":42}", outer), std::string::npos);
+}
+
+TEST_F(Trace, annotations_attach_to_the_innermost_scope)
+{
+  {
+    mln_entering("outer");
+    {
+      mln_entering("inner");
+      mln::trace::annotate("tile", 3);
+    }
+    mln::trace::annotate("width", 7);
+  }
+
+  auto s     = dump();
+  auto inner = s.find("{\"name\":\"inner\"");
+  auto outer = s.find("{\"name\":\"outer\"");
+  ASSERT_NE(inner, std::string::npos);
+  ASSERT_NE(outer, std::string::npos);
+  EXPECT_EQ(s.find("\"args\":{\"tile\":3}", inner), s.find("\"args\":", inner));
+  EXPECT_NE(s.find("\"args\":{\"width\":7}", outer), std::string::npos);
+}
+
+TEST_F(Trace, threads_are_recorded_separately)
+{
+  {
+    mln_entering("main");
+  }
+  std::thread t([] { mln_entering("worker"); });
+  t.join();
+
+  auto s      = dump();
+  auto worker = s.find("{\"name\":\"worker\"");
+  auto main   = s.find("{\"name\":\"main\"");
+  ASSERT_NE(worker, std::string::npos);
+  ASSERT_NE(main, std::string::npos);
+
+  auto tid = [&](std::size_t pos) {
+    auto b = s.find("\"tid\":", pos) + 6;
+    return s.substr(b, s.find(',', b) - b);
+  };
+  EXPECT_NE(tid(worker), tid(main));
+}
+
+TEST_F(Trace, buffers_keep_the_last_events)
+{
+  // A fresh thread (or the buffer of an exited one, emptied by clear) holds exactly the events pushed here
+  constexpr int n = static_cast<int>(mln::trace::kBufferCapacity) + 1000;
+  std::thread   t([] {
+    for (int i = 0; i < n; ++i)
+    {
+      mln_entering("wrap");
+      mln::trace::annotate("i", i);
+    }
+  });
+  t.join();
+
+  const std::string event = "{\"name\":\"wrap\"";
+  const std::string arg   = "\"args\":{\"i\":";
+
+  auto s     = dump();
+  int  count = 0;
+  int  next  = n - static_cast<int>(mln::trace::kBufferCapacity);
+  for (auto pos = s.find(event); pos != std::string::npos; pos = s.find(event, pos + 1))
+  {
+    auto b = s.find(arg, pos) + arg.size();
+    ASSERT_EQ(std::stoi(s.substr(b, s.find('}', b) - b)), next++) << "event " << count;
+    ++count;
+  }
+  EXPECT_EQ(count, static_cast<int>(mln::trace::kBufferCapacity));
+  EXPECT_EQ(next, n);
+}
+
+TEST_F(Trace, buffers_of_exited_threads_are_reused)
+{
+  auto nthreads = [] {
+    auto        s     = dump();
+    int         count = 0;
+    std::size_t pos   = 0;
+    while ((pos = s.find("\"thread_name\"", pos + 1)) != std::string::npos)
+      ++count;
+    return count;
+  };
+
+  {
+    std::thread t([] { mln_entering("first"); });
+    t.join();
+  }
+  const int n = nthreads();
+  for (int k = 0; k < 8; ++k)
+  {
+    std::thread t([] { mln_entering("next"); });
+    t.join();
+  }
+  EXPECT_EQ(nthreads(), n);
+
+  // The events of the exited threads are kept
+  auto s = dump();
+  EXPECT_NE(s.find("{\"name\":\"first\""), std::string::npos);
+  EXPECT_NE(s.find("{\"name\":\"next\""), std::string::npos);
+}
+
+TEST_F(Trace, names_are_escaped)
+{
+  {
+    mln_entering("a \"quoted\" name");
+  }
+  mln::trace::warn("back\\slash");
+
+  auto s = dump();
+  EXPECT_NE(s.find("\"name\":\"a \\\"quoted\\\" name\""), std::string::npos);
+  EXPECT_NE(s.find("\"name\":\"back\\\\slash\",\"cat\":\"mln\""), std::string::npos);
+}
+
+TEST_F(Trace, nothing_is_recorded_when_disabled)
+{
+  mln::trace::set_recording(false);
+  {
+    mln_entering("disabled");
+    mln::trace::annotate("pixels", 1);
+  }
+  EXPECT_EQ(dump().find("disabled"), std::string::npos);
+}
@@ -6,7 +6,12 @@
 
 #include <gtest/gtest.h>
 
+#include <fitsio.h>
+
 #include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <vector>
 
 static const auto filename = fixtures::ImagePath::concat_with_filename("test.fit");
 
@@ -161,4 +166,111 @@ TEST(IO, cfitsio_read_to_argument)
   ASSERT_EQ(img.height(), 5);
 
   ASSERT_IMAGES_EQ_EXP(img, ref);
-}
\ No newline at end of file
+}
+TEST(IO, cfitsio_2D_roi)
+{
+  const mln::box2d roi(1, 2, 3, 2);
+
+  auto img = mln::io::fits::imread(filename, roi, 5);
+  ASSERT_EQ(img.sample_type(), mln::sample_type_id::FLOAT);
+  ASSERT_EQ(img.pdim(), 2);
+
+  auto* casted = img.cast_to<float, 2>();
+  ASSERT_EQ(casted->domain(), roi);
+  mln_foreach (auto p, roi)
+    ASSERT_EQ(casted->operator()(p), static_cast<float>(p.x() + 5 * p.y()));
+
+  ASSERT_THROW(mln::io::fits::imread(filename, mln::box2d(3, 3, 3, 3), 5), std::runtime_error);
+}
+
+TEST(IO, cfitsio_3D_roi)
+{
+  auto full = mln::io::fits::imread(filename, 7);
+  auto ref  = full.cast_to<std::uint8_t, 3>();
+
+  const mln::box3d roi(1, 1, 0, 3, 2, ref->domain().depth());
+
+  auto img    = mln::io::fits::imread(filename, roi, 7);
+  auto casted = img.cast_to<std::uint8_t, 3>();
+  ASSERT_EQ(casted->domain(), roi);
+  mln_foreach (auto p, roi)
+    ASSERT_EQ(casted->operator()(p), ref->operator()(p));
+}
+
+TEST(IO, cfitsio_strip_reader)
+{
+  auto full = mln::io::fits::imread(filename, 7);
+  auto ref  = full.cast_to<std::uint8_t, 3>();
+
+  mln::io::fits::strip_reader reader(filename, 2, 7);
+  ASSERT_EQ(reader.domain().dim(), 3);
+  ASSERT_EQ(reader.domain().size(), ref->domain().size());
+
+  mln::ndbuffer_image strip;
+  int                 z = 0;
+  while (reader.next(strip))
+  {
+    auto casted = strip.cast_to<std::uint8_t, 3>();
+    ASSERT_NE(casted, nullptr);
+    ASSERT_EQ(casted->domain().tl().z(), z);
+    mln_foreach (auto p, casted->domain())
+      ASSERT_EQ(casted->operator()(p), ref->operator()(p));
+    z = casted->domain().br().z();
+  }
+  ASSERT_EQ(z, ref->domain().depth());
+}
+
+namespace
+{
+  // Write a RICE tile-compressed image of size w×h with the values x + w * y, tiles of \p tile_rows rows
+  void write_tiled_image(const std::string& path, int w, int h, int tile_rows)
+  {
+    int       status = 0;
+    fitsfile* file;
+    fits_create_file(&file, ("!" + path).c_str(), &status); // '!' overwrites an existing file
+
+    long tile[2] = {w, tile_rows};
+    fits_set_compression_type(file, RICE_1, &status);
+    fits_set_tile_dim(file, 2, tile, &status);
+
+    long naxes[2] = {w, h};
+    fits_create_img(file, SHORT_IMG, 2, naxes, &status);
+
+    std::vector<short> data(static_cast<std::size_t>(w) * h);
+    std::iota(data.begin(), data.end(), short(0));
+    fits_write_img(file, TSHORT, 1, static_cast<LONGLONG>(data.size()), data.data(), &status);
+    fits_close_file(file, &status);
+    ASSERT_EQ(status, 0);
+  }
+} // namespace
+
+TEST(IO, cfitsio_tile_compressed_roi)
+{
+  constexpr int w = 13, h = 40, tile_rows = 7;
+
+  const std::string path = (std::filesystem::temp_directory_path() / "pylene_cfitsio_tiled.fit").string();
+  write_tiled_image(path, w, h, tile_rows);
+
+  // The regions do not start on a tile boundary and span several tiles
+  const mln::box2d rois[] = {
+      mln::box2d{3, 5, 9, 20}, // Starts in the middle of the first tile
+      mln::box2d{0, 8, w, 6},  // Inside a single tile (rows 8-13)
+      mln::box2d{2, 7, 4, 33}, // Starts on a tile, ends at the last row
+      mln::box2d{1, 39, 5, 1}, // The last row only
+      mln::box2d{0, 0, w, h},  // The whole image
+  };
+
+  for (const auto& roi : rois)
+  {
+    auto img = mln::io::fits::imread(path, roi, 1);
+    ASSERT_EQ(img.sample_type(), mln::sample_type_id::INT16);
+
+    auto* casted = img.cast_to<std::int16_t, 2>();
+    ASSERT_NE(casted, nullptr);
+    ASSERT_EQ(casted->domain(), roi);
+    mln_foreach (auto p, roi)
+      ASSERT_EQ(casted->operator()(p), p.x() + w * p.y());
+  }
+
+  std::filesystem::remove(path);
+}
@@ -1,5 +1,7 @@
+#include <mln/io/async_saver.hpp>
 #include <mln/io/imread.hpp>
 #include <mln/io/imsave.hpp>
+#include <mln/io/private/pnm_plugin.hpp>
 
 
 #include <mln/core/algorithm/iota.hpp>
@@ -13,6 +15,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+
 TEST(IO, FreeImage_pgm)
 {
   mln::image2d<uint8_t> ima;
@@ -139,3 +147,178 @@ TEST(IO, FreeImage_slow_pbm)
   ASSERT_IMAGES_EQ_EXP2(ima, not ref, fixtures::ImageCompare::COMPARE_DOMAIN);
 }
 
+
+TEST(IO, PNM_direct_read)
+{
+  // 16-bit graymap (big-endian samples)
+  {
+    std::FILE* f = std::fopen("test16.pgm", "wb");
+    std::fputs("P5\n# comment\n3 2\n65535\n", f);
+    const unsigned char raster[] = {0x00, 0x01, 0x01, 0x00, 0xFF, 0xFF, 0x12, 0x34, 0x00, 0x00, 0x80, 0x00};
+    std::fwrite(raster, 1, sizeof(raster), f);
+    std::fclose(f);
+
+    const mln::image2d<uint16_t> ref = {{1, 256, 65535}, {0x1234, 0, 0x8000}};
+    mln::image2d<uint16_t>       ima;
+    mln::io::imread("test16.pgm", ima);
+    ASSERT_IMAGES_EQ_EXP2(ima, ref, fixtures::ImageCompare::COMPARE_DOMAIN);
+  }
+
+  // Bitmap (1 is black, the lines are padded to a byte)
+  {
+    std::FILE* f = std::fopen("test.pbm", "wb");
+    std::fputs("P4\n10 2\n", f);
+    const unsigned char raster[] = {0b10101010, 0b01000000, 0b00000000, 0b11000000};
+    std::fwrite(raster, 1, sizeof(raster), f);
+    std::fclose(f);
+
+    const mln::image2d<bool> ref = {{0, 1, 0, 1, 0, 1, 0, 1, 1, 0}, {1, 1, 1, 1, 1, 1, 1, 1, 0, 0}};
+    mln::image2d<bool>       ima;
+    mln::io::imread("test.pbm", ima);
+    ASSERT_IMAGES_EQ_EXP2(ima, ref, fixtures::ImageCompare::COMPARE_DOMAIN);
+  }
+}
+
+TEST(IO, PNM_non_standard_maxval)
+{
+  // Only the full-range files are read directly, the others are rescaled by FreeImage
+  {
+    std::FILE* f = std::fopen("test15.pgm", "wb");
+    std::fputs("P5\n16 1\n15\n", f);
+    for (int v = 0; v < 16; ++v)
+      std::fputc(v, f);
+    std::fclose(f);
+
+    ASSERT_FALSE(mln::io::internal::pnm_reader_plugin::can_read("test15.pgm"));
+    mln::image2d<uint8_t> ima;
+    mln::io::imread("test15.pgm", ima);
+    ASSERT_EQ(ima.width(), 16);
+    EXPECT_EQ(ima({0, 0}), 0);
+    EXPECT_EQ(ima({15, 0}), 255);
+    for (int x = 1; x < 16; ++x)
+      EXPECT_LT(ima({x - 1, 0}), ima({x, 0}));
+  }
+
+  {
+    std::FILE* f = std::fopen("test100.ppm", "wb");
+    std::fputs("P6\n2 1\n100\n", f);
+    const unsigned char raster[] = {0, 50, 100, 100, 0, 0};
+    std::fwrite(raster, 1, sizeof(raster), f);
+    std::fclose(f);
+
+    ASSERT_FALSE(mln::io::internal::pnm_reader_plugin::can_read("test100.ppm"));
+    mln::image2d<mln::rgb8> ima;
+    mln::io::imread("test100.ppm", ima);
+    EXPECT_EQ(ima({0, 0})[0], 0);
+    EXPECT_GT(ima({0, 0})[1], 100);
+    EXPECT_EQ(ima({0, 0})[2], 255);
+    EXPECT_EQ(ima({1, 0})[0], 255);
+  }
+
+  // 16-bit graymap with a maxval below 65535
+  {
+    std::FILE* f = std::fopen("test1000.pgm", "wb");
+    std::fputs("P5\n1 1\n1000\n", f);
+    std::fputc(0x03, f);
+    std::fputc(0xE8, f);
+    std::fclose(f);
+    EXPECT_FALSE(mln::io::internal::pnm_reader_plugin::can_read("test1000.pgm"));
+  }
+
+  // The full-range files are read directly
+  {
+    std::FILE* f = std::fopen("test255.pgm", "wb");
+    std::fputs("P5\n1 1\n255\n", f);
+    std::fputc(7, f);
+    std::fclose(f);
+    EXPECT_TRUE(mln::io::internal::pnm_reader_plugin::can_read("test255.pgm"));
+  }
+}
+
+TEST(IO, imread_reuses_output_buffer)
+{
+  mln::image2d<uint8_t> ima;
+  mln::io::imread(fixtures::ImagePath::concat_with_filename("fly.pgm"), ima);
+  auto* buffer = ima.buffer();
+
+  // Same layout: the storage is reused
+  mln::io::imread(fixtures::ImagePath::concat_with_filename("fly.pgm"), ima);
+  ASSERT_EQ(buffer, ima.buffer());
+
+  // The storage is shared with another image: a new buffer is allocated
+  auto copy = ima;
+  mln::io::imread(fixtures::ImagePath::concat_with_filename("fly.pgm"), ima);
+  ASSERT_NE(buffer, ima.buffer());
+  ASSERT_EQ(buffer, copy.buffer());
+}
+
+TEST(IO, imread_batch)
+{
+  // Files of different types and sizes so that the recycled buffers do not always match
+  std::vector<std::string> paths;
+  for (int i = 0; i < 6; ++i)
+  {
+    paths.push_back(fixtures::ImagePath::concat_with_filename("fly.pgm"));
+    paths.push_back(fixtures::ImagePath::concat_with_filename("iota2d.ppm"));
+    paths.push_back("test16.pgm");
+  }
+
+  {
+    std::FILE* f = std::fopen("test16.pgm", "wb");
+    std::fputs("P5\n3 2\n65535\n", f);
+    const unsigned char raster[] = {0x00, 0x01, 0x01, 0x00, 0xFF, 0xFF, 0x12, 0x34, 0x00, 0x00, 0x80, 0x00};
+    std::fwrite(raster, 1, sizeof(raster), f);
+    std::fclose(f);
+  }
+
+  std::vector<mln::ndbuffer_image> refs;
+  for (const auto& p : paths)
+    refs.push_back(mln::io::imread(p));
+
+  std::size_t expected = 0;
+  mln::io::imread_batch(
+      paths,
+      [&](std::size_t i, mln::ndbuffer_image& ima) {
+        ASSERT_EQ(expected++, i);
+        ASSERT_EQ(refs[i].sample_type(), ima.sample_type());
+        ASSERT_EQ(refs[i].width(), ima.width());
+        ASSERT_EQ(refs[i].height(), ima.height());
+
+        const auto n = ima.width() * mln::get_sample_type_id_traits(ima.sample_type()).size();
+        for (int y = 0; y < ima.height(); ++y)
+        {
+          const std::byte* a = refs[i].buffer() + y * refs[i].byte_stride(1);
+          const std::byte* b = ima.buffer() + y * ima.byte_stride(1);
+          ASSERT_EQ(0, std::memcmp(a, b, n));
+        }
+      },
+      2);
+  ASSERT_EQ(paths.size(), expected);
+}
+
+TEST(IO, async_saver)
+{
+  mln::image2d<uint8_t> ref(17, 13);
+  mln::iota(ref, 0);
+
+  std::vector<std::future<void>> futures;
+  {
+    // The limit allows only one image at a time in the queue
+    mln::io::async_saver saver(ref.width() * ref.height(), 2);
+    for (int i = 0; i < 4; ++i)
+      futures.push_back(saver.save(ref, "test_async_" + std::to_string(i) + ".tiff"));
+    futures.push_back(saver.save(ref, "test_async.unknown_extension"));
+    saver.wait();
+    ASSERT_EQ(saver.queued_bytes(), 0u);
+  }
+
+  for (int i = 0; i < 4; ++i)
+  {
+    futures[i].get();
+
+    mln::image2d<uint8_t> ima;
+    mln::io::imread("test_async_" + std::to_string(i) + ".tiff", ima);
+    ASSERT_IMAGES_EQ_EXP2(ima, ref, fixtures::ImageCompare::COMPARE_DOMAIN);
+  }
+  ASSERT_THROW(futures[4].get(), std::runtime_error);
+}
@@ -1,5 +1,6 @@
 #include <mln/labeling/blobs.hpp>
 
+#include <mln/core/algorithm/generate.hpp>
 #include <mln/core/algorithm/iota.hpp>
 #include <mln/core/algorithm/transform.hpp>
 #include <mln/core/image/ndimage.hpp>
@@ -12,6 +13,8 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 TEST(Labeling, blobs_U)
 {
   using namespace mln::view::ops;
@@ -72,3 +75,110 @@ TEST(Labeling, blobs_custom)
     ASSERT_EQ(nlabel, 1u);
   }
 }
+
+
+// The run-based implementation (image2d<bool>) must give the same labels as the queue-based one (views)
+TEST(Labeling, blobs_runs_same_as_queue)
+{
+  using namespace mln::view::ops;
+
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 255);
+
+  mln::image2d<uint8_t> ima(317, 411);
+  mln::generate(ima, [&]() { return static_cast<uint8_t>(dist(gen)); });
+
+  auto bin = mln::transform(ima, [](uint8_t x) -> bool { return x > 128; });
+
+  int nref, nlabel;
+  {
+    auto ref = mln::labeling::blobs<int32_t>(ima > 128, mln::c4, nref);
+    auto out = mln::labeling::blobs<int32_t>(bin, mln::c4, nlabel);
+    ASSERT_EQ(nref, nlabel);
+    ASSERT_IMAGES_EQ_EXP(ref, out);
+
+    out = mln::labeling::parallel::blobs<int32_t>(bin, mln::c4, nlabel);
+    ASSERT_EQ(nref, nlabel);
+    ASSERT_IMAGES_EQ_EXP(ref, out);
+  }
+  {
+    auto ref = mln::labeling::blobs<int32_t>(ima > 128, mln::c8, nref);
+    auto out = mln::labeling::blobs<int32_t>(bin, mln::c8, nlabel);
+    ASSERT_EQ(nref, nlabel);
+    ASSERT_IMAGES_EQ_EXP(ref, out);
+
+    out = mln::labeling::parallel::blobs<int32_t>(bin, mln::c8, nlabel);
+    ASSERT_EQ(nref, nlabel);
+    ASSERT_IMAGES_EQ_EXP(ref, out);
+  }
+}
+
+TEST(Labeling, blobs_attributes)
+{
+  mln::image2d<bool> ima = {{0, 1, 0, 0, 0, 1, 0}, //
+                            {0, 1, 0, 1, 0, 1, 0}, //
+                            {0, 1, 0, 0, 0, 1, 0}, //
+                            {0, 1, 1, 1, 1, 1, 0}, //
+                            {0, 1, 1, 1, 1, 1, 0}};
+
+  int                                         nlabel;
+  std::vector<mln::labeling::blob_attributes> attrs;
+  mln::labeling::parallel::blobs<uint8_t>(ima, mln::c4, nlabel, attrs);
+
+  ASSERT_EQ(nlabel, 2);
+  ASSERT_EQ(attrs.size(), 3u);
+  EXPECT_EQ(attrs[1].area, 16u);
+  EXPECT_EQ(attrs[1].bbox, mln::box2d(1, 0, 5, 5));
+  EXPECT_FLOAT_EQ(attrs[1].centroid_x, 3.f);
+  EXPECT_FLOAT_EQ(attrs[1].centroid_y, 2.5625f);
+  EXPECT_EQ(attrs[2].area, 1u);
+  EXPECT_EQ(attrs[2].bbox, mln::box2d(3, 1, 1, 1));
+  EXPECT_FLOAT_EQ(attrs[2].centroid_x, 3.f);
+  EXPECT_FLOAT_EQ(attrs[2].centroid_y, 1.f);
+}
+
+// The run-based implementation must express the attributes in the coordinates of the domain, as the generic one
+TEST(Labeling, blobs_attributes_non_origin_domain)
+{
+  using namespace mln::view::ops;
+
+  std::mt19937                       gen(7);
+  std::uniform_int_distribution<int> dist(0, 255);
+
+  mln::image2d<uint8_t> ima(mln::box2d{-13, 21, 157, 203});
+  mln::generate(ima, [&]() { return static_cast<uint8_t>(dist(gen)); });
+
+  auto check = [](auto input, auto bin) {
+    int                                         nref, nlabel;
+    std::vector<mln::labeling::blob_attributes> ref, attrs;
+    mln::labeling::blobs<int32_t>(input > 128, mln::c8, nref, ref);
+
+    for (bool parallel : {false, true})
+    {
+      if (parallel)
+        mln::labeling::parallel::blobs<int32_t>(bin, mln::c8, nlabel, attrs);
+      else
+        mln::labeling::blobs<int32_t>(bin, mln::c8, nlabel, attrs);
+
+      ASSERT_EQ(nref, nlabel);
+      ASSERT_EQ(ref.size(), attrs.size());
+      for (std::size_t i = 1; i < ref.size(); ++i)
+      {
+        EXPECT_EQ(ref[i].area, attrs[i].area) << "label " << i;
+        EXPECT_EQ(ref[i].bbox, attrs[i].bbox) << "label " << i;
+        EXPECT_FLOAT_EQ(ref[i].centroid_x, attrs[i].centroid_x) << "label " << i;
+        EXPECT_FLOAT_EQ(ref[i].centroid_y, attrs[i].centroid_y) << "label " << i;
+      }
+    }
+  };
+
+  auto bin = mln::transform(ima, [](uint8_t x) -> bool { return x > 128; });
+  ASSERT_EQ(bin.domain(), ima.domain());
+
+  // Image built from a box
+  check(ima, bin);
+
+  // Clipped image
+  const mln::box2d roi = {10, 40, 100, 120};
+  check(ima.clip(roi), bin.clip(roi));
+}
@@ -2,9 +2,12 @@
 
 
 
+#include <mln/core/algorithm/generate.hpp>
+#include <mln/core/algorithm/transform.hpp>
 #include <mln/core/image/ndimage.hpp>
 
 #include <mln/core/neighborhood/c4.hpp>
+#include <mln/core/neighborhood/c8.hpp>
 #include <mln/core/se/mask2d.hpp>
 
 
@@ -12,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+
 TEST(Transform, chamfer_distance_transform_chamfer_distance_transform_1)
 {
   mln::image2d<bool> f = {
@@ -245,3 +250,39 @@ TEST(Transform, chamfer_distance_transform_bg_is_one_weighted_distance_transform
 
   ASSERT_IMAGES_EQ_EXP(res, ref);
 }
+
+// The 2D fast path (bool input) and the parallel version against the generic implementation (float input)
+TEST(Transform, chamfer_distance_transform_2d_same_as_generic)
+{
+  std::mt19937                gen(42);
+  std::bernoulli_distribution dist(0.97);
+
+  mln::image2d<bool> f(701, 123);
+  mln::generate(f, [&]() { return dist(gen); });
+  auto g = mln::transform(f, [](bool x) -> float { return x; });
+
+  constexpr int    a = 5, b = 7, c = 11;
+  mln::se::wmask2d w5x5 = {{0, c, 0, c, 0}, //
+                           {c, b, a, b, c},
+                           {0, a, 0, a, 0},
+                           {c, b, a, b, c},
+                           {0, c, 0, c, 0}};
+
+  for (bool bg : {false, true})
+  {
+    {
+      auto ref = mln::labeling::chamfer_distance_transform<int16_t>(g, mln::c8, bg);
+      auto res = mln::labeling::chamfer_distance_transform<int16_t>(f, mln::c8, bg);
+      auto par = mln::labeling::parallel::chamfer_distance_transform<int16_t>(f, mln::c8, bg);
+      ASSERT_IMAGES_EQ_EXP(res, ref);
+      ASSERT_IMAGES_EQ_EXP(par, ref);
+    }
+    {
+      auto ref = mln::labeling::chamfer_distance_transform(g, w5x5, bg);
+      auto res = mln::labeling::chamfer_distance_transform(f, w5x5, bg);
+      auto par = mln::labeling::parallel::chamfer_distance_transform(f, w5x5, bg);
+      ASSERT_IMAGES_EQ_EXP(res, ref);
+      ASSERT_IMAGES_EQ_EXP(par, ref);
+    }
+  }
+}
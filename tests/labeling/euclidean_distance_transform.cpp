@@ -0,0 +1,147 @@
+#include <mln/labeling/euclidean_distance_transform.hpp>
+
+#include <mln/core/algorithm/generate.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/range/foreach.hpp>
+
+#include <fixtures/ImageCompare/image_compare.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+
+
+namespace
+{
+  // Brute force squared distance to the closest background point
+  template <int D>
+  float brute_force_sedt(const mln::__ndbuffer_image<bool, D>& f, mln::ndpoint<D> p, std::span<const float> spacing)
+  {
+    float best = std::numeric_limits<float>::infinity();
+    mln_foreach (auto px, f.pixels())
+    {
+      if (px.val())
+        continue;
+
+      float d = 0;
+      for (int k = 0; k < D; ++k)
+      {
+        float dx = (px.point()[k] - p[k]) * (spacing.empty() ? 1.f : spacing[k]);
+        d += dx * dx;
+      }
+      best = std::min(best, d);
+    }
+    return best;
+  }
+
+  template <int D>
+  void check_edt(const mln::__ndbuffer_image<bool, D>& f, std::span<const float> spacing, bool parallel)
+  {
+    mln::__ndbuffer_image<float, D> dist;
+
+    auto feat = parallel ? mln::labeling::parallel::euclidean_feature_transform(f, spacing, &dist)
+                         : mln::labeling::euclidean_feature_transform(f, spacing, &dist);
+    auto sedt = parallel ? mln::labeling::parallel::squared_euclidean_distance_transform(f, spacing)
+                         : mln::labeling::squared_euclidean_distance_transform(f, spacing);
+
+    ASSERT_IMAGES_EQ_EXP(dist, sedt);
+
+    mln_foreach (auto p, f.domain())
+    {
+      float ref = brute_force_sedt(f, p, spacing);
+      ASSERT_NEAR(ref, dist(p), 1e-3f * std::max(1.f, ref));
+
+      // The feature is a background point at the same distance
+      auto q = feat(p);
+      ASSERT_TRUE(f.domain().has(q));
+      ASSERT_FALSE(f(q));
+
+      float d = 0;
+      for (int k = 0; k < D; ++k)
+      {
+        float dx = (q[k] - p[k]) * (spacing.empty() ? 1.f : spacing[k]);
+        d += dx * dx;
+      }
+      ASSERT_NEAR(ref, d, 1e-3f * std::max(1.f, ref));
+    }
+  }
+} // namespace
+
+
+TEST(Labeling, edt_2d)
+{
+  mln::image2d<bool> f = {
+      {1, 1, 1, 1, 1, 1}, //
+      {1, 1, 1, 1, 1, 1}, //
+      {1, 1, 0, 1, 1, 1}, //
+      {1, 1, 1, 1, 1, 1}, //
+      {1, 1, 1, 1, 1, 0}  //
+  };
+
+  mln::image2d<float> ref = {
+      {8, 5, 4, 5, 8, 13}, //
+      {5, 2, 1, 2, 5, 9},  //
+      {4, 1, 0, 1, 4, 4},  //
+      {5, 2, 1, 2, 2, 1},  //
+      {8, 5, 4, 4, 1, 0}   //
+  };
+
+  auto res = mln::labeling::squared_euclidean_distance_transform(f);
+  ASSERT_IMAGES_EQ_EXP(ref, res);
+
+  auto feat = mln::labeling::euclidean_feature_transform(f);
+  ASSERT_EQ(feat({0, 0}), (mln::point2d{2, 2}));
+  ASSERT_EQ(feat({5, 0}), (mln::point2d{2, 2}));
+  ASSERT_EQ(feat({5, 3}), (mln::point2d{5, 4}));
+  ASSERT_EQ(feat({5, 4}), (mln::point2d{5, 4}));
+}
+
+TEST(Labeling, edt_no_background)
+{
+  mln::image2d<bool> f = {{1, 1, 1}, {1, 1, 1}};
+
+  auto res = mln::labeling::squared_euclidean_distance_transform(f);
+  mln_foreach (auto v, res.values())
+    ASSERT_TRUE(std::isinf(v));
+}
+
+TEST(Labeling, edt_random_2d)
+{
+  std::mt19937                gen(42);
+  std::bernoulli_distribution dist(0.95);
+
+  mln::image2d<bool> f(37, 29);
+  mln::generate(f, [&]() { return dist(gen); });
+
+  std::array<float, 2> spacing = {1.f, 2.5f};
+
+  check_edt<2>(f, {}, false);
+  check_edt<2>(f, {}, true);
+  check_edt<2>(f, spacing, false);
+  check_edt<2>(f, spacing, true);
+}
+
+TEST(Labeling, edt_random_3d)
+{
+  std::mt19937                gen(42);
+  std::bernoulli_distribution dist(0.98);
+
+  mln::image3d<bool> f(13, 11, 9);
+  mln::generate(f, [&]() { return dist(gen); });
+
+  std::array<float, 3> spacing = {0.5f, 0.5f, 2.f};
+
+  check_edt<3>(f, {}, false);
+  check_edt<3>(f, spacing, true);
+}
+
+TEST(Labeling, edt_bad_spacing)
+{
+  mln::image2d<bool>   f       = {{1, 0, 1}};
+  std::array<float, 3> spacing = {1.f, 1.f, 1.f};
+
+  EXPECT_THROW(mln::labeling::squared_euclidean_distance_transform(f, spacing), std::runtime_error);
+}
@@ -1,3 +1,4 @@
+#include <mln/morpho/private/bitset_tree.hpp>
 #include <mln/morpho/private/immersion.hpp>
 #include <mln/morpho/private/propagation.hpp>
 #include <mln/morpho/tos.hpp>
@@ -8,6 +9,9 @@
 #include <mln/core/image/view/cast.hpp>
 #include <mln/core/algorithm/accumulate.hpp>
 #include <mln/accu/accumulators/max.hpp>
+#include <mln/core/algorithm/generate.hpp>
+#include <mln/core/algorithm/transform.hpp>
+#include <mln/core/range/foreach.hpp>
 
 
 #include <fixtures/ImageCompare/image_compare.hpp>
@@ -15,6 +19,11 @@
 
 #include "tos_tests_helper.hpp"
 
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
 
 TEST(ToSImmersion, twodimensional)
 {
@@ -96,6 +105,42 @@ TEST(ToSImmersion, threedimensional)
   ASSERT_IMAGES_EQ_EXP(ref_sup, sup);
 }
 
+template <class I>
+void check_interval_immersion(I f)
+{
+  auto [inf, sup] = mln::morpho::details::immersion(f);
+  auto F          = mln::morpho::details::interval_immersion(f);
+
+  ASSERT_EQ(inf.domain(), F.domain());
+  auto finf = mln::transform(F, [](auto v) { return v.inf; });
+  auto fsup = mln::transform(F, [](auto v) { return v.sup; });
+  ASSERT_IMAGES_EQ_EXP(inf, finf);
+  ASSERT_IMAGES_EQ_EXP(sup, fsup);
+}
+
+TEST(ToSImmersion, interval_immersion_same_as_immersion)
+{
+  using namespace mln::view::ops;
+
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 65535);
+
+  mln::image2d<uint8_t>  f8(77, 13);
+  mln::image2d<uint16_t> f16(77, 13);
+  mln::image2d<float>    ff(77, 13);
+  mln::image3d<uint8_t>  f3(37, 5, 4);
+  mln::generate(f8, [&]() { return static_cast<uint8_t>(dist(gen)); });
+  mln::generate(f16, [&]() { return static_cast<uint16_t>(dist(gen)); });
+  mln::generate(ff, [&]() { return 0.5f * dist(gen); });
+  mln::generate(f3, [&]() { return static_cast<uint8_t>(dist(gen)); });
+
+  check_interval_immersion(f8);
+  check_interval_immersion(f16);
+  check_interval_immersion(ff);
+  check_interval_immersion(f3);
+  check_interval_immersion(f8 * uint8_t(1));
+}
+
 
 template <class I, class J>
 void test_propagation(I f, J& ref)
@@ -120,7 +165,7 @@ class ToSPropagation : public ::testing::Test
 {
 };
 
-typedef ::testing::Types<uint8_t> TestValueTypes;
+typedef ::testing::Types<uint8_t, uint32_t, float> TestValueTypes;
 TYPED_TEST_SUITE(ToSPropagation, TestValueTypes);
 
 TYPED_TEST(ToSPropagation, saddle_point)
@@ -381,3 +426,192 @@ TEST(ToSConstruction, branches_with_parallel_flooding_3d)
   auto [tree, node_map ] = mln::morpho::tos(ima, {0,0,0});
   compare_tree_to_ref(tree, node_map, ref_parent, ref_roots);
 }
+
+TEST(ToSConstruction, float_same_as_uint8)
+{
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 15);
+
+  mln::image2d<uint8_t> f(17, 13);
+  mln::generate(f, [&]() { return static_cast<uint8_t>(dist(gen)); });
+  auto g = mln::transform(f, [](uint8_t x) { return 0.5f * x - 3.f; });
+
+  auto [t1, node_map1] = mln::morpho::tos(f, {0, 0});
+  auto [t2, node_map2] = mln::morpho::tos(g, {0, 0});
+
+  ASSERT_IMAGES_EQ_EXP(node_map2, node_map1);
+  ASSERT_EQ(t1.parent, t2.parent);
+  for (std::size_t i = 0; i < t1.values.size(); ++i)
+    ASSERT_EQ(0.5f * t1.values[i] - 3.f, t2.values[i]);
+}
+
+TEST(ToSConstruction, deeper_than_16_bits)
+{
+  // A ramp with more than 2¹⁶ distinct values: a chain of nested shapes
+  constexpr int n = 70000;
+
+  mln::image2d<float> f(n, 1);
+  mln_foreach (auto px, f.pixels())
+    px.val() = 0.5f * px.point().x();
+
+  auto [t, node_map] = mln::morpho::tos(f, {0, 0});
+
+  ASSERT_EQ(static_cast<int>(t.parent.size()), n);
+  for (int x = 0; x < n; ++x)
+  {
+    int id = node_map({2 * x, 0});
+    ASSERT_EQ(f({x, 0}), t.values[id]);
+    if (x > 0)
+      ASSERT_EQ(f({x - 1, 0}), t.values[t.parent[id]]);
+    else
+      ASSERT_EQ(-1, t.parent[id]);
+  }
+}
+
+TEST(ToSBucketQueue, bitset_tree_same_as_set)
+{
+  constexpr int n = 300000;
+
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, n - 1);
+
+  mln::morpho::details::bitset_tree t(n);
+  std::set<int>                     ref;
+  for (int k = 0; k < 100000; ++k)
+  {
+    int i = dist(gen);
+    if (k % 3 == 2)
+    {
+      t.erase(i);
+      ref.erase(i);
+    }
+    else
+    {
+      t.insert(i);
+      ref.insert(i);
+    }
+
+    int  j    = dist(gen);
+    auto up   = ref.lower_bound(j);
+    auto down = ref.upper_bound(j);
+    ASSERT_EQ(ref.count(j) > 0, t.contains(j));
+    ASSERT_EQ(up == ref.end() ? -1 : *up, t.next(j));
+    ASSERT_EQ(down == ref.begin() ? -1 : *std::prev(down), t.prev(j));
+  }
+}
+
+TEST(ToSBucketQueue, propagation_same_as_ordered)
+{
+  using mln::morpho::details::pset_kind;
+
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 99999);
+
+  mln::image2d<uint32_t> f(157, 93);
+  mln::generate(f, [&]() { return static_cast<uint32_t>(dist(gen)); });
+
+  auto F = mln::morpho::details::interval_immersion(f);
+
+  int               d1, d2;
+  mln::image2d<int> ord1 = mln::imchvalue<int>(F).adjust(mln::c4);
+  mln::image2d<int> ord2 = mln::imchvalue<int>(F).adjust(mln::c4);
+  auto lvl1 = mln::morpho::details::propagation<decltype(F), pset_kind::ordered>(F, ord1, {0, 0}, d1);
+  auto lvl2 = mln::morpho::details::propagation<decltype(F), pset_kind::bucket>(F, ord2, {0, 0}, d2);
+
+  ASSERT_EQ(d1, d2);
+  ASSERT_EQ(lvl1, lvl2);
+  ASSERT_IMAGES_EQ_EXP(ord2, ord1);
+}
+
+TEST(ToSBucketQueue, propagation_by_rank_same_as_ordered)
+{
+  // More than 2¹⁶ distinct values: the propagation on the 32-bit ranks with the bucket queue must match the one on the
+  // values with the comparison-based point set
+  using mln::morpho::details::pset_kind;
+
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 9999999);
+
+  mln::image2d<float> f(400, 300);
+  mln::generate(f, [&]() { return 0.25f * dist(gen); });
+
+  int               d1, d2;
+  mln::image2d<int> ord1, ord2;
+  auto lvl1 = mln::morpho::details::immersion_propagation<pset_kind::ordered>(f, ord1, {0, 0}, d1);
+  auto lvl2 = mln::morpho::details::propagation_by_rank(f, ord2, {0, 0}, d2);
+
+  ASSERT_EQ(d1, d2);
+  ASSERT_EQ(lvl1, lvl2);
+  ASSERT_IMAGES_EQ_EXP(ord2, ord1);
+}
+
+template <class I>
+void check_node_map_original_size(I f)
+{
+  auto pstart          = f.domain().tl();
+  auto [t1, node_map1] = mln::morpho::tos(f, pstart);
+  auto [t2, node_map2] = mln::morpho::tos(f, pstart, mln::morpho::ToS_NodeMapOriginalSize);
+  ASSERT_EQ(f.domain(), node_map2.domain());
+
+  // The nodes of the twice-size tree that own an original pixel
+  std::vector<bool> kept(t1.parent.size(), false);
+  kept[0] = true;
+  mln_foreach (auto p, f.domain())
+    kept[node_map1(2 * p)] = true;
+  ASSERT_EQ(std::count(kept.begin(), kept.end(), true), static_cast<std::ptrdiff_t>(t2.parent.size()));
+
+  // Same partition of the pixels (one-to-one mapping of the node ids) and same levels
+  std::vector<int> to2(t1.parent.size(), -1), to1(t2.parent.size(), -1);
+  mln_foreach (auto p, f.domain())
+  {
+    int a = node_map1(2 * p), b = node_map2(p);
+    if (to2[a] < 0 && to1[b] < 0)
+      to2[a] = b, to1[b] = a;
+    ASSERT_EQ(b, to2[a]);
+    ASSERT_EQ(a, to1[b]);
+    ASSERT_EQ(t1.values[a], t2.values[b]);
+  }
+
+  // Same parent: the closest kept ancestor (the roots match even if they have no original pixel)
+  if (to1[0] < 0)
+    to1[0] = 0;
+  for (int b = 1; b < static_cast<int>(t2.parent.size()); ++b)
+  {
+    ASSERT_GE(to1[b], 0);
+    ASSERT_LT(t2.parent[b], b);
+    int x = t1.parent[to1[b]];
+    while (!kept[x])
+      x = t1.parent[x];
+    ASSERT_EQ(x, to1[t2.parent[b]]);
+  }
+}
+
+TEST(ToSConstruction, node_map_original_size)
+{
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 7);
+
+  mln::image2d<uint8_t> f(11, 9);
+  mln::generate(f, [&]() { return static_cast<uint8_t>(dist(gen)); });
+  check_node_map_original_size(f);
+
+  mln::image2d<uint8_t> g(mln::box2d{-5, 7, 31, 17});
+  mln::generate(g, [&]() { return static_cast<uint8_t>(dist(gen)); });
+  check_node_map_original_size(g);
+
+  mln::image3d<uint8_t> f3(9, 7, 5);
+  mln::generate(f3, [&]() { return static_cast<uint8_t>(dist(gen)); });
+  check_node_map_original_size(f3);
+}
+
+TEST(ToSConstruction, node_map_original_size_deeper_than_16_bits)
+{
+  // A ramp with more than 2¹⁶ depths: the union-find path of the tree construction
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 3);
+
+  mln::image2d<float> f(70000, 2);
+  mln_foreach (auto px, f.pixels())
+    px.val() = 0.5f * px.point().x() + dist(gen);
+  check_node_map_original_size(f);
+}
@@ -0,0 +1,89 @@
+import unittest
+import numpy as np
+
+import pylena
+
+
+class TestMorpho(unittest.TestCase):
+    def test_dilation_rect2d(self):
+        img = np.zeros((7, 9), dtype=np.uint8)
+        img[3, 4] = 255
+        res = pylena.morpho.dilation(img, pylena.se.rect2d(3, 5))
+        expected = np.zeros((7, 9), dtype=np.uint8)
+        expected[1:6, 3:6] = 255
+        self.assertTrue(res.dtype == np.uint8)
+        self.assertTrue(np.all(res == expected))
+
+    def test_parallel_matches_sequential(self):
+        rng = np.random.default_rng(42)
+        img = rng.integers(0, 256, size=(300, 400), dtype=np.uint8)
+        for se in (pylena.se.rect2d(19, 15), pylena.se.disc(9)):
+            res1 = pylena.morpho.dilation(img, se)
+            res2 = pylena.morpho.dilation(img, se, parallel=True)
+            self.assertTrue(np.all(res1 == res2))
+
+    def test_area_opening(self):
+        img = np.zeros((5, 5), dtype=np.uint8)
+        img[1, 1] = 10
+        img[3, 2:5] = 20
+        res = pylena.morpho.area_opening(img, 2)
+        self.assertTrue(res[1, 1] == 0)
+        self.assertTrue(np.all(res[3, 2:5] == 20))
+
+    def test_maxtree(self):
+        img = np.array([[0, 1, 1],
+                        [0, 2, 1],
+                        [0, 0, 0]], dtype=np.uint8)
+        tree = pylena.morpho.maxtree(img)
+        self.assertTrue(len(tree) == 3)
+        self.assertTrue(tree.parent.dtype == tree.node_map.dtype == np.int32)
+        self.assertTrue(tree.values.dtype == np.uint8)
+        self.assertTrue(tree.node_map.shape == img.shape)
+        self.assertTrue(np.all(tree.values[tree.node_map] == img))
+        self.assertFalse(tree.parent.flags.writeable)
+
+    def test_invalid_dtype(self):
+        img = np.zeros((4, 4), dtype=np.float64)
+        with self.assertRaises(ValueError):
+            pylena.morpho.maxtree(img)
+
+
+class TestComponentTree(unittest.TestCase):
+    def test_tree_attributes(self):
+        img = np.array([[0, 1, 1],
+                        [0, 2, 1],
+                        [0, 0, 0]], dtype=np.uint8)
+        tree = pylena.morpho.maxtree(img)
+        leaf = tree.node_map[1, 1]
+        node = tree.node_map[0, 1]
+        self.assertTrue(tree.area[0] == 9 and tree.area[node] == 4 and tree.area[leaf] == 1)
+        self.assertTrue(tree.depth[0] == 0 and tree.depth[leaf] == 2)
+        self.assertTrue(np.all(tree.bbox[node] == [1, 0, 3, 2]))
+        self.assertTrue(tree.mean[node] == 5 / 4)
+        self.assertTrue(tree.area is tree.area)
+
+    def test_tree_shares_data(self):
+        import gc
+        img = np.arange(20, dtype=np.uint8).reshape((4, 5))
+        tree = pylena.morpho.maxtree(img)
+        parent = tree.parent
+        values = tree.values
+        del tree
+        gc.collect()
+        self.assertTrue(parent[0] == -1)
+        self.assertTrue(np.all(np.sort(values) == np.arange(20)))
+
+    def test_tos_mean_original_size(self):
+        rng = np.random.default_rng(42)
+        img = rng.integers(0, 8, size=(13, 17), dtype=np.uint8)
+        tree = pylena.morpho.tos(img, twice_size=False)
+        self.assertTrue(tree.node_map.shape == img.shape)
+        self.assertFalse(np.any(np.isnan(tree.mean)))
+        # Sum and count of the pixels of each node, then of its subtree (parent[i] < i)
+        sums = np.bincount(tree.node_map.ravel(), weights=img.ravel(), minlength=len(tree))
+        count = np.bincount(tree.node_map.ravel(), minlength=len(tree)).astype(np.float64)
+        for i in range(len(tree) - 1, 0, -1):
+            sums[tree.parent[i]] += sums[i]
+            count[tree.parent[i]] += count[i]
+        self.assertTrue(np.all(count > 0))
+        self.assertTrue(np.allclose(tree.mean, sums / count))
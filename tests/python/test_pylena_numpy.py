@@ -39,9 +39,32 @@ class TestNumpyImage(unittest.TestCase):
                         [3, 4, 5],
                         [6, 7, 8],
                         [9, 10, 11]], order="F").astype(np.uint8)
-        with self.assertRaises(ValueError) as context:
-            pln.id(arr)
-        self.assertTrue("Array should be C contiguous" in str(context.exception))
+        res = pln.id(arr)
+        self.assertTrue(arr.shape == res.shape)
+        self.assertTrue(res.strides[0] == 3 and res.strides[1] == 1)
+        self.assertTrue(np.all(arr == res))
+
+    def test_from_numpy_strided_view(self):
+        base = np.arange(48).reshape((6, 8)).astype(np.int32)
+        arr = base[1:6:2, 2:7]
+        res = pln.id(arr)
+        self.assertTrue(arr.shape == res.shape)
+        self.assertTrue(arr.strides == res.strides)
+        self.assertTrue(arr.__array_interface__["data"][0] == res.__array_interface__["data"][0])
+        self.assertTrue(np.all(arr == res))
+
+    def test_from_numpy_reversed_and_column_step(self):
+        base = np.arange(48).reshape((6, 8)).astype(np.uint16)
+        for arr in (base[::-1], base[:, ::2], base[:, ::-1], base.T, base[2:3, 1:6]):
+            res = pln.id(arr)
+            self.assertTrue(arr.shape == res.shape)
+            self.assertTrue(np.all(arr == res))
+
+    def test_from_numpy_rgb8_fortran_order(self):
+        arr = np.asfortranarray(np.arange(36).reshape((3, 4, 3)).astype(np.uint8))
+        res = pln.id(arr)
+        self.assertTrue(arr.shape == res.shape)
+        self.assertTrue(np.all(arr == res))
 
     def test_from_numpy_checked(self):
         arr = np.arange(12).reshape((4, 3)).astype(np.int32)
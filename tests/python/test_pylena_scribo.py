@@ -0,0 +1,38 @@
+import unittest
+import numpy as np
+
+import pylena
+
+
+def page(rng, height=120, width=200):
+    img = np.full((height, width), 255, dtype=np.uint8)
+    for _ in range(3):
+        y, x = rng.integers(5, height - 10), rng.integers(0, width // 3)
+        img[y:y + 3, x:x + width // 2] = 0
+    for _ in range(2):
+        x, y = rng.integers(5, width - 10), rng.integers(0, height // 3)
+        img[y:y + height // 2, x:x + 2] = 0
+    return img
+
+
+class TestSegdet(unittest.TestCase):
+    def test_detect_line_batch(self):
+        rng = np.random.default_rng(42)
+        imgs = [page(rng) for _ in range(5)]
+        for nthreads in (0, 2):
+            res = pylena.scribo.detect_line_batch(imgs, 20, nthreads=nthreads)
+            self.assertTrue(len(res) == len(imgs))
+            for img, segments in zip(imgs, res):
+                self.assertTrue(segments.shape[1] == 4 and segments.shape[0] > 0)
+                self.assertTrue(np.all(segments == pylena.scribo.detect_line(img, 20, "vector")))
+
+    def test_detect_line_batch_params(self):
+        imgs = [page(np.random.default_rng(0))]
+        res = pylena.scribo.detect_line_batch(imgs, 20, {"max_thickness": 10, "remove_duplicates": 0})
+        self.assertTrue(np.all(res[0] == pylena.scribo.detect_line(imgs[0], 20, "vector",
+                                                                    {"max_thickness": 10, "remove_duplicates": 0})))
+        with self.assertRaises(ValueError):
+            pylena.scribo.detect_line_batch(imgs, 20, {"unknown_parameter": 1})
+        with self.assertRaises(ValueError):
+            pylena.scribo.detect_line_batch([np.zeros((10, 10), dtype=np.float32)], 20)
+
@@ -2,6 +2,8 @@
 
 #include "../../pylene/src/scribo/segdet/process/bucket.hpp"
 
+#include <vector>
+
 TEST(Segdet, size_1)
 {
     int n_max = 1;
@@ -44,4 +46,34 @@ TEST(Segdet, size_120)
     EXPECT_EQ(buckets.get_bucket_number(119), 3);
     EXPECT_EQ(buckets.get_bucket_number(120), 3);
     EXPECT_EQ(buckets.get_bucket_number(121), 3);
-}
\ No newline at end of file
+}
+TEST(Segdet, buckets_acquire_remove_release)
+{
+    scribo::SegDetParams params;
+    scribo::internal::Descriptor descriptor(params, 10);
+    scribo::internal::Buckets buckets(120, 30);
+    std::vector<scribo::internal::Tracker> trackers;
+
+    // Positions 100, 10, 40, 15, 45
+    for (float n : {100.f, 10.f, 40.f, 15.f, 45.f})
+        trackers.emplace_back(0, Eigen::Matrix<float, 3, 1>(n, 1.f, 0.f), descriptor);
+
+    buckets.acquire(trackers);
+    EXPECT_TRUE(trackers.empty());
+
+    std::vector<int> seen;
+    buckets.for_each_tracker(0, [&](auto& f) { seen.push_back(f.get_position()); });
+    EXPECT_EQ(seen, std::vector<int>({10, 15}));
+
+    // Remove 10 from the bucket 0 and put it back: it goes to the end of its bucket
+    std::vector<scribo::internal::Tracker> out;
+    buckets.remove_if(0, [](const auto& f) { return f.get_position() == 10; }, out);
+    ASSERT_EQ(out.size(), 1);
+    buckets.insert(std::move(out[0]));
+
+    buckets.release(trackers);
+    std::vector<int> positions;
+    for (auto& f : trackers)
+        positions.push_back(f.get_position());
+    EXPECT_EQ(positions, std::vector<int>({15, 10, 40, 45, 100}));
+}
@@ -4,6 +4,11 @@
 
 #include "../../pylene/src/scribo/segdet/process/extractors/extract_observation.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
 namespace
 {
   static constexpr std::uint8_t WHITE      = 255;
@@ -235,3 +240,131 @@ TEST(Segdet, gradient_smallest)
 
   test_extract_observations(ref, image, params);
 }
+
+namespace
+{
+  // Scalar reference of the observation extraction (one pixel at a time, read from the image)
+  Eigen::Matrix<float, 3, 1> ref_observation_binary(const mln::image2d<uint8_t>& image, int& n, int t, int n_max,
+                                                    const scribo::internal::Descriptor& descriptor)
+  {
+    std::vector<int> lumis;
+    int              mlumi = 255;
+    int              sum   = 0;
+    while (n + static_cast<int>(lumis.size()) < n_max)
+    {
+      int l = image({t, n + static_cast<int>(lumis.size())});
+      if (l > descriptor.blumi)
+        break;
+      mlumi = std::min(mlumi, l);
+      sum += l;
+      lumis.push_back(l);
+    }
+
+    float slumi = mlumi + (descriptor.blumi - mlumi) * descriptor.ratio_lum;
+    int   ni    = 0;
+    while (lumis[ni] > slumi)
+      sum -= lumis[ni++];
+    int nf = static_cast<int>(lumis.size());
+    while (lumis[--nf] > slumi)
+      sum -= lumis[nf];
+
+    float thickness = nf - ni + 1.0f;
+    auto  obs       = Eigen::Matrix<float, 3, 1>((2 * n + nf + ni) / 2.0f, thickness, sum / thickness);
+    n += static_cast<int>(lumis.size());
+    return obs;
+  }
+
+  Eigen::Matrix<float, 3, 1> ref_observation_gradient(const mln::image2d<uint8_t>& image, int& n, int t, int n_max,
+                                                      const scribo::internal::Descriptor& descriptor)
+  {
+    int sign = static_cast<int>(image({t, n + 1})) - static_cast<int>(image({t, n - 1})) < 0 ? -1 : 1;
+
+    int k = 1;
+    while (n + k + 1 < n_max &&
+           (static_cast<int>(image({t, n + k + 1})) - static_cast<int>(image({t, n + k - 1}))) * sign >=
+               descriptor.gradient_threshold)
+      k++;
+
+    int  grad = static_cast<int>(image({t, n + k})) - static_cast<int>(image({t, n - 1}));
+    auto obs  = Eigen::Matrix<float, 3, 1>((2 * n - 1 + k) / 2.0f, static_cast<float>(k), static_cast<float>(grad));
+    n += k;
+    return obs;
+  }
+
+  std::vector<Eigen::Matrix<float, 3, 1>> ref_extract_observations(const mln::image2d<uint8_t>& image, int t,
+                                                                   const scribo::internal::Descriptor& descriptor)
+  {
+    const int                               n_max = image.height();
+    std::vector<Eigen::Matrix<float, 3, 1>> observations;
+    if (descriptor.extraction_type == scribo::e_segdet_process_extraction::BINARY)
+    {
+      for (int n = 0; n < n_max; n++)
+        if (image({t, n}) < descriptor.llumi)
+          observations.push_back(ref_observation_binary(image, n, t, n_max, descriptor));
+    }
+    else
+    {
+      for (int n = 1; n < n_max - 1; n++)
+        if (std::abs(static_cast<int>(image({t, n - 1})) - static_cast<int>(image({t, n + 1}))) >
+            descriptor.gradient_threshold)
+          observations.push_back(ref_observation_gradient(image, n, t, n_max, descriptor));
+    }
+    return observations;
+  }
+} // namespace
+
+TEST(Segdet, extractor_columns)
+{
+  using namespace scribo;
+  using namespace scribo::internal;
+
+  // 70 columns (more than a transposed block) of 1000 pixels (many simd batches). The dark runs and the ramps have
+  // random lengths and positions so that they cross the batch boundaries; some columns start or end in a run.
+  constexpr int width = 70, height = 1000;
+
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> noise(0, 19);
+  std::uniform_int_distribution<int> length(1, 150);
+  std::uniform_int_distribution<int> gap(0, 120);
+
+  mln::image2d<std::uint8_t> image(width, height);
+  for (int t = 0; t < width; t++)
+  {
+    for (int n = 0; n < height; n++)
+      image({t, n}) = static_cast<std::uint8_t>(WHITE - noise(gen));
+
+    for (int n = (t % 3 == 0) ? 0 : gap(gen); n < height;)
+    {
+      const int l = std::min(length(gen), height - n);
+      for (int i = 0; i < l; i++)
+      {
+        const int d = std::min(i, l - 1 - i); // Distance to the ends of the run: grey borders, dark core
+        image({t, n + i}) = static_cast<std::uint8_t>(d < 2 ? GREY_WHITE - 20 * d : BLACK + noise(gen));
+      }
+      n += l + gap(gen);
+    }
+    if (t % 5 == 0)
+      for (int n = height - 40; n < height; n++)
+        image({t, n}) = static_cast<std::uint8_t>(BLACK + noise(gen));
+  }
+
+  for (auto extraction : {e_segdet_process_extraction::BINARY, e_segdet_process_extraction::GRADIENT})
+  {
+    auto params            = SegDetParams();
+    params.extraction_type = extraction;
+    params.ratio_lum       = 0.5f; // The grey borders of the runs are trimmed
+    auto descriptor        = Descriptor(params, 0);
+
+    ObservationExtractor                    extractor(image, descriptor);
+    std::vector<Eigen::Matrix<float, 3, 1>> output;
+    for (int t = 0; t < width; t++)
+    {
+      auto ref = ref_extract_observations(image, t, descriptor);
+      ASSERT_FALSE(ref.empty());
+
+      ASSERT_EQ(extract_observations(image, t, height, descriptor), ref);
+      extractor.extract(t, output);
+      ASSERT_EQ(output, ref);
+    }
+  }
+}
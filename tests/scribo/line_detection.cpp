@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <mln/core/algorithm/transform.hpp>
 #include <mln/core/image/ndimage.hpp>
 #include <mln/io/imread.hpp>
 #include <mln/io/imsave.hpp>
@@ -668,4 +669,76 @@ TEST(Segdet, two_observations_limit)
   auto [out, supperpositon] = detect_line_label(img, min_len, params);
 
   check_pixel_horizontal_output(ref, out);
-}
\ No newline at end of file
+}
+std::vector<VSegment> detect_line_streaming(const mln::image2d<std::uint8_t>& img, int band_height,
+                                            const SegDetParams& params, int overlap)
+{
+  scribo::StreamingLineDetector detector(img.width(), 10, params, overlap);
+  std::vector<VSegment>         output;
+  for (int y0 = 0; y0 < img.height(); y0 += band_height)
+  {
+    int                        h = std::min(band_height, img.height() - y0);
+    mln::image2d<std::uint8_t> band(img.width(), h);
+    for (int y = 0; y < h; y++)
+      for (int x = 0; x < img.width(); x++)
+        band({x, y}) = img({x, y0 + y});
+
+    auto segs = detector.push(band);
+    output.insert(output.end(), segs.begin(), segs.end());
+  }
+  auto segs = detector.finish();
+  output.insert(output.end(), segs.begin(), segs.end());
+  return output;
+}
+
+TEST(Segdet, line_detect_streaming_bands_vector)
+{
+  auto                          pair = generate_test_image_vector(100, 100, 2, 2, 5);
+  mln::image2d<std::uint8_t>    img  = pair.first;
+  std::vector<scribo::VSegment> ref  = pair.second;
+
+  int overlap   = 40;
+  int abs_error = 1;
+
+  // From one row per band to the whole image in a single band
+  auto whole = detect_line_streaming(img, 5000, SegDetParams(), overlap);
+  check_vector_output(ref, whole, abs_error);
+  for (int band_height : {1, 2, 3, 5, 16, 19, 64, 99, 100})
+  {
+    auto output = detect_line_streaming(img, band_height, SegDetParams(), overlap);
+    check_vector_output(ref, output, abs_error);
+    check_vector_output(whole, output, abs_error);
+  }
+
+  // The negation is applied on the pushed rows
+  auto negated        = mln::transform(img, [](std::uint8_t v) -> std::uint8_t { return 255 - v; });
+  auto params         = SegDetParams();
+  params.negate_image = true;
+  for (int band_height : {1, 7, 5000})
+    check_vector_output(ref, detect_line_streaming(negated, band_height, params, overlap), abs_error);
+}
+
+TEST(Segdet, line_detect_streaming_black_top_hat)
+{
+  // The reconstruction of the black top hat spans the whole image: it cannot be computed band by band
+  auto params       = SegDetParams();
+  params.preprocess = e_segdet_preprocess::BLACK_TOP_HAT;
+  EXPECT_THROW(scribo::StreamingLineDetector(100, 10, params), std::runtime_error);
+}
+
+TEST(Segdet, line_detect_batch_vector)
+{
+  std::vector<mln::image2d<std::uint8_t>> images;
+  images.push_back(generate_test_image_vector(100, 100, 2, 2, 5).first);
+  images.push_back(generate_test_image_vector(100, 100, 1, 0, 5, 0, 0, -10).first);
+  images.push_back(generate_test_image_vector(100, 100, 2, 2, 5, 10, 5, 5).first);
+
+  for (int nthreads : {0, 2})
+  {
+    auto output = detect_line_batch(images, 10, SegDetParams(), nthreads);
+
+    ASSERT_EQ(output.size(), images.size());
+    for (std::size_t i = 0; i < images.size(); i++)
+      check_vector_output(detect_line_vector(images[i], 10), output[i], 1);
+  }
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/range/foreach.hpp>
+
+#include "../../pylene/src/scribo/segdet/detect_line.hpp"
+#include "../../pylene/src/scribo/segdet/segment_to_X.hpp"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+  using scribo::internal::Descriptor;
+  using scribo::internal::Segment;
+
+  // A segment made of the given spans. Its length is used as an identifier to check which segments are kept.
+  Segment make_segment(bool is_horizontal, std::vector<scribo::internal::Span> spans, int id,
+                       const Descriptor& descriptor)
+  {
+    Segment s(scribo::internal::Tracker(0, Eigen::Matrix<float, 3, 1>(0, 1, 0), descriptor), 0);
+    s.is_horizontal = is_horizontal;
+    s.spans         = std::move(spans);
+    s.under_other_object.clear();
+    s.first_span = s.spans.front();
+    s.last_span  = s.spans.back();
+    s.length     = id;
+    s.nb_pixels  = 0;
+    for (const auto& span : s.spans)
+      s.nb_pixels += span.thickness;
+    return s;
+  }
+
+  // The duplicate removal with the intersection of the label images of the segments
+  void ref_remove_dup(const std::vector<Segment>& segments_to_compare, std::vector<Segment>& segments_removable,
+                      int width, int height, const Descriptor& descriptor)
+  {
+    using scribo::internal::first_label;
+
+    auto first_output  = std::get<0>(scribo::internal::segment_to_label(segments_to_compare, {}, width, height, false));
+    auto second_output = std::get<0>(scribo::internal::segment_to_label(segments_removable, {}, width, height, false));
+
+    std::vector<int> segments(segments_removable.size(), 0);
+    mln_foreach (auto p, first_output.domain())
+    {
+      int v = first_output(p) != 0 ? second_output(p) : 0;
+      if (v >= first_label)
+        segments[v - first_label]++;
+    }
+
+    int i = 0;
+    std::erase_if(segments_removable, [&](const Segment& s) {
+      const int intersection = segments[i++];
+      return s.nb_pixels == 0 || intersection / static_cast<float>(s.nb_pixels) > descriptor.threshold_intersection;
+    });
+  }
+
+  std::vector<int> ids(const std::vector<Segment>& segments)
+  {
+    std::vector<int> res;
+    for (const auto& s : segments)
+      res.push_back(s.length);
+    return res;
+  }
+
+  // Random segments whose spans overlap the spans of other segments, overlap each other and cross the image border
+  std::pair<std::vector<Segment>, std::vector<Segment>> random_segments(std::mt19937& gen, int width, int height,
+                                                                        const Descriptor& descriptor)
+  {
+    std::uniform_int_distribution<int>     nb_segments(1, 12);
+    std::uniform_int_distribution<int>     length(1, 25);
+    std::uniform_int_distribution<int>     thickness(1, 7);
+    std::uniform_real_distribution<float>  slope(-0.3f, 0.3f);
+    std::uniform_real_distribution<float>  jitter(-1.5f, 1.5f);
+    std::bernoulli_distribution            coin(0.3);
+
+    std::pair<std::vector<Segment>, std::vector<Segment>> res;
+    int                                                   id = 0;
+    for (bool is_horizontal : {true, false})
+    {
+      // t is the coordinate along the segment (x for a horizontal segment), n the one across it
+      const int t_size = is_horizontal ? width : height;
+      const int n_size = is_horizontal ? height : width;
+      auto&     out    = is_horizontal ? res.first : res.second;
+
+      std::uniform_int_distribution<int>    t_start(0, t_size - 1);
+      std::uniform_real_distribution<float> n_start(-4.f, static_cast<float>(n_size) + 3.f);
+
+      for (int k = nb_segments(gen); k > 0; k--)
+      {
+        std::vector<scribo::internal::Span> spans;
+        if (!out.empty() && coin(gen))
+        {
+          // Near copy of a segment of the same direction
+          spans = out[std::uniform_int_distribution<int>(0, static_cast<int>(out.size()) - 1)(gen)].spans;
+          for (auto& span : spans)
+          {
+            (is_horizontal ? span.y : span.x) += jitter(gen);
+            span.thickness = thickness(gen);
+          }
+        }
+        else
+        {
+          const int   t0 = t_start(gen);
+          const int   t1 = std::min(t0 + length(gen), t_size - 1);
+          const float n0 = n_start(gen);
+          const float a  = slope(gen);
+          for (int t = t0; t <= t1; t++)
+          {
+            const float n = n0 + a * static_cast<float>(t - t0);
+            const int   w = thickness(gen);
+            spans.push_back(is_horizontal ? scribo::internal::Span{static_cast<float>(t), n, w}
+                                          : scribo::internal::Span{n, static_cast<float>(t), w});
+
+            // A span of the same segment on the same line that overlaps the previous one
+            if (coin(gen))
+            {
+              auto span = spans.back();
+              (is_horizontal ? span.y : span.x) += jitter(gen);
+              span.thickness = thickness(gen);
+              spans.push_back(span);
+            }
+          }
+        }
+        out.push_back(make_segment(is_horizontal, std::move(spans), id++, descriptor));
+      }
+    }
+
+    // Segments of the other direction lying on the segments (removed with a low threshold)
+    std::vector<Segment> covering;
+    for (const auto* in : {&res.first, &res.second})
+      for (const auto& s : *in)
+      {
+        if (!coin(gen))
+          continue;
+        std::vector<scribo::internal::Span> spans;
+        for (const auto& span : s.spans)
+          spans.push_back({span.x, span.y, static_cast<int>(span.thickness) + 2});
+        covering.push_back(make_segment(!s.is_horizontal, std::move(spans), id++, descriptor));
+      }
+    for (auto& s : covering)
+    {
+      // The spans of a segment are on its own lines: keep those inside the image
+      auto& spans  = s.spans;
+      auto  inside = [&](const scribo::internal::Span& span) {
+        const float t = s.is_horizontal ? span.x : span.y;
+        return 0.f <= t && t < static_cast<float>(s.is_horizontal ? width : height);
+      };
+      std::erase_if(spans, [&](const auto& span) { return !inside(span); });
+      if (spans.empty())
+        continue;
+      s.first_span = spans.front();
+      s.last_span  = spans.back();
+      (s.is_horizontal ? res.first : res.second).push_back(std::move(s));
+    }
+    return res;
+  }
+} // namespace
+
+TEST(Segdet, remove_duplicates_same_as_label_intersection)
+{
+  constexpr int width  = 61;
+  constexpr int height = 47;
+
+  std::mt19937 gen(42);
+  int          nb_kept    = 0;
+  int          nb_removed = 0;
+  for (float threshold : {0.f, 0.3f, 0.8f})
+  {
+    scribo::SegDetParams params;
+    params.threshold_intersection = threshold;
+    const auto descriptor         = Descriptor(params, 0);
+
+    for (int k = 0; k < 200; k++)
+    {
+      auto segments = random_segments(gen, width, height, descriptor);
+      auto ref      = segments;
+
+      ref_remove_dup(ref.first, ref.second, width, height, descriptor);
+      ref_remove_dup(ref.second, ref.first, width, height, descriptor);
+      std::vector<int> expected = ids(ref.first);
+      for (int id : ids(ref.second))
+        expected.push_back(id);
+
+      const int n   = static_cast<int>(segments.first.size() + segments.second.size());
+      auto [res, _] = scribo::internal::post_process(segments, width, height, descriptor);
+      ASSERT_EQ(ids(res), expected) << "threshold=" << threshold << " k=" << k;
+
+      nb_kept += static_cast<int>(res.size());
+      nb_removed += n - static_cast<int>(res.size());
+    }
+  }
+
+  // Both outcomes are exercised
+  EXPECT_GT(nb_kept, 0);
+  EXPECT_GT(nb_removed, 0);
+}
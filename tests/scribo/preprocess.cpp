@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <mln/core/algorithm/fill.hpp>
+#include <mln/core/algorithm/generate.hpp>
+#include <mln/core/algorithm/transform.hpp>
+#include <mln/core/image/ndimage.hpp>
+#include <mln/core/neighborhood/c4.hpp>
+#include <mln/core/range/foreach.hpp>
+#include <mln/core/se/rect2d.hpp>
+#include <mln/morpho/dilation.hpp>
+#include <mln/morpho/reconstruction.hpp>
+
+#include <fixtures/ImageCompare/image_compare.hpp>
+
+#include "../../pylene/src/scribo/segdet/detect_line.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+  // The black top hat computed with the generic transforms and the union-find reconstruction
+  mln::image2d<std::uint8_t> ref_black_top_hat(mln::image2d<std::uint8_t>         input,
+                                               const scribo::internal::Descriptor& descriptor)
+  {
+    if (descriptor.negate_image)
+      input = mln::transform(input, [](std::uint8_t p) -> std::uint8_t { return 255 - p; });
+
+    auto neg   = mln::transform(input, [](std::uint8_t p) -> std::uint8_t { return 255 - p; });
+    auto seeds = mln::transform(neg, [&descriptor](std::uint8_t p) -> std::uint8_t {
+      return std::max(static_cast<int>(p - static_cast<int>(descriptor.dyn * 255)), 0);
+    });
+
+    auto connectivity_mask = mln::morpho::dilation(neg, mln::se::rect2d{descriptor.size_mask, descriptor.size_mask});
+
+    auto out = mln::morpho::opening_by_reconstruction(connectivity_mask, seeds, mln::c4);
+    out      = mln::transform(neg, out, [](std::uint8_t a, std::uint8_t b) -> std::uint8_t { return std::min(a, b); });
+    mln::transform(neg, out, out, [](std::uint8_t a, std::uint8_t b) -> std::uint8_t { return 255 - (a - b); });
+    return out;
+  }
+
+  void check_black_top_hat(const mln::image2d<std::uint8_t>& input, float dyn, int size_mask)
+  {
+    for (bool negate : {false, true})
+    {
+      scribo::SegDetParams params;
+      params.preprocess   = scribo::e_segdet_preprocess::BLACK_TOP_HAT;
+      params.negate_image = negate;
+      params.dyn          = dyn;
+      params.size_mask    = size_mask;
+
+      const auto descriptor = scribo::internal::Descriptor(params, 0);
+      auto       out        = scribo::internal::preprocess(input, descriptor);
+      ASSERT_IMAGES_EQ_EXP(out, ref_black_top_hat(input, descriptor));
+    }
+  }
+
+  // Dark lines on a bright background with noise
+  mln::image2d<std::uint8_t> make_document(int width, int height, std::mt19937& gen)
+  {
+    std::uniform_int_distribution<int> noise(0, 40);
+    std::uniform_int_distribution<int> coin(0, 30);
+
+    mln::image2d<std::uint8_t> image(width, height);
+    mln_foreach (auto px, image.pixels())
+    {
+      auto p   = px.point();
+      bool ink = (p.y() % 17 < 2) || (p.x() % 29 == 0) || coin(gen) == 0;
+      px.val() = static_cast<std::uint8_t>(ink ? noise(gen) : 255 - noise(gen));
+    }
+    return image;
+  }
+} // namespace
+
+
+TEST(Segdet, black_top_hat_same_as_reconstruction)
+{
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(0, 255);
+
+  // Uniform noise
+  for (auto [w, h] : {std::pair{1, 1}, std::pair{1, 37}, std::pair{53, 1}, std::pair{97, 61}})
+  {
+    mln::image2d<std::uint8_t> image(w, h);
+    mln::generate(image, [&]() { return static_cast<std::uint8_t>(dist(gen)); });
+    check_black_top_hat(image, 0.6f, 11);
+    check_black_top_hat(image, 0.2f, 3);
+  }
+
+  // Documents
+  auto image = make_document(211, 157, gen);
+  check_black_top_hat(image, 0.6f, 11);
+  check_black_top_hat(image, 0.3f, 5);
+  check_black_top_hat(image, 0.9f, 1);
+}
+
+TEST(Segdet, black_top_hat_markers_below_mask)
+{
+  // The maximum of the seeds is below the minimum of the connectivity mask: the reconstruction is flat
+  std::mt19937                       gen(42);
+  std::uniform_int_distribution<int> dist(90, 110);
+
+  mln::image2d<std::uint8_t> image(83, 47);
+  mln::generate(image, [&]() { return static_cast<std::uint8_t>(dist(gen)); });
+  check_black_top_hat(image, 0.6f, 11);
+
+  mln::image2d<std::uint8_t> flat(31, 19);
+  mln::fill(flat, std::uint8_t(100));
+  check_black_top_hat(flat, 0.6f, 5);
+}
@@ -1,12 +1,25 @@
 #include <gtest/gtest.h>
 
 #include <mln/core/algorithm/fill.hpp>
+#include <mln/core/algorithm/generate.hpp>
 #include <mln/core/image/ndimage.hpp>
+#include <mln/core/range/foreach.hpp>
+#include <mln/core/se/rect2d.hpp>
+#include <mln/filters/nms.hpp>
+#include <mln/morpho/dilation.hpp>
 #include <mln/transforms/hough_lines.hpp>
 
+#include <fixtures/ImageCompare/image_compare.hpp>
+
+#include <tbb/global_control.h>
+
 #include <algorithm>
 #include <cmath>
 #include <numbers>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
 
 TEST(HoughLines, detect_peaks)
 {
@@ -104,3 +117,193 @@ TEST(HoughLines, detect_peaks_p90)
   EXPECT_NEAR(peaks[0].count, expected, 0.01f * expected);
 }
 
+
+TEST(HoughLines, batched_take_same_as_take)
+{
+  float angles[] = {-1.5f, -1.f, -0.7f, -0.3f, 0.f, 0.2f, 0.5f, 0.9f, 1.2f, 1.4f, 1.57f};
+
+  std::vector<mln::point2d> points  = {{0, 0}, {3, 7}, {12, 5}, {49, 49}, {25, 3}};
+  std::vector<float>        weights = {1.f, 0.5f, 2.f, 3.f, 0.25f};
+
+  mln::transforms::HoughLineAccumulator a(angles, 70.f, false);
+  mln::transforms::HoughLineAccumulator b(angles, 70.f, false);
+  mln::transforms::HoughLineAccumulator wa(angles, 70.f, true);
+  mln::transforms::HoughLineAccumulator wb(angles, 70.f, true);
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    a.take(points[i]);
+    wa.take(points[i], weights[i]);
+  }
+  b.take(points);
+  wb.take(points, weights);
+
+  ASSERT_IMAGES_EQ_EXP(a.get_accumulator_image(), b.get_accumulator_image());
+  ASSERT_IMAGES_EQ_EXP(wa.get_waccumulator_image(), wb.get_waccumulator_image());
+}
+
+TEST(HoughLines, parallel_same_as_sequential)
+{
+  int                 n = 300;
+  mln::image2d<bool>  in(n, n, mln::image_build_params{.init_value = false});
+  mln::image2d<float> win(n, n, mln::image_build_params{.init_value = 0.f});
+  for (int i = 0; i < n; ++i)
+  {
+    in({i, i})           = true;
+    in({i, (7 * i) % n}) = true;
+    win({i, n - i - 1})  = 0.5f;
+  }
+
+  std::vector<float> angles(180);
+  for (int i = 0; i < 180; ++i)
+    angles[i] = (i - 90) * std::numbers::pi_v<float> / 180;
+
+  auto ref   = mln::transforms::hough_lines(in, angles);
+  auto res   = mln::transforms::parallel::hough_lines(in, angles);
+  auto res16 = mln::transforms::parallel::hough_lines(in, angles, nullptr, true);
+  ASSERT_IMAGES_EQ_EXP(res, ref);
+  ASSERT_IMAGES_EQ_EXP(res16, ref);
+
+  auto wref = mln::transforms::hough_lines(win, angles);
+  auto wres = mln::transforms::parallel::hough_lines(win, angles);
+  ASSERT_IMAGES_EQ_EXP(wres, wref);
+}
+
+// A cell receives more than 65535 votes: the 16-bit private accumulators must be flushed before they overflow
+TEST(HoughLines, parallel_16bit_accumulators_do_not_overflow)
+{
+  constexpr int      n = 70000;
+  mln::image2d<bool> in(n, 2, mln::image_build_params{.init_value = false});
+  for (int x = 0; x < n; ++x)
+    in({x, 1}) = true;
+
+  constexpr float    pi     = std::numbers::pi_v<float>;
+  std::vector<float> angles = {-pi / 2, -pi / 4, 0, pi / 4, pi / 2};
+
+  auto ref  = mln::transforms::hough_lines(in, angles);
+  int  vmax = 0;
+  mln_foreach (int v, ref.values())
+    vmax = std::max(vmax, v);
+  ASSERT_GT(vmax, 65535);
+
+  // With a single thread, one private accumulator receives all the votes
+  for (int nthreads : {1, static_cast<int>(std::thread::hardware_concurrency())})
+  {
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, std::max(nthreads, 1));
+    auto                res   = mln::transforms::parallel::hough_lines(in, angles);
+    auto                res16 = mln::transforms::parallel::hough_lines(in, angles, nullptr, true);
+    ASSERT_IMAGES_EQ_EXP(res, ref);
+    ASSERT_IMAGES_EQ_EXP(res16, ref);
+  }
+}
+
+TEST(HoughLines, nms_parallel_same_as_sequential)
+{
+  int                n = 400;
+  mln::image2d<bool> in(n, n, mln::image_build_params{.init_value = false});
+  for (int i = 0; i < n; ++i)
+  {
+    in({i, i})               = true;
+    in({i, (3 * i) % n})     = true;
+    in({(5 * i) % n, i})     = true;
+    in({i, n - 1 - (i / 2)}) = true;
+  }
+
+  std::vector<float> angles(180);
+  for (int i = 0; i < 180; ++i)
+    angles[i] = (i - 90) * std::numbers::pi_v<float> / 180;
+
+  auto acc = mln::transforms::hough_lines(in, angles);
+  for (int k : {-1, 1, 10, 50})
+  {
+    auto ref = mln::filters::nms(acc, 5, 5, 20, k);
+    auto res = mln::filters::parallel::nms(acc, 5, 5, 20, k);
+    ASSERT_EQ(ref, res);
+    if (k > 0)
+      ASSERT_LE(ref.size(), static_cast<std::size_t>(k));
+    for (std::size_t i = 1; i < ref.size(); ++i)
+      ASSERT_GE(acc(ref[i - 1]), acc(ref[i]));
+  }
+}
+
+namespace
+{
+  // Reference NMS (the previous implementation): the peaks are the pixels equal to their dilation by the NMS window,
+  // ordered by decreasing value, then by raster order
+  template <class T>
+  std::vector<mln::point2d> nms_by_dilation(const mln::image2d<T>& input, int w, int h, std::optional<T> min_intensity,
+                                            int num_peaks)
+  {
+    auto dil = mln::morpho::dilation(input, mln::se::rect2d{w, h});
+
+    T minv;
+    if (min_intensity)
+      minv = *min_intensity;
+    else
+    {
+      T m = input(input.domain().tl());
+      mln_foreach (auto v, input.values())
+        m = std::max(m, v);
+      minv = 0.5f * m;
+    }
+
+    std::vector<mln::point2d> peaks;
+    mln_foreach (auto p, input.domain())
+      if (input(p) == dil(p) && input(p) >= minv)
+        peaks.push_back(p);
+
+    std::stable_sort(peaks.begin(), peaks.end(), [&](auto p, auto q) { return input(p) > input(q); });
+    if (num_peaks > 0 && peaks.size() > static_cast<std::size_t>(num_peaks))
+      peaks.resize(num_peaks);
+    return peaks;
+  }
+
+  template <class T>
+  void check_nms_against_dilation(const mln::image2d<T>& acc, std::optional<T> min_intensity)
+  {
+    for (auto [w, h] : {std::pair{5, 5}, std::pair{3, 7}, std::pair{1, 1}, std::pair{4, 2}})
+      for (int k : {-1, 1, 7, 50})
+      {
+        auto ref = nms_by_dilation(acc, w, h, min_intensity, k);
+        auto res = mln::filters::nms(acc, w, h, min_intensity, k);
+        auto par = mln::filters::parallel::nms(acc, w, h, min_intensity, k);
+        ASSERT_EQ(ref, res) << "window " << w << "x" << h << ", k = " << k;
+        ASSERT_EQ(ref, par) << "window " << w << "x" << h << ", k = " << k;
+      }
+  }
+} // namespace
+
+// The block-max NMS must give the peaks of the dilation-based NMS
+TEST(HoughLines, nms_same_as_dilation)
+{
+  std::mt19937 gen(42);
+
+  // Few levels: many plateaus, whose pixels are all peaks
+  {
+    std::uniform_int_distribution<int> dist(0, 9);
+    mln::image2d<int>                  acc(mln::box2d{-7, 5, 157, 93});
+    mln::generate(acc, [&]() { return dist(gen); });
+
+    // Peaks on the borders and corners of the domain
+    const auto dom = acc.domain();
+    acc(dom.tl())                                     = 12;
+    acc({dom.br().x() - 1, dom.br().y() - 1})         = 12;
+    acc({dom.tl().x(), dom.tl().y() + 40})            = 11;
+    acc({dom.br().x() - 1, dom.tl().y() + 17})        = 11;
+    acc({dom.tl().x() + 60, dom.br().y() - 1})        = 10;
+
+    check_nms_against_dilation<int>(acc, std::nullopt);
+    check_nms_against_dilation<int>(acc, 3);
+  }
+
+  // Hough-like accumulator: a sparse float image
+  {
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    mln::image2d<float>                   acc(181, 130);
+    mln::generate(acc, [&]() {
+      float v = dist(gen);
+      return v < 0.9f ? 0.f : v;
+    });
+    check_nms_against_dilation<float>(acc, std::nullopt);
+    check_nms_against_dilation<float>(acc, 0.f);
+  }
+}